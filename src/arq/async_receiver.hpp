@@ -0,0 +1,232 @@
+#ifndef _ARQ_ASYNC_RECEIVER_HPP_
+#define _ARQ_ASYNC_RECEIVER_HPP_
+
+#include <memory>
+
+#include "arq/common/arq_common.hpp"
+#include "arq/common/control_packet.hpp"
+#include "arq/common/conversation_id.hpp"
+#include "arq/common/latency_stats.hpp"
+#include "arq/common/output_buffer.hpp"
+#include "arq/common/protocol_metrics.hpp"
+#include "arq/receiver.hpp"
+#include "util/executor.hpp"
+#include "util/logging.hpp"
+#include "util/trace.hpp"
+
+namespace arq {
+
+/*
+ * A Receiver whose resequencing and ACK threads are replaced by a single coroutine run on an executor, so that many
+ * conversations can share a single thread. The receive function must not block: the coroutine waits for the given
+ * file descriptor to become readable, then reads until the receive function fails, sending each ACK as soon as the RS
+ * buffer produces it.
+ *
+ * The receiver must outlive the executor's run() call.
+ */
+template <RSBuffer RSBufferType>
+class AsyncReceiver {
+public:
+    AsyncReceiver(ConversationID id,
+                  util::Executor& executor,
+                  TransmitFn txFn,
+                  ReceiveFn rxFn,
+                  int rxFd,
+                  std::unique_ptr<RSBufferType>&& rsBuffer_p,
+                  std::shared_ptr<LatencyStats> latencyStats = nullptr,
+                  size_t outputBufferCapacity = DEFAULT_OUTPUT_BUFFER_CAPACITY) :
+        id_{id},
+        executor_{executor},
+        txFn_{txFn},
+        rxFn_{rxFn},
+        rxFd_{rxFd},
+        outputBuffer_{outputBufferCapacity},
+        resequencingBuffer_{std::move(rsBuffer_p)},
+        latencyStats_{std::move(latencyStats)},
+        metrics_{id}
+    {
+        executor_.spawn(resequencingTask());
+    }
+
+    AsyncReceiver(const AsyncReceiver&) = delete;
+    AsyncReceiver& operator=(const AsyncReceiver&) = delete;
+
+    // If a packet is available, get the next packet from the output buffer.
+    std::optional<ReceiveBufferObject> tryGetPacket()
+    {
+        auto packet = outputBuffer_.tryGetPacket();
+        if (packet.has_value()) {
+            metrics_.outputBufferDepth_.add(-1);
+        }
+        return packet;
+    }
+
+    // Has the ACK for an EoT packet been sent?
+    bool finished() const noexcept { return ackedEndOfTx_; }
+
+private:
+    std::optional<DataPacket> receivePacket() const
+    {
+        std::array<std::byte, MAX_SUPPORTED_MTU> recvBuffer;
+
+        RxTimestamp rxTime;
+        auto bytesRxed = rxFn_(recvBuffer, rxTime);
+        if (!bytesRxed.has_value() || bytesRxed == 0) {
+            return std::nullopt;
+        }
+        assert(bytesRxed <= MAX_SUPPORTED_MTU);
+
+        util::logDebug("Received {} bytes of data", bytesRxed.value());
+        if (bytesRxed.value() < DataPacketHeader::size()) {
+            util::logWarning("Dropped datagram of {} bytes which is too short to hold a packet header",
+                             bytesRxed.value());
+            metrics_.corruptPackets_.increment();
+            return std::nullopt;
+        }
+        arq::DataPacket packet{std::span(recvBuffer).first(bytesRxed.value())};
+        if (!packet.checkSumValid()) {
+            util::logWarning("Dropped packet with SN {} which failed its checksum",
+                             packet.getHeader().sequenceNumber_);
+            metrics_.corruptPackets_.increment();
+            return std::nullopt;
+        }
+        if (packet.isProbe()) {
+            util::logDebug("Discarded path MTU probe of {} bytes", bytesRxed.value());
+            return std::nullopt;
+        }
+        packet.setRxTime(rxTime);
+        return packet;
+    }
+
+    void sendAck(const ControlPacket& ctrlPkt)
+    {
+        util::logInfo("Sending ACK for packet with SN {} with receive window {}",
+                      ctrlPkt.sequenceNumber_,
+                      ctrlPkt.receiveWindow_);
+        util::trace(util::TraceEvent::ACK_TX, id_, ctrlPkt.sequenceNumber_);
+        std::array<std::byte, arq::ControlPacket::size()> sendBuffer;
+
+        if (ctrlPkt.serialise(sendBuffer)) {
+            txFn_(sendBuffer);
+            metrics_.acksSent_.increment();
+            util::logDebug("Sent {} bytes", sendBuffer.size());
+        }
+        else {
+            util::logError("Failed to serialise control packet");
+        }
+    }
+
+    // Feeds a received packet to the RS buffer and sends any resulting ACK. Packets beyond the receive window are
+    // dropped, so that the RS buffer never holds more than the output buffer has room for, and the last ACK is
+    // repeated with the current window in reply to any zero-window probe.
+    void processPacket(DataPacket&& packet)
+    {
+        auto pktHdr = packet.getHeader();
+        util::logInfo("Received data packet with length {} and SN {}", pktHdr.length_, pktHdr.sequenceNumber_);
+        if (packet.rxTime().has_value()) {
+            util::trace(util::TraceEvent::PACKET_RX, pktHdr.id_, pktHdr.sequenceNumber_, packet.rxTime().value());
+        }
+        else {
+            util::trace(util::TraceEvent::PACKET_RX, pktHdr.id_, pktHdr.sequenceNumber_);
+        }
+        metrics_.packetsReceived_.increment();
+
+        const auto lastAckSn = lastAckSn_.value_or(outputBuffer_.nextSequenceNumber() - 1);
+        const auto window = outputBuffer_.receiveWindow(lastAckSn);
+        // SNs wrap, so a packet is ahead of the last ACK if it falls in the half of the SN space which follows it
+        const SequenceNumber offset = pktHdr.sequenceNumber_ - lastAckSn;
+        if (offset > window && offset <= MAX_SEQUENCE_NUMBER / 2) {
+            util::logInfo("Dropped packet with SN {} beyond the receive window of {} packets after SN {}",
+                          pktHdr.sequenceNumber_,
+                          window,
+                          lastAckSn);
+            metrics_.receiveWindowDrops_.increment();
+            if (lastAckSn_.has_value()) {
+                sendAck({.sequenceNumber_ = lastAckSn, .receiveWindow_ = window});
+            }
+            return;
+        }
+
+        // Record if EoT received
+        if (packet.isEndOfTx()) {
+            endOfTxSn_ = pktHdr.sequenceNumber_;
+        }
+
+        auto ack = resequencingBuffer_->addPacket(std::move(packet));
+        metrics_.rsBufferBytes_.set(resequencingBuffer_->memoryUsage());
+        if (ack.has_value()) {
+            lastAckSn_ = ack.value();
+            sendAck({.sequenceNumber_ = ack.value(), .receiveWindow_ = outputBuffer_.receiveWindow(ack.value())});
+
+            // Check if we've rx'd the last packet
+            if (endOfTxSn_.has_value() && ack.value() == endOfTxSn_.value()) {
+                util::logInfo("Sent ACK for End of Tx packet");
+                ackedEndOfTx_ = true;
+            }
+        }
+    }
+
+    // Pushes every packet the RS buffer can release to the output buffer, until it is full.
+    void deliverPackets()
+    {
+        for (std::optional<DataPacket> packetForDelivery;
+             !outputBuffer_.full() && ((packetForDelivery = resequencingBuffer_->getNextPacket()) != std::nullopt);) {
+            const auto sn = packetForDelivery->getHeader().sequenceNumber_;
+            const bool isEndOfTx = packetForDelivery->isEndOfTx();
+            if (outputBuffer_.addPacket(std::move(packetForDelivery.value()))) {
+                metrics_.outputBufferDepth_.add(1);
+                if (latencyStats_ != nullptr && !isEndOfTx) {
+                    latencyStats_->packetDelivered(sn, ClockType::now());
+                }
+            }
+        }
+    }
+
+    // The resequencing coroutine receives packets, acknowledges them and delivers them to the output buffer. It exits
+    // once the ACK for an EoT packet has been sent.
+    util::Task resequencingTask()
+    {
+        resequencingBuffer_->attachMetrics(metrics_.duplicatePackets_, metrics_.outOfWindowPackets_);
+        metrics_.rsBufferBytes_.set(resequencingBuffer_->memoryUsage());
+
+        while (!ackedEndOfTx_) {
+            co_await executor_.readable(rxFd_);
+
+            for (auto packet = receivePacket(); !ackedEndOfTx_ && packet.has_value(); packet = receivePacket()) {
+                processPacket(std::move(packet.value()));
+            }
+            deliverPackets();
+        }
+
+        util::logInfo("Receiver resequencing coroutine exited");
+    }
+
+    // Identifies the current conversation
+    ConversationID id_;
+    // Executor on which the receiver's coroutine runs
+    util::Executor& executor_;
+    // Function pointer for raw data transmission
+    TransmitFn txFn_;
+    // Function pointer for raw data reception, which must not block
+    ReceiveFn rxFn_;
+    // File descriptor which is readable when rxFn_ has data to return
+    int rxFd_;
+    // Store packets for delivery
+    OutputBuffer outputBuffer_;
+    // The SN last acknowledged, relative to which the receive window is advertised
+    std::optional<SequenceNumber> lastAckSn_;
+    // Store packets that have been received but not yet pushed to the output buffer
+    std::unique_ptr<RSBufferType> resequencingBuffer_;
+    // If set, records the delay of each packet pushed to the output buffer (shared with the Transmitter)
+    std::shared_ptr<LatencyStats> latencyStats_;
+    // Counters and gauges exported for this conversation
+    ReceiverMetrics metrics_;
+    // Has the ACK for an EoT packet been sent?
+    bool ackedEndOfTx_ = false;
+    // If an EoT has been received, store its SN
+    std::optional<SequenceNumber> endOfTxSn_;
+};
+
+} // namespace arq
+
+#endif
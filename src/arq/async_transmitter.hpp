@@ -0,0 +1,265 @@
+#ifndef _ARQ_ASYNC_TRANSMITTER_HPP_
+#define _ARQ_ASYNC_TRANSMITTER_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+#include "arq/common/arq_common.hpp"
+#include "arq/common/conversation_id.hpp"
+#include "arq/common/input_buffer.hpp"
+#include "arq/common/latency_stats.hpp"
+#include "arq/common/protocol_metrics.hpp"
+#include "arq/transmitter.hpp"
+
+#include "util/executor.hpp"
+#include "util/logging.hpp"
+#include "util/trace.hpp"
+
+namespace arq {
+
+/*
+ * A Transmitter whose transmit and ACK threads are replaced by coroutines run on an executor, so that many
+ * conversations can share a single thread. The receive function must not block: the ACK coroutine waits for the
+ * given file descriptor to become readable, then reads until the receive function fails. Since both coroutines run on
+ * the same thread, ACKs are applied to the RT buffer directly rather than passed through a queue.
+ *
+ * The transmitter must outlive the executor's run() call, and sendPacket() may only be called from the executor's
+ * thread (typically from another coroutine). Since waiting for room in the input buffer would stall the executor,
+ * sendPacket() never waits: a sender which finds the buffer full can co_await writable() and try again.
+ */
+template <RTBuffer RTBufferType>
+class AsyncTransmitter {
+public:
+    AsyncTransmitter(ConversationID id,
+                     util::Executor& executor,
+                     TransmitFn txFn,
+                     ReceiveFn rxFn,
+                     int rxFd,
+                     std::unique_ptr<RTBufferType>&& rtBuffer_p,
+                     std::shared_ptr<LatencyStats> latencyStats = nullptr,
+                     InputBufferPolicy inputBufferPolicy = {}) :
+        id_{id},
+        executor_{executor},
+        txFn_{txFn},
+        rxFn_{rxFn},
+        rxFd_{rxFd},
+        inputBuffer_{FIRST_SEQUENCE_NUMBER, std::move(inputBufferPolicy)},
+        retransmissionBuffer_{std::move(rtBuffer_p)},
+        latencyStats_{std::move(latencyStats)},
+        metrics_{id},
+        wakeup_{executor},
+        roomAvailable_{executor}
+    {
+        executor_.spawn(transmitTask());
+        executor_.spawn(ackTask());
+    }
+
+    AsyncTransmitter(const AsyncTransmitter&) = delete;
+    AsyncTransmitter& operator=(const AsyncTransmitter&) = delete;
+
+    // Submit a packet for transmission, unless the input buffer is full, in which case SendStatus::FULL is returned and
+    // the packet is left with the caller. An open-loop sender gives the time at which the packet was scheduled to be
+    // sent, so that any delay in submitting it counts towards its queueing delay.
+    SendStatus sendPacket(arq::DataPacket&& packet,
+                          std::optional<std::chrono::time_point<ClockType>> dueTime = std::nullopt)
+    {
+        if (inputBuffer_.tryAddPacket(std::move(packet), dueTime) == SendStatus::FULL) {
+            metrics_.inputBufferFull_.increment();
+            return SendStatus::FULL;
+        }
+        metrics_.inputBufferDepth_.add(1);
+        wakeup_.set();
+        return SendStatus::QUEUED;
+    }
+
+    // Suspends the calling coroutine until the transmitter has taken a packet from the input buffer, which may have
+    // made room for another
+    auto writable() noexcept { return roomAvailable_.wait(); }
+
+    // Has an EoT packet been transmitted and acknowledged?
+    bool finished() const noexcept { return endOfTxAcked_; }
+
+private:
+    // Transmits data using the transmit function.
+    void transmitPacketData(auto dataToTx) const
+    {
+        auto result = txFn_(dataToTx);
+        if (result.has_value()) {
+            util::logDebug("Successfully transmitted {} bytes", result.value());
+        }
+        else {
+            util::logError("Transmit function failed!");
+        }
+    }
+
+    // Attempts to transmit a packet from the RT buffer, returns true if the RT is non-empty.
+    bool attemptPacketRetransmission()
+    {
+        auto packetSpanToReTx = retransmissionBuffer_->tryGetPacketSpan();
+        bool packetAvailable = packetSpanToReTx.has_value();
+        if (packetAvailable) {
+            DataPacketHeader hdr;
+            hdr.deserialise(packetSpanToReTx.value());
+
+            util::logInfo("Retransmitting packet with SN {} and length {}", hdr.sequenceNumber_, hdr.length_);
+            util::trace(util::TraceEvent::PACKET_RETX, hdr.id_, hdr.sequenceNumber_);
+            metrics_.timeoutRetransmissions_.increment();
+            transmitPacketData(packetSpanToReTx.value());
+        }
+        return packetAvailable;
+    }
+
+    // Attempts to transmit a new packet from the input buffer, returns true if a new packet is transmitted.
+    bool attemptNewPacketTransmission()
+    {
+        if (!retransmissionBuffer_->readyForNewPacket()) {
+            return false;
+        }
+
+        auto newPkt = inputBuffer_.tryGetPacket();
+        bool packetAvailable = newPkt.has_value();
+        if (packetAvailable) {
+            metrics_.inputBufferDepth_.add(-1);
+            roomAvailable_.set();
+            if (newPkt->isEndOfTx()) {
+                util::logInfo("Transmitter received end of EndofTx from input buffer");
+                endOfTxSeqNum_ = newPkt->info_.sequenceNumber_;
+            }
+
+            util::logInfo("Transmitting packet with SN {} and adding to retransmission buffer",
+                          newPkt->info_.sequenceNumber_);
+            util::trace(util::TraceEvent::PACKET_TX, id_, newPkt->info_.sequenceNumber_);
+            // Time the first transmission from here rather than from entry to the input buffer, so that queueing
+            // delay counts towards neither the timeout nor the RTT
+            newPkt->updateLastTxTime();
+            if (latencyStats_ != nullptr && !newPkt->isEndOfTx()) {
+                latencyStats_->packetSent(
+                    newPkt->info_.sequenceNumber_, newPkt->info_.dueTime_, newPkt->info_.lastTxTime_);
+            }
+            transmitPacketData(newPkt->packet_.getReadSpan());
+            metrics_.packetsSent_.increment();
+
+            retransmissionBuffer_->addPacket(std::move(newPkt.value()));
+            metrics_.windowOccupancy_.set(retransmissionBuffer_->packetCount());
+            metrics_.rtBufferBytes_.set(retransmissionBuffer_->memoryUsage());
+        }
+        return packetAvailable;
+    }
+
+    // Passes an ACK which arrived at rxTime, and the receive window it advertises, to the RT buffer.
+    void processAck(const SequenceNumber snToAck,
+                    const uint16_t receiveWindow,
+                    const std::chrono::time_point<ClockType> rxTime)
+    {
+        if (snToAck == endOfTxSeqNum_) {
+            endOfTxAcked_ = true;
+        }
+        else {
+            if (const auto rttSample = retransmissionBuffer_->acknowledgePacket(snToAck, rxTime);
+                rttSample.has_value()) {
+                metrics_.rttMicroseconds_.set(rttSample->count());
+            }
+            retransmissionBuffer_->updateReceiveWindow(receiveWindow);
+            metrics_.receiveWindow_.set(receiveWindow);
+            metrics_.windowOccupancy_.set(retransmissionBuffer_->packetCount());
+            metrics_.rtBufferBytes_.set(retransmissionBuffer_->memoryUsage());
+        }
+    }
+
+    // How long the transmit coroutine sleeps while packets await acknowledgement before checking for timeouts
+    std::chrono::microseconds timeoutPollInterval() const noexcept
+    {
+        return std::max(retransmissionBuffer_->timeoutInterval() / 10, std::chrono::microseconds{100});
+    }
+
+    // The transmit coroutine handles transmission and retransmission of all packets. It yields after each
+    // transmission, and when there is nothing to send, sleeps until a new packet or ACK arrives or an unacknowledged
+    // packet may have timed out. It continues running until an ACK corresponding to an EoT packet has been received.
+    util::Task transmitTask()
+    {
+        util::logInfo("Transmitter Tx coroutine started");
+        metrics_.rtoMicroseconds_.set(retransmissionBuffer_->timeoutInterval().count());
+        metrics_.rtBufferBytes_.set(retransmissionBuffer_->memoryUsage());
+
+        while (!endOfTxAcked_) {
+            if (attemptPacketRetransmission() || attemptNewPacketTransmission()) {
+                co_await executor_.yield();
+                continue;
+            }
+
+            std::optional<util::Executor::TimePoint> deadline;
+            if (retransmissionBuffer_->packetCount() > 0) {
+                deadline = util::Executor::ClockType::now() + timeoutPollInterval();
+            }
+            co_await wakeup_.wait(deadline);
+        }
+
+        util::logInfo("Transmitter Tx coroutine exited");
+    }
+
+    // The acknowledgement coroutine handles ACKs received at the transmitter from the receiver. Whenever the socket is
+    // readable, it applies every pending ACK and wakes the transmit coroutine. It runs until an ACK is received for
+    // an EoT packet.
+    util::Task ackTask()
+    {
+        util::logInfo("Transmitter ACK coroutine started");
+
+        while (!endOfTxAcked_) {
+            co_await executor_.readable(rxFd_);
+
+            std::array<std::byte, arq::MAX_SUPPORTED_MTU> recvBuffer;
+            RxTimestamp rxTime;
+            for (auto receivedBytes = rxFn_(recvBuffer, rxTime); !endOfTxAcked_ && receivedBytes.has_value();
+                 receivedBytes = rxFn_(recvBuffer, rxTime)) {
+                arq::ControlPacket ack;
+                if (receivedBytes > 0 && ack.deserialise(std::span(recvBuffer).first(receivedBytes.value()))) {
+                    const auto ackTime = rxTime.value_or(ClockType::now());
+                    util::logInfo(
+                        "Received ACK for SN {} with receive window {}", ack.sequenceNumber_, ack.receiveWindow_);
+                    util::trace(util::TraceEvent::ACK_RX, id_, ack.sequenceNumber_, ackTime);
+                    metrics_.acksReceived_.increment();
+                    processAck(ack.sequenceNumber_, ack.receiveWindow_, ackTime);
+                }
+                else {
+                    util::logWarning("Received packet that is too short to be an ACK");
+                }
+            }
+            wakeup_.set();
+        }
+
+        util::logInfo("Transmitter ACK coroutine exited");
+    }
+
+    // Identifies the current conversation
+    ConversationID id_;
+    // Executor on which the transmitter's coroutines run
+    util::Executor& executor_;
+    // Function pointer for raw data transmission
+    TransmitFn txFn_;
+    // Function pointer for raw data reception, which must not block
+    ReceiveFn rxFn_;
+    // File descriptor which is readable when rxFn_ has data to return
+    int rxFd_;
+    // Store packets for transmission that are yet to be transmitted
+    InputBuffer inputBuffer_;
+    // Store packets that have been transmitted but not acknowledged, and so may require retransmission
+    std::unique_ptr<RTBufferType> retransmissionBuffer_;
+    // If set, records the time at which each packet entered the input buffer (shared with the Receiver)
+    std::shared_ptr<LatencyStats> latencyStats_;
+    // Counters and gauges exported for this conversation
+    TransmitterMetrics metrics_;
+    // Set when a new packet or ACK arrives, to wake the transmit coroutine
+    util::Event wakeup_;
+    // Set when a packet is taken from the input buffer, to wake a sender waiting for room
+    util::Event roomAvailable_;
+    // If an EoT has been received, store the sequence number
+    std::optional<SequenceNumber> endOfTxSeqNum_;
+    // Has an EoT packet been transmitted and acknowledged?
+    bool endOfTxAcked_ = false;
+};
+
+} // namespace arq
+
+#endif
@@ -5,16 +5,40 @@
 #include <cstdint>
 #include <exception>
 #include <functional>
+#include <optional>
 #include <span>
+#include <type_traits>
 
 namespace arq {
 
 using ClockType = std::chrono::high_resolution_clock;
 
-using TransmitFn = std::function<std::optional<size_t>(std::span<const std::byte> buffer)>;
-using ReceiveFn = std::function<std::optional<size_t>(std::span<std::byte> buffer)>;
+// The time at which a packet arrived, if the receive function can report it (e.g. from a kernel timestamp)
+using RxTimestamp = std::optional<std::chrono::time_point<ClockType>>;
 
-constexpr uint16_t packet_payload_length = 1000;
+using TransmitFn = std::function<std::optional<size_t>(std::span<const std::byte> buffer)>;
+using ReceiveFn = std::function<std::optional<size_t>(std::span<std::byte> buffer, RxTimestamp& rxTime)>;
+
+// Converts a time read from the system clock, such as a kernel timestamp, to ClockType
+inline std::chrono::time_point<ClockType> fromSystemTime(const std::chrono::system_clock::time_point time) noexcept
+{
+    if constexpr (std::is_same_v<ClockType, std::chrono::system_clock>) {
+        return time;
+    }
+    else {
+        return ClockType::now() +
+               std::chrono::duration_cast<ClockType::duration>(time - std::chrono::system_clock::now());
+    }
+}
+
+// How the Transmitter and Receiver divide their work between threads
+enum class ThreadingMode {
+    // Data and ACKs are handled on separate threads, which hand ACKs to each other through a queue
+    SPLIT,
+    // A single thread owns the socket, busy-polling it and handling each ACK inline. The receive function must not
+    // block.
+    RUN_TO_COMPLETION
+};
 
 struct ArqProtocolException : public std::runtime_error {
     explicit ArqProtocolException(const std::string& what) : std::runtime_error(what){};
@@ -0,0 +1,88 @@
+#include "arq/common/byte_stream.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "util/logging.hpp"
+
+void arq::StreamWriter::writev(std::span<const std::span<const std::byte>> buffers)
+{
+    for (auto buffer : buffers) {
+        while (!buffer.empty()) {
+            if (!pending_.has_value()) {
+                pending_.emplace();
+                pending_->updateConversationID(id_);
+                pending_->updateDataLength(maxPayloadSize_);
+                pendingLength_ = 0;
+            }
+
+            const auto length = std::min(buffer.size(), maxPayloadSize_ - pendingLength_);
+            std::memcpy(pending_->getPayloadSpan().data() + pendingLength_, buffer.data(), length);
+            pendingLength_ += length;
+            buffer = buffer.subspan(length);
+
+            if (pendingLength_ == maxPayloadSize_) {
+                flush();
+            }
+        }
+    }
+}
+
+void arq::StreamWriter::flush()
+{
+    if (!pending_.has_value()) {
+        return;
+    }
+
+    pending_->updateDataLength(pendingLength_);
+    util::logDebug("Sending stream packet with length {}", pendingLength_);
+    sendPacket_(std::move(pending_.value()));
+    ++packetsSent_;
+    pending_.reset();
+}
+
+size_t arq::StreamReader::readv(std::span<const std::span<std::byte>> buffers)
+{
+    size_t bytesRead = 0;
+    for (auto buffer : buffers) {
+        while (!buffer.empty()) {
+            if (!current_.has_value() || offset_ == current_->packet_.getPayloadReadSpan().size()) {
+                // Only wait for data if there is none to return
+                if (!nextPacket(bytesRead == 0)) {
+                    return bytesRead;
+                }
+                continue;
+            }
+
+            const auto payload = current_->packet_.getPayloadReadSpan().subspan(offset_);
+            const auto length = std::min(buffer.size(), payload.size());
+            std::memcpy(buffer.data(), payload.data(), length);
+            offset_ += length;
+            bytesRead += length;
+            buffer = buffer.subspan(length);
+        }
+    }
+    return bytesRead;
+}
+
+bool arq::StreamReader::nextPacket(const bool wait)
+{
+    current_.reset();
+    if (endOfStream_) {
+        return false;
+    }
+
+    current_ = wait ? waitForPacket_() : tryGetPacket_();
+    if (!current_.has_value()) {
+        return false;
+    }
+    offset_ = 0;
+
+    if (current_->packet_.isEndOfTx()) {
+        util::logDebug("Reached end of stream");
+        endOfStream_ = true;
+        current_.reset();
+        return false;
+    }
+    return true;
+}
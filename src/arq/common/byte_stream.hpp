@@ -0,0 +1,99 @@
+#ifndef _ARQ_COMMON_BYTE_STREAM_HPP_
+#define _ARQ_COMMON_BYTE_STREAM_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+
+#include "arq/common/conversation_id.hpp"
+#include "arq/common/data_packet.hpp"
+#include "arq/common/rx_buffer_object.hpp"
+
+namespace arq {
+
+/*
+ * Writes a byte stream to a transmitter, filling each DataPacket up to the MTU before sending it, so that the stream is
+ * carried in as few packets as possible regardless of how it is split into writes. Data is copied straight from the
+ * caller's buffers into the packets, so gathering several buffers with writev() costs no more than a single write().
+ *
+ * Bytes which do not fill a packet are held until more are written or flush() is called. The end of the stream is
+ * marked by sending an EoT packet after the final flush.
+ */
+class StreamWriter {
+public:
+    using SendPacketFn = std::function<void(DataPacket&&)>;
+
+    StreamWriter(ConversationID id, SendPacketFn sendPacket, size_t mtu = DEFAULT_MTU) :
+        id_{id}, sendPacket_{std::move(sendPacket)}, maxPayloadSize_{maxPayloadSize(mtu)}
+    {
+    }
+    StreamWriter(const StreamWriter&) = delete;
+    StreamWriter& operator=(const StreamWriter&) = delete;
+    // Sends any held bytes
+    ~StreamWriter() { flush(); }
+
+    // Append the buffer, or each of the buffers in turn, to the stream
+    void write(std::span<const std::byte> buffer) { writev({&buffer, 1}); }
+    void writev(std::span<const std::span<const std::byte>> buffers);
+    // Send any held bytes in a partially filled packet
+    void flush();
+
+    // Number of packets passed to sendPacket
+    size_t packetsSent() const noexcept { return packetsSent_; }
+
+private:
+    // Identifies the current conversation
+    ConversationID id_;
+    // Function to which each packet is passed once full or flushed
+    SendPacketFn sendPacket_;
+    // Largest payload of a packet which fits in the MTU
+    const size_t maxPayloadSize_;
+    // Packet being filled, whose payload is sized to maxPayloadSize_ until it is sent
+    std::optional<DataPacket> pending_;
+    // Bytes of the pending packet's payload filled so far
+    size_t pendingLength_ = 0;
+    size_t packetsSent_ = 0;
+};
+
+/*
+ * Reads a byte stream written by a StreamWriter from the packets delivered in order by a receiver's output buffer,
+ * keeping its place within a partially read packet. Data is copied straight from the packets into the caller's
+ * buffers.
+ *
+ * Like a socket read, a read waits for data using waitForPacket only if none has yet been copied, then takes any
+ * further packets already delivered using tryGetPacket, which must not block.
+ */
+class StreamReader {
+public:
+    using GetPacketFn = std::function<std::optional<ReceiveBufferObject>()>;
+
+    StreamReader(GetPacketFn waitForPacket, GetPacketFn tryGetPacket) :
+        waitForPacket_{std::move(waitForPacket)}, tryGetPacket_{std::move(tryGetPacket)}
+    {
+    }
+
+    // Fill the buffer, or each of the buffers in turn, with as much of the stream as is available, returning the
+    // number of bytes read. Returns zero once the end of the stream has been reached.
+    size_t read(std::span<std::byte> buffer) { return readv({&buffer, 1}); }
+    size_t readv(std::span<const std::span<std::byte>> buffers);
+
+    // Has the EoT packet been received, and all data before it read?
+    bool endOfStream() const noexcept { return endOfStream_; }
+
+private:
+    // Move on to the next packet, returning false if none is available or the stream has ended
+    bool nextPacket(bool wait);
+
+    GetPacketFn waitForPacket_;
+    GetPacketFn tryGetPacket_;
+    // Packet from which the stream is currently being read
+    std::optional<ReceiveBufferObject> current_;
+    // Offset of the next unread byte in the current packet's payload
+    size_t offset_ = 0;
+    bool endOfStream_ = false;
+};
+
+} // namespace arq
+
+#endif
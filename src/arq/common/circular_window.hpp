@@ -0,0 +1,161 @@
+#ifndef _ARQ_COMMON_CIRCULAR_WINDOW_HPP_
+#define _ARQ_COMMON_CIRCULAR_WINDOW_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+
+#include "arq/common/sequence_number.hpp"
+#include "util/occupancy_bitmap.hpp"
+#include "util/paged_array.hpp"
+
+namespace arq {
+
+/*
+ * A sliding window of objects keyed by sequence number, as used by the windowed RT and RS buffers. The window holds
+ * SNs in the interval [start, start + windowSize). Storage is rounded up to a power of two so that an SN maps to its
+ * slot with a mask, and since the capacity divides the SN space, this mapping is unaffected by SN roll-over. Sliding
+ * the window forward only touches the slots being released.
+ *
+ * Slots are stored in pages of up to 64, one word of the occupancy bitmap, which are allocated as they are first used
+ * and released once they are empty. Memory is therefore proportional to the SNs in use rather than the window size.
+ */
+template <typename T>
+class CircularWindow {
+public:
+    CircularWindow(const uint16_t windowSize, const SequenceNumber firstSeqNum) :
+        windowSize_{windowSize},
+        mask_{std::bit_ceil(static_cast<size_t>(windowSize)) - 1},
+        slots_{mask_ + 1, std::min(mask_ + 1, util::OccupancyBitmap::bitsPerWord)},
+        occupied_{mask_ + 1},
+        start_{firstSeqNum}
+    {
+        assert(windowSize > 0);
+    }
+
+    // The earliest SN in the window
+    SequenceNumber start() const noexcept { return start_; }
+
+    uint16_t windowSize() const noexcept { return windowSize_; }
+
+    // The number of slots addressable, which is the window size rounded up to a power of two
+    size_t capacity() const noexcept { return slots_.size(); }
+
+    // Bytes of memory allocated for the window's storage
+    size_t memoryUsage() const noexcept { return slots_.memoryUsage() + occupied_.words().size_bytes(); }
+
+    // Allocates storage for the whole window up front, so that no page faults occur as the window fills
+    void prefault() { slots_.prefault(); }
+
+    // Reallocates the storage allocated when the window was constructed from the calling thread, so that it is placed
+    // according to that thread's memory policy
+    void localise()
+    {
+        slots_.localise();
+        occupied_.localise();
+    }
+
+    // The number of occupied slots
+    size_t count() const noexcept { return occupied_.count(); }
+
+    bool empty() const noexcept { return count() == 0; }
+
+    bool full() const noexcept { return count() == windowSize_; }
+
+    // Does the SN lie within the window?
+    bool contains(const SequenceNumber seqNum) const noexcept { return offset(seqNum) < windowSize_; }
+
+    // Returns the object with the given SN, or nullptr if that slot is empty or outside the window
+    T* find(const SequenceNumber seqNum) noexcept
+    {
+        return contains(seqNum) && occupied_.test(slot(seqNum)) ? &slots_[slot(seqNum)].value() : nullptr;
+    }
+
+    // Places an object in the slot for the given SN. Returns false if the SN is outside the window or already present.
+    bool insert(const SequenceNumber seqNum, T&& value)
+    {
+        if (!contains(seqNum) || occupied_.test(slot(seqNum))) {
+            return false;
+        }
+        slots_.allocate(slot(seqNum)).emplace(std::move(value));
+        occupied_.set(slot(seqNum));
+        return true;
+    }
+
+    // If the earliest SN in the window is present, removes it and slides the window forward by one
+    std::optional<T> popFront()
+    {
+        const auto idx = slot(start_);
+        if (!occupied_.test(idx)) {
+            return std::nullopt;
+        }
+        T front = std::move(slots_[idx].value());
+        release(idx);
+        ++start_;
+        return front;
+    }
+
+    // Slides the window forward so that it starts at the given SN, releasing any objects before it. Returns the number
+    // of objects released.
+    size_t releaseUntil(const SequenceNumber seqNum)
+    {
+        const auto toRelease = offset(seqNum);
+        assert(toRelease <= windowSize_);
+
+        const auto countBefore = count();
+        for (size_t i = 0; i < toRelease; ++i) {
+            const auto idx = slot(start_ + i);
+            if (occupied_.test(idx)) {
+                release(idx);
+            }
+        }
+        start_ = seqNum;
+        return countBefore - count();
+    }
+
+    // Returns the earliest object in the window satisfying pred, visiting only occupied slots
+    template <typename Pred>
+    T* findFirst(Pred pred)
+    {
+        size_t idx = slot(start_);
+        for (size_t visited = 0; visited < count(); ++visited) {
+            idx = occupied_.findNextSet(idx).value();
+            if (pred(slots_[idx].value())) {
+                return &slots_[idx].value();
+            }
+            idx = (idx + 1) & mask_;
+        }
+        return nullptr;
+    }
+
+private:
+    // Empties an occupied slot, releasing its page if no other slots in it are occupied
+    void release(const size_t idx)
+    {
+        slots_[idx].reset();
+        occupied_.reset(idx);
+        if (occupied_.wordEmpty(idx)) {
+            slots_.releasePage(idx);
+        }
+    }
+
+    size_t slot(const SequenceNumber seqNum) const noexcept { return seqNum & mask_; }
+
+    // Distance of the SN from the start of the window, allowing for roll-over
+    size_t offset(const SequenceNumber seqNum) const noexcept
+    {
+        return static_cast<SequenceNumber>(seqNum - start_);
+    }
+
+    const uint16_t windowSize_;
+    const size_t mask_;
+    util::PagedArray<std::optional<T>> slots_;
+    util::OccupancyBitmap occupied_;
+    SequenceNumber start_;
+};
+
+} // namespace arq
+
+#endif
@@ -1,11 +1,35 @@
 #include "arq/common/control_packet.hpp"
 
+#include <netdb.h>
+#include <cstring>
+
 bool arq::ControlPacket::serialise(std::span<std::byte> buffer) const noexcept
 {
-    return serialiseSeqNum(sequenceNumber_, buffer);
+    if (buffer.size() < this->size()) {
+        return false;
+    }
+
+    serialiseSeqNum(sequenceNumber_, buffer);
+
+    static_assert(sizeof(receiveWindow_) == 2);
+    const uint16_t window = htons(receiveWindow_);
+    std::memcpy(buffer.data() + sizeof(sequenceNumber_), &window, sizeof(receiveWindow_));
+    return true;
 }
 
 bool arq::ControlPacket::deserialise(std::span<const std::byte> buffer) noexcept
 {
-    return deserialiseSeqNum(sequenceNumber_, buffer);
+    if (!deserialiseSeqNum(sequenceNumber_, buffer)) {
+        return false;
+    }
+
+    if (buffer.size() < this->size()) {
+        receiveWindow_ = UNLIMITED_RECEIVE_WINDOW;
+    }
+    else {
+        uint16_t window;
+        std::memcpy(&window, buffer.data() + sizeof(sequenceNumber_), sizeof(receiveWindow_));
+        receiveWindow_ = ntohs(window);
+    }
+    return true;
 }
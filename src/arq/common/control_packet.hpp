@@ -1,22 +1,34 @@
 #ifndef _ARQ_COMMON_CONTROL_PACKET_HPP_
 #define _ARQ_COMMON_CONTROL_PACKET_HPP_
 
+#include <cstddef>
+#include <cstdint>
+
 #include "arq/common/sequence_number.hpp"
 
 namespace arq {
 
+// Advertised by a receiver which does not limit the number of packets in flight
+constexpr uint16_t UNLIMITED_RECEIVE_WINDOW = UINT16_MAX;
+
 // A control packet sent from arq::Receiver to arq::Transmitter to acknowledge
 // packets
 struct ControlPacket {
     // The sequence number being acknowledged
     SequenceNumber sequenceNumber_;
+    // Number of packets following sequenceNumber_ for which the receiver has room in its output buffer
+    uint16_t receiveWindow_ = UNLIMITED_RECEIVE_WINDOW;
 
     // Serialises the current contents of the ControlPacket to the buffer
     bool serialise(std::span<std::byte> buffer) const noexcept;
-    // Deserialises the buffer into the ControlPacket
+    // Deserialises the buffer into the ControlPacket. A buffer holding only a sequence number, as sent by receivers
+    // without flow control, is read as advertising an unlimited window.
     bool deserialise(std::span<const std::byte> buffer) noexcept;
+
+    static inline constexpr auto size() noexcept { return packed_size; }
+    static inline constexpr size_t packed_size = sizeof(sequenceNumber_) + sizeof(receiveWindow_);
 };
 
 } // namespace arq
 
-#endif
\ No newline at end of file
+#endif
@@ -1,8 +1,11 @@
 #include "arq/common/data_packet.hpp"
 
 #include <netdb.h>
+#include <algorithm>
 #include <cstring>
+#include <format>
 
+#include "util/crc32c.hpp"
 #include "util/logging.hpp"
 
 bool arq::DataPacketHeader::serialise(std::span<std::byte> buffer) const noexcept
@@ -33,6 +36,17 @@ bool arq::DataPacketHeader::serialise(std::span<std::byte> buffer) const noexcep
     std::memcpy(buffer.data() + pos, &temp, sizeof(length_));
     pos += sizeof(length_);
 
+    // Serialise fragment flags
+    static_assert(sizeof(flags_) == 1);
+    std::memcpy(buffer.data() + pos, &flags_, sizeof(flags_));
+    pos += sizeof(flags_);
+
+    // Serialise checksum
+    static_assert(sizeof(checksum_) == 4);
+    const uint32_t checksum = htonl(checksum_);
+    std::memcpy(buffer.data() + pos, &checksum, sizeof(checksum_));
+    pos += sizeof(checksum_);
+
     assert(pos == this->size());
     return true;
 }
@@ -66,6 +80,18 @@ bool arq::DataPacketHeader::deserialise(std::span<const std::byte> buffer) noexc
     length_ = ntohs(temp);
     pos += sizeof(length_);
 
+    // Deserialise fragment flags
+    static_assert(sizeof(flags_) == 1);
+    flags_ = std::to_integer<decltype(flags_)>(buffer[pos]);
+    pos += sizeof(flags_);
+
+    // Deserialise checksum
+    static_assert(sizeof(checksum_) == 4);
+    uint32_t checksum;
+    std::memcpy(&checksum, buffer.data() + pos, sizeof(checksum_));
+    checksum_ = ntohl(checksum);
+    pos += sizeof(checksum_);
+
     assert(pos == this->size());
 
     return true;
@@ -96,6 +122,20 @@ arq::DataPacket::DataPacket(std::vector<std::byte>&& serialData) : data_{std::mo
     }
 }
 
+arq::DataPacket arq::DataPacket::makeProbe(const ConversationID convID, const size_t size)
+{
+    if (size <= DataPacketHeader::size() || size > MAX_SUPPORTED_MTU) {
+        throw DataPacketException(std::format("cannot make a probe packet of size {}", size));
+    }
+
+    DataPacket probe{};
+    probe.updateConversationID(convID);
+    probe.updateDataLength(maxPayloadSize(size));
+    probe.updateFlags(PROBE);
+    probe.updateCheckSum();
+    return probe;
+}
+
 arq::DataPacketHeader arq::DataPacket::getHeader() const noexcept
 {
     return header_;
@@ -121,6 +161,13 @@ void arq::DataPacket::updateConversationID(const ConversationID convID)
     assert(ret);
 }
 
+void arq::DataPacket::updateFlags(const uint8_t flags)
+{
+    header_.flags_ = flags;
+    [[maybe_unused]] auto ret = serialiseHeader();
+    assert(ret);
+}
+
 bool arq::DataPacket::isEndOfTx() const noexcept
 {
     return header_.length_ == 0;
@@ -129,7 +176,8 @@ bool arq::DataPacket::isEndOfTx() const noexcept
 void arq::DataPacket::updateDataLength(const size_t len)
 {
     if (len > DATA_PKT_MAX_PAYLOAD_SIZE) {
-        util::logWarning("DataPacket truncated to {} bytes", DATA_PKT_MAX_PAYLOAD_SIZE);
+        util::logWarning("DataPacket truncated to {} bytes (send larger messages with a MessageAggregator)",
+                         DATA_PKT_MAX_PAYLOAD_SIZE);
         header_.length_ = DATA_PKT_MAX_PAYLOAD_SIZE;
     }
     else {
@@ -141,6 +189,25 @@ void arq::DataPacket::updateDataLength(const size_t len)
     assert(ret);
 }
 
+uint32_t arq::DataPacket::getCheckSum() const noexcept
+{
+    const auto payloadLength = std::min<size_t>(header_.length_, data_.size() - header_.size());
+    const auto headerCrc = util::crc32c(getHeaderReadSpan().first(DataPacketHeader::checksummed_size));
+    return util::crc32c(getPayloadReadSpan().first(payloadLength), headerCrc);
+}
+
+void arq::DataPacket::updateCheckSum() noexcept
+{
+    header_.checksum_ = getCheckSum();
+    [[maybe_unused]] auto ret = serialiseHeader();
+    assert(ret);
+}
+
+bool arq::DataPacket::checkSumValid() const noexcept
+{
+    return header_.size() + header_.length_ <= data_.size() && header_.checksum_ == getCheckSum();
+}
+
 std::span<std::byte> arq::DataPacket::getSpan() noexcept
 {
     return std::span<std::byte>(data_);
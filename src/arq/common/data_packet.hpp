@@ -12,7 +12,21 @@
 
 namespace arq {
 
-constexpr size_t MAX_TRANSMISSION_UNIT = 1500;
+// The MTU is the size of the largest serialised DataPacket, i.e. the UDP payload, which may be sent in a session. The
+// default fits a DataPacket and its 28 bytes of UDP/IPv4 headers inside a 1500-byte Ethernet MTU, while the maximum
+// allows for jumbo frames.
+constexpr size_t DEFAULT_MTU = 1500 - 28;
+constexpr size_t MAX_SUPPORTED_MTU = 9216;
+
+enum DataPacketFlags : uint8_t {
+    // Mark where a packet lies within a message fragmented across consecutive SNs
+    FIRST_FRAGMENT = 1 << 0,
+    LAST_FRAGMENT = 1 << 1,
+    // A packet which holds a whole message is both its first and last fragment
+    UNFRAGMENTED = FIRST_FRAGMENT | LAST_FRAGMENT,
+    // Marks a packet sent only to test the path MTU, which receivers discard
+    PROBE = 1 << 2,
+};
 
 struct DataPacketHeader {
     // Identifies the ARQ session
@@ -21,6 +35,10 @@ struct DataPacketHeader {
     SequenceNumber sequenceNumber_;
     // Length of the payload
     uint16_t length_; // A packet with payload length zero is an EndofTx packet
+    // DataPacketFlags describing the packet's place in its message
+    uint8_t flags_ = UNFRAGMENTED;
+    // CRC32C over the rest of the header and the payload
+    uint32_t checksum_;
 
     // Serialises the current contents of the DataPacketHeader to the buffer
     bool serialise(std::span<std::byte> buffer) const noexcept;
@@ -29,7 +47,10 @@ struct DataPacketHeader {
 
     // Returns the packed size of DataPacketHeader
     static inline constexpr auto size() noexcept { return packed_size; }
-    static inline constexpr size_t packed_size = sizeof(sequenceNumber_) + sizeof(length_) + sizeof(id_);
+    static inline constexpr size_t packed_size =
+        sizeof(sequenceNumber_) + sizeof(length_) + sizeof(id_) + sizeof(flags_) + sizeof(checksum_);
+    // The checksum is packed last, so that it covers every byte of the header before it
+    static inline constexpr size_t checksummed_size = packed_size - sizeof(checksum_);
 
     bool operator==(const DataPacketHeader& other) const = default;
 };
@@ -38,10 +59,15 @@ struct DataPacketException : public std::runtime_error {
     explicit DataPacketException(const std::string& what) : std::runtime_error(what){};
 };
 
-// Maximum permitted size of a DataPacket. Consider whether this should be
-// configurable. Value here chosen such that DataPacket + header fits inside a
-// single Ethernet frame.
-constexpr size_t DATA_PKT_MAX_PAYLOAD_SIZE = MAX_TRANSMISSION_UNIT - DataPacketHeader::size();
+// Maximum payload of a DataPacket which fits in the given MTU
+constexpr size_t maxPayloadSize(const size_t mtu) noexcept
+{
+    return mtu - DataPacketHeader::size();
+}
+
+// Maximum permitted size of a DataPacket payload in any session
+constexpr size_t DATA_PKT_MAX_PAYLOAD_SIZE = maxPayloadSize(MAX_SUPPORTED_MTU);
+static_assert(DATA_PKT_MAX_PAYLOAD_SIZE <= UINT16_MAX);
 
 class DataPacket {
 public:
@@ -52,6 +78,8 @@ public:
     // Rx-side: construct a packet from serialised packet data
     DataPacket(std::span<const std::byte> serialData);
     DataPacket(std::vector<std::byte>&& serialData);
+    // Tx-side: construct a PROBE packet which serialises to exactly the given size, for path MTU discovery
+    static DataPacket makeProbe(const ConversationID convID, const size_t size);
 
     // Get a copy of the header struct
     DataPacketHeader getHeader() const noexcept;
@@ -61,9 +89,13 @@ public:
     void updateSequenceNumber(const SequenceNumber seqNum);
     // Update header conversation ID and serialise it
     void updateConversationID(const ConversationID convID);
+    // Update header flags and serialise them
+    void updateFlags(const uint8_t flags);
 
     // Indicates whether the packet is an EndOfTx packet
     bool isEndOfTx() const noexcept;
+    // Indicates whether the packet is a path MTU probe
+    bool isProbe() const noexcept { return header_.flags_ & PROBE; }
 
     // Update the length of the payload
     void updateDataLength(const size_t len);
@@ -78,14 +110,29 @@ public:
     std::span<const std::byte> getHeaderReadSpan() const noexcept;
     std::span<const std::byte> getPayloadReadSpan() const noexcept;
 
-    // Get a checksum of the packet, including the header
-    uint32_t getCheckSum() const noexcept; // To implement: issue #23
-
-    bool operator==(const DataPacket& other) const = default;
+    // Get a checksum of the packet, including the header (other than the checksum itself)
+    uint32_t getCheckSum() const noexcept;
+    // Tx-side: write the checksum of the packet's current contents to its header. Must be called after the final
+    // update to the packet.
+    void updateCheckSum() noexcept;
+    // Rx-side: does the checksum in the header match the packet's contents? Fails if the packet is shorter than its
+    // header claims.
+    bool checkSumValid() const noexcept;
+
+    // Rx-side: the time at which the packet arrived, if reported by the receive function
+    const RxTimestamp& rxTime() const noexcept { return rxTime_; }
+    void setRxTime(const RxTimestamp& rxTime) noexcept { rxTime_ = rxTime; }
+
+    // Packets are equal if their contents are, regardless of when they arrived
+    bool operator==(const DataPacket& other) const noexcept
+    {
+        return header_ == other.header_ && data_ == other.data_;
+    }
 
 private:
     DataPacketHeader header_;
     std::vector<std::byte> data_;
+    RxTimestamp rxTime_;
 
     bool serialiseHeader() noexcept;
     bool deserialiseHeader() noexcept;
@@ -1,34 +1,146 @@
 #include "arq/common/input_buffer.hpp"
 
+#include <algorithm>
+
 #include "util/logging.hpp"
+#include "util/trace.hpp"
 
-arq::InputBuffer::InputBuffer(SequenceNumber firstSeqNum) : lastSequenceNumber_(firstSeqNum - 1) {}
+arq::InputBuffer::InputBuffer(SequenceNumber firstSeqNum, InputBufferPolicy policy) :
+    policy_{std::move(policy)}, lastSequenceNumber_(firstSeqNum - 1)
+{
+    policy_.capacity_ = std::max<size_t>(policy_.capacity_, 1);
+}
 
-void arq::InputBuffer::addPacket(arq::DataPacket&& packet)
+void arq::InputBuffer::addPacket(arq::DataPacket&& packet, std::optional<std::chrono::time_point<ClockType>> dueTime)
 {
-    arq::TransmitBufferObject temp{.packet_ = std::move(packet), .info_ = getNextInfo()};
-    // Add info to packet header
-    temp.packet_.updateSequenceNumber(temp.info_.sequenceNumber_);
+    bool reachedHighWatermark;
+    {
+        std::unique_lock<std::mutex> lock(mut_);
+        if (inputPackets_.size() >= policy_.capacity_) {
+            ++waitingSenders_;
+            const auto released = sendersReleased_;
+            roomAvailable_.wait(lock, [this, released]() {
+                return sendersReleased_ != released && inputPackets_.size() < policy_.capacity_;
+            });
+            --waitingSenders_;
+        }
+        reachedHighWatermark = push(std::move(packet), dueTime);
+    }
+    packetAdded_.notify_one();
 
-    std::println("Adding packet with SN {} to IB at time {}", temp.info_.sequenceNumber_, temp.info_.firstTxTime_);
+    if (reachedHighWatermark) {
+        policy_.onHighWatermark_();
+    }
+}
 
-    // Add packet to buffer
-    inputPackets_.push(std::move(temp));
+arq::SendStatus arq::InputBuffer::tryAddPacket(arq::DataPacket&& packet,
+                                               std::optional<std::chrono::time_point<ClockType>> dueTime)
+{
+    bool reachedHighWatermark;
+    {
+        std::unique_lock<std::mutex> lock(mut_);
+        if (inputPackets_.size() >= policy_.capacity_) {
+            return SendStatus::FULL;
+        }
+        reachedHighWatermark = push(std::move(packet), dueTime);
+    }
+    packetAdded_.notify_one();
+
+    if (reachedHighWatermark) {
+        policy_.onHighWatermark_();
+    }
+    return SendStatus::QUEUED;
 }
 
 arq::TransmitBufferObject arq::InputBuffer::getPacket()
 {
-    return inputPackets_.pop_wait();
+    TransmitBufferObject packet;
+    bool reachedLowWatermark;
+    {
+        std::unique_lock<std::mutex> lock(mut_);
+        packetAdded_.wait(lock, [this]() { return !inputPackets_.empty(); });
+        reachedLowWatermark = pop(packet);
+    }
+
+    if (reachedLowWatermark) {
+        policy_.onLowWatermark_();
+    }
+    return packet;
 }
 
 std::optional<arq::TransmitBufferObject> arq::InputBuffer::tryGetPacket()
 {
-    return inputPackets_.try_pop();
+    TransmitBufferObject packet;
+    bool reachedLowWatermark;
+    {
+        std::unique_lock<std::mutex> lock(mut_);
+        if (inputPackets_.empty()) {
+            return std::nullopt;
+        }
+        reachedLowWatermark = pop(packet);
+    }
+
+    if (reachedLowWatermark) {
+        policy_.onLowWatermark_();
+    }
+    return packet;
+}
+
+size_t arq::InputBuffer::size() const
+{
+    std::unique_lock<std::mutex> lock(mut_);
+    return inputPackets_.size();
+}
+
+bool arq::InputBuffer::push(arq::DataPacket&& packet, std::optional<std::chrono::time_point<ClockType>> dueTime)
+{
+    arq::TransmitBufferObject temp{.packet_ = std::move(packet), .info_ = getNextInfo()};
+    if (dueTime.has_value()) {
+        temp.info_.dueTime_ = dueTime.value();
+    }
+    // Add info to packet header. The packet is not changed after this, so its checksum is final.
+    temp.packet_.updateSequenceNumber(temp.info_.sequenceNumber_);
+    temp.packet_.updateCheckSum();
+
+    util::trace(util::TraceEvent::INPUT_BUFFER_ADD,
+                temp.packet_.getHeader().id_,
+                temp.info_.sequenceNumber_,
+                temp.info_.firstTxTime_);
+
+    // Add packet to buffer
+    inputPackets_.push_back(std::move(temp));
+
+    if (policy_.highWatermark_ > 0 && !aboveWatermark_ && inputPackets_.size() >= policy_.highWatermark_) {
+        aboveWatermark_ = true;
+        return static_cast<bool>(policy_.onHighWatermark_);
+    }
+    return false;
+}
+
+bool arq::InputBuffer::pop(TransmitBufferObject& packet)
+{
+    packet = std::move(inputPackets_.front());
+    inputPackets_.pop_front();
+
+    // Waiting senders are released once the buffer has drained by half, rather than as each packet is taken, so that
+    // they refill it in batches instead of waking the sender for every packet
+    if (waitingSenders_ > 0 && inputPackets_.size() <= policy_.capacity_ / 2) {
+        ++sendersReleased_;
+        roomAvailable_.notify_all();
+    }
+
+    if (aboveWatermark_ && inputPackets_.size() <= policy_.lowWatermark_) {
+        aboveWatermark_ = false;
+        return static_cast<bool>(policy_.onLowWatermark_);
+    }
+    return false;
 }
 
 arq::PacketInfo arq::InputBuffer::getNextInfo()
 {
     const auto currentTime = ClockType::now();
-    return PacketInfo{
-        .firstTxTime_ = currentTime, .lastTxTime_ = currentTime, .sequenceNumber_ = ++lastSequenceNumber_};
+    return PacketInfo{.dueTime_ = currentTime,
+                      .firstTxTime_ = currentTime,
+                      .lastTxTime_ = currentTime,
+                      .sequenceNumber_ = ++lastSequenceNumber_};
 }
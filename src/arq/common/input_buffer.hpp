@@ -1,33 +1,86 @@
 #ifndef _ARQ_COMMON_INPUT_BUFFER_HPP_
 #define _ARQ_COMMON_INPUT_BUFFER_HPP_
 
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <optional>
 
 #include "arq/common/arq_common.hpp"
 #include "arq/common/data_packet.hpp"
 #include "arq/common/tx_buffer_object.hpp"
 
-#include "util/safe_queue.hpp"
-
 namespace arq {
 
+constexpr size_t UNBOUNDED_INPUT_BUFFER = SIZE_MAX;
+
+// Result of submitting a packet without waiting for room
+enum class SendStatus {
+    QUEUED,
+    // The input buffer is full, so the packet was not taken
+    FULL,
+};
+
+// How many packets an input buffer holds, and callbacks made as it fills and drains, which let a sender slow down or
+// shed load before its packets queue for seconds
+struct InputBufferPolicy {
+    size_t capacity_ = UNBOUNDED_INPUT_BUFFER;
+    // onHighWatermark_ is called once the buffer grows to highWatermark_ packets, then onLowWatermark_ once it has
+    // drained to lowWatermark_, and so on alternately. A high watermark of zero disables them. onHighWatermark_ is
+    // called on the thread submitting packets and onLowWatermark_ on the thread taking them, without the buffer locked.
+    size_t highWatermark_ = 0;
+    size_t lowWatermark_ = 0;
+    std::function<void()> onHighWatermark_;
+    std::function<void()> onLowWatermark_;
+};
+
 class InputBuffer {
 public:
-    InputBuffer(SequenceNumber firstSeqNum = FIRST_SEQUENCE_NUMBER);
-    // Submit a packet for transmission
-    void addPacket(arq::DataPacket&& packet);
+    explicit InputBuffer(SequenceNumber firstSeqNum = FIRST_SEQUENCE_NUMBER, InputBufferPolicy policy = {});
+    // Submit a packet for transmission, optionally giving the time it was scheduled to be sent if this was earlier. If
+    // the buffer is full, wait until it has drained to half its capacity.
+    void addPacket(arq::DataPacket&& packet, std::optional<std::chrono::time_point<ClockType>> dueTime = std::nullopt);
+    // As addPacket, but if the buffer is full, return SendStatus::FULL at once, leaving the packet with the caller
+    SendStatus tryAddPacket(arq::DataPacket&& packet,
+                            std::optional<std::chrono::time_point<ClockType>> dueTime = std::nullopt);
     // Get next packet for transmission from the buffer. If the buffer is empty,
     // wait until a packet is available
     TransmitBufferObject getPacket();
     // If a packet is available, get the next packet from the buffer.
     std::optional<TransmitBufferObject> tryGetPacket();
 
+    size_t size() const;
+
+    size_t capacity() const noexcept { return policy_.capacity_; }
+
 private:
     // Get information for populating data packet header
     PacketInfo getNextInfo();
+    // Assigns the packet its SN and queues it, returning whether the high watermark was reached. The lock must be held
+    // and the buffer must have room.
+    bool push(arq::DataPacket&& packet, std::optional<std::chrono::time_point<ClockType>> dueTime);
+    // Takes the packet at the front of the queue, returning whether the low watermark was reached. The lock must be
+    // held and the queue must not be empty.
+    bool pop(TransmitBufferObject& packet);
 
-    util::SafeQueue<TransmitBufferObject> inputPackets_;
+    InputBufferPolicy policy_;
+    std::deque<TransmitBufferObject> inputPackets_;
     arq::SequenceNumber lastSequenceNumber_;
+    // Whether the high watermark has been reached since the low watermark was last reached
+    bool aboveWatermark_ = false;
+    // Number of senders waiting in addPacket for the buffer to drain
+    size_t waitingSenders_ = 0;
+    // Incremented each time waiting senders are released, so that a spurious wakeup does not release one early
+    uint64_t sendersReleased_ = 0;
+    // Mutex which must be held to access the queue
+    mutable std::mutex mut_;
+    // Signalled when a packet is added, and when a full buffer has drained by half
+    std::condition_variable packetAdded_;
+    std::condition_variable roomAvailable_;
 };
 
 } // namespace arq
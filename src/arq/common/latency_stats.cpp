@@ -0,0 +1,34 @@
+#include "arq/common/latency_stats.hpp"
+
+#include <format>
+
+// Prints the percentiles of one delay histogram on a single line
+static void printHistogram(std::ostream& out, const std::string_view name, const util::LatencyHistogram& histogram)
+{
+    constexpr auto percentiles = std::to_array<std::pair<std::string_view, double>>(
+        {{"p50", 50.0}, {"p90", 90.0}, {"p99", 99.0}, {"p99.9", 99.9}, {"p99.99", 99.99}});
+
+    // Delays are recorded in ns, but reported in ms for consistency with the test scripts
+    auto toMs = [](const double ns) { return ns / 1e6; };
+
+    out << std::format("{} over {} packets (ms): mean {:.3f}, min {:.3f}",
+                       name,
+                       histogram.count(),
+                       toMs(histogram.mean()),
+                       toMs(histogram.min()));
+    for (const auto& [label, percentile] : percentiles) {
+        out << std::format(", {} {:.3f}", label, toMs(histogram.valueAtPercentile(percentile)));
+    }
+    out << std::format(", max {:.3f}\n", toMs(histogram.max()));
+}
+
+void arq::LatencyStats::printSummary(std::ostream& out) const
+{
+    printHistogram(out, "End-to-end delay", histogram_);
+    printHistogram(out, "  Queueing delay", queueingHistogram_);
+    printHistogram(out, "  Network delay", networkHistogram_);
+
+    if (unmatched_ > 0) {
+        out << std::format("{} delivered packets had no recorded send time\n", unmatched_);
+    }
+}
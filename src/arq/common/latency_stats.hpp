@@ -0,0 +1,97 @@
+#ifndef _ARQ_COMMON_LATENCY_STATS_HPP_
+#define _ARQ_COMMON_LATENCY_STATS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <ostream>
+
+#include "arq/common/arq_common.hpp"
+#include "arq/common/sequence_number.hpp"
+#include "util/histogram.hpp"
+
+namespace arq {
+
+/*
+ * Records the end-to-end delay of each packet, from the time it was due to be sent to being pushed to the receiver's
+ * output buffer. Since packets do not carry timestamps on the wire, this requires the Transmitter and Receiver to share
+ * a LatencyStats object, so it is only available when both run in the same process.
+ *
+ * The delay is split at the packet's first transmission into queueing delay, spent waiting in the input buffer (and,
+ * for an open-loop sender which has fallen behind its schedule, waiting to be submitted at all), and network delay,
+ * which covers the link, any retransmissions and resequencing. A packet is due when it is added to the input buffer
+ * unless the sender gives the time it was scheduled to be sent; measuring from the schedule, rather than from when a
+ * backed-up sender got round to submitting it, stops a stall from hiding the delay of every packet queued behind it.
+ *
+ * packetSent is called from the transmitter's Tx thread and packetDelivered from the receiver's resequencing thread.
+ */
+class LatencyStats {
+public:
+    LatencyStats() : dueTimes_{std::make_unique<TimeArray>()}, sendTimes_{std::make_unique<TimeArray>()}
+    {
+        for (auto& time : *sendTimes_) {
+            time.store(noSendTime, std::memory_order_relaxed);
+        }
+    }
+
+    // Record the time at which the packet with the given SN was due to be sent, and the time of its first
+    // transmission
+    void packetSent(const SequenceNumber sn,
+                    const std::chrono::time_point<ClockType> dueTime,
+                    const std::chrono::time_point<ClockType> txTime) noexcept
+    {
+        (*dueTimes_)[sn].store(dueTime.time_since_epoch().count(), std::memory_order_relaxed);
+        (*sendTimes_)[sn].store(txTime.time_since_epoch().count(), std::memory_order_release);
+    }
+
+    // Record the delay of the packet with the given SN, which was pushed to the output buffer at obTime
+    void packetDelivered(const SequenceNumber sn, const std::chrono::time_point<ClockType> obTime) noexcept
+    {
+        const auto sendTime = (*sendTimes_)[sn].exchange(noSendTime, std::memory_order_acquire);
+        if (sendTime == noSendTime) {
+            ++unmatched_;
+            return;
+        }
+        const auto dueTime = (*dueTimes_)[sn].load(std::memory_order_relaxed);
+        const auto obTimeCount = obTime.time_since_epoch().count();
+        record(histogram_, obTimeCount - dueTime);
+        record(queueingHistogram_, sendTime - dueTime);
+        record(networkHistogram_, obTimeCount - sendTime);
+    }
+
+    // Histograms of end-to-end, queueing and network delays in ns. Only valid once the receiver has stopped.
+    const util::LatencyHistogram& histogram() const noexcept { return histogram_; }
+    const util::LatencyHistogram& queueingHistogram() const noexcept { return queueingHistogram_; }
+    const util::LatencyHistogram& networkHistogram() const noexcept { return networkHistogram_; }
+
+    // Number of delivered packets for which no send time was recorded
+    uint64_t unmatched() const noexcept { return unmatched_; }
+
+    // Print the percentiles p50 to p99.99 of each delay, along with the maximum
+    void printSummary(std::ostream& out) const;
+
+private:
+    static constexpr ClockType::rep noSendTime = std::numeric_limits<ClockType::rep>::min();
+
+    static void record(util::LatencyHistogram& histogram, const ClockType::rep delay) noexcept
+    {
+        histogram.record(static_cast<uint64_t>(std::max<int64_t>(
+            0, std::chrono::duration_cast<std::chrono::nanoseconds>(ClockType::duration(delay)).count())));
+    }
+
+    // Time each SN was due to be sent and first transmitted, indexed by SN
+    using TimeArray = std::array<std::atomic<ClockType::rep>, size_t{MAX_SEQUENCE_NUMBER} + 1>;
+    std::unique_ptr<TimeArray> dueTimes_;
+    std::unique_ptr<TimeArray> sendTimes_;
+
+    util::LatencyHistogram histogram_;
+    util::LatencyHistogram queueingHistogram_;
+    util::LatencyHistogram networkHistogram_;
+    uint64_t unmatched_ = 0;
+};
+
+} // namespace arq
+
+#endif
@@ -0,0 +1,265 @@
+#include "arq/common/message_aggregator.hpp"
+
+#include <netdb.h>
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <utility>
+
+#include "util/logging.hpp"
+
+arq::MessageAggregator::MessageAggregator(ConversationID id,
+                                          SendPacketFn sendPacket,
+                                          std::chrono::microseconds maxDelay,
+                                          size_t mtu) :
+    id_{id},
+    sendPacket_{std::move(sendPacket)},
+    maxDelay_{maxDelay},
+    maxPayloadSize_{maxPayloadSize(mtu)},
+    timerThread_{maxDelay > std::chrono::microseconds::zero() ? std::thread{[this]() { this->timerThread(); }}
+                                                               : std::thread{}}
+{
+}
+
+arq::MessageAggregator::~MessageAggregator()
+{
+    {
+        std::unique_lock lock(mutex_);
+        stop_ = true;
+        flushLocked();
+    }
+    cv_.notify_one();
+    if (timerThread_.joinable()) {
+        timerThread_.join();
+    }
+}
+
+void arq::MessageAggregator::sendMessage(std::span<const std::byte> message)
+{
+    if (message.size() > MAX_MESSAGE_SIZE) {
+        throw DataPacketException(
+            std::format("message of size {} exceeds maximum of {}", message.size(), MAX_MESSAGE_SIZE));
+    }
+
+    std::unique_lock lock(mutex_);
+    if (message.size() > maxAggregatedMessageSize()) {
+        // Keep messages in order by sending those already pending first
+        flushLocked();
+        sendFragmentsLocked(message);
+        return;
+    }
+
+    if (pending_.has_value() && pendingLength_ + sizeof(MessageLength) + message.size() > maxPayloadSize_) {
+        flushLocked();
+    }
+
+    bool newDeadline = false;
+    if (!pending_.has_value()) {
+        pending_.emplace();
+        pending_->updateConversationID(id_);
+        pending_->updateDataLength(maxPayloadSize_);
+        pendingLength_ = 0;
+        deadline_ = ClockType::now() + maxDelay_;
+        newDeadline = true;
+    }
+
+    // Append the length-prefixed message to the payload
+    auto payload = pending_->getPayloadSpan().subspan(pendingLength_);
+    const MessageLength length = htons(static_cast<MessageLength>(message.size()));
+    std::memcpy(payload.data(), &length, sizeof(length));
+    std::memcpy(payload.data() + sizeof(length), message.data(), message.size());
+    pendingLength_ += sizeof(length) + message.size();
+
+    // Don't hold back a packet with no room for another message
+    if (maxDelay_ == std::chrono::microseconds::zero() ||
+        pendingLength_ + sizeof(MessageLength) >= maxPayloadSize_) {
+        flushLocked();
+    }
+    else if (newDeadline) {
+        cv_.notify_one();
+    }
+}
+
+void arq::MessageAggregator::flush()
+{
+    std::unique_lock lock(mutex_);
+    flushLocked();
+}
+
+size_t arq::MessageAggregator::packetsSent() const
+{
+    std::unique_lock lock(mutex_);
+    return packetsSent_;
+}
+
+void arq::MessageAggregator::flushLocked()
+{
+    if (!pending_.has_value()) {
+        return;
+    }
+
+    pending_->updateDataLength(pendingLength_);
+    util::logDebug("Sending aggregated packet with length {}", pendingLength_);
+    sendPacket_(std::move(pending_.value()));
+    ++packetsSent_;
+    pending_.reset();
+    deadline_.reset();
+}
+
+void arq::MessageAggregator::sendFragmentsLocked(std::span<const std::byte> message)
+{
+    for (size_t offset = 0; offset < message.size();) {
+        const bool first = offset == 0;
+        const size_t lengthSize = first ? sizeof(FragmentedMessageLength) : 0;
+        const size_t fragmentSize = std::min(message.size() - offset, maxPayloadSize_ - lengthSize);
+
+        DataPacket fragment;
+        fragment.updateConversationID(id_);
+        fragment.updateDataLength(lengthSize + fragmentSize);
+        auto payload = fragment.getPayloadSpan();
+        if (first) {
+            const FragmentedMessageLength length = htonl(static_cast<FragmentedMessageLength>(message.size()));
+            std::memcpy(payload.data(), &length, sizeof(length));
+        }
+        std::memcpy(payload.data() + lengthSize, message.data() + offset, fragmentSize);
+        offset += fragmentSize;
+        fragment.updateFlags((first ? FIRST_FRAGMENT : 0) | (offset == message.size() ? LAST_FRAGMENT : 0));
+
+        sendPacket_(std::move(fragment));
+        ++packetsSent_;
+    }
+    util::logDebug("Sent message of length {} as fragments", message.size());
+}
+
+void arq::MessageAggregator::timerThread()
+{
+    std::unique_lock lock(mutex_);
+    while (!stop_) {
+        if (!deadline_.has_value()) {
+            cv_.wait(lock);
+        }
+        else if (ClockType::now() >= deadline_.value()) {
+            flushLocked();
+        }
+        else {
+            cv_.wait_until(lock, deadline_.value());
+        }
+    }
+}
+
+std::optional<std::span<const std::byte>> arq::MessageUnpacker::tryGetMessage()
+{
+    while (!endOfTx_) {
+        if (current_.has_value()) {
+            if (auto message = nextAggregatedMessage(); message.has_value()) {
+                return message;
+            }
+            current_.reset();
+        }
+
+        current_ = getPacket_();
+        if (!current_.has_value()) {
+            return std::nullopt;
+        }
+        offset_ = 0;
+
+        const auto& packet = current_->packet_;
+        if (packet.isEndOfTx()) {
+            if (messageLength_.has_value()) {
+                util::logError("Discarding incomplete message of length {} at end of Tx", messageLength_.value());
+            }
+            endOfTx_ = true;
+            current_.reset();
+            break;
+        }
+
+        ++packetsReceived_;
+        if (packet.getHeader().flags_ != UNFRAGMENTED) {
+            auto message = addFragment(packet);
+            current_.reset();
+            if (message.has_value()) {
+                return message;
+            }
+        }
+        else if (messageLength_.has_value()) {
+            util::logError("Discarding incomplete message of length {} interrupted by SN {}",
+                           messageLength_.value(),
+                           packet.getHeader().sequenceNumber_);
+            messageLength_.reset();
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::span<const std::byte>> arq::MessageUnpacker::nextAggregatedMessage()
+{
+    const auto payload = current_->packet_.getPayloadReadSpan();
+    if (offset_ + sizeof(MessageLength) <= payload.size()) {
+        MessageLength length;
+        std::memcpy(&length, payload.data() + offset_, sizeof(length));
+        length = ntohs(length);
+        const auto start = offset_ + sizeof(length);
+        if (start + length <= payload.size()) {
+            offset_ = start + length;
+            return payload.subspan(start, length);
+        }
+        util::logError("Discarding malformed message of length {} in packet with SN {}",
+                       length,
+                       current_->packet_.getHeader().sequenceNumber_);
+    }
+    else if (offset_ != payload.size()) {
+        util::logError("Discarding {} trailing bytes in packet with SN {}",
+                       payload.size() - offset_,
+                       current_->packet_.getHeader().sequenceNumber_);
+    }
+    return std::nullopt;
+}
+
+std::optional<std::span<const std::byte>> arq::MessageUnpacker::addFragment(const DataPacket& fragment)
+{
+    const auto hdr = fragment.getHeader();
+    auto payload = fragment.getPayloadReadSpan();
+
+    if (hdr.flags_ & FIRST_FRAGMENT) {
+        if (messageLength_.has_value()) {
+            util::logError("Discarding incomplete message of length {} interrupted by SN {}",
+                           messageLength_.value(),
+                           hdr.sequenceNumber_);
+            messageLength_.reset();
+        }
+        if (payload.size() < sizeof(FragmentedMessageLength)) {
+            util::logError("Discarding first fragment with SN {} which is too short", hdr.sequenceNumber_);
+            return std::nullopt;
+        }
+
+        FragmentedMessageLength length;
+        std::memcpy(&length, payload.data(), sizeof(length));
+        messageLength_ = ntohl(length);
+        payload = payload.subspan(sizeof(length));
+        message_.clear();
+        message_.reserve(messageLength_.value());
+    }
+    else if (!messageLength_.has_value()) {
+        util::logError("Discarding fragment with SN {} which has no first fragment", hdr.sequenceNumber_);
+        return std::nullopt;
+    }
+
+    if (message_.size() + payload.size() > messageLength_.value()) {
+        util::logError("Discarding message of length {} which overran by fragment with SN {}",
+                       messageLength_.value(),
+                       hdr.sequenceNumber_);
+        messageLength_.reset();
+        return std::nullopt;
+    }
+    message_.insert(message_.end(), payload.begin(), payload.end());
+
+    if (hdr.flags_ & LAST_FRAGMENT) {
+        const auto length = std::exchange(messageLength_, std::nullopt).value();
+        if (message_.size() != length) {
+            util::logError("Discarding message of length {} which ended after {} bytes", length, message_.size());
+            return std::nullopt;
+        }
+        return message_;
+    }
+    return std::nullopt;
+}
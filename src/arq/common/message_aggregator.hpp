@@ -0,0 +1,142 @@
+#ifndef _ARQ_COMMON_MESSAGE_AGGREGATOR_HPP_
+#define _ARQ_COMMON_MESSAGE_AGGREGATOR_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "arq/common/arq_common.hpp"
+#include "arq/common/conversation_id.hpp"
+#include "arq/common/data_packet.hpp"
+#include "arq/common/rx_buffer_object.hpp"
+
+namespace arq {
+
+// Each message in an aggregated payload is preceded by its length, as a 16-bit integer in network byte order
+using MessageLength = uint16_t;
+
+// The first fragment of a larger message begins with the message's total length, as a 32-bit integer in network byte
+// order, so that the receiver can allocate the whole message up front
+using FragmentedMessageLength = uint32_t;
+
+// Largest message which can be sent
+constexpr size_t MAX_MESSAGE_SIZE = std::numeric_limits<FragmentedMessageLength>::max();
+
+/*
+ * Packs small messages into DataPackets in front of a transmitter's input buffer, so that many messages share the
+ * header, syscall and ACK overhead of one packet. A packet is sent once the next message will not fit in it, or once
+ * its first message has waited maxDelay, whichever comes first. A maxDelay of zero sends each message immediately in a
+ * packet of its own.
+ *
+ * Packets are filled up to the session's MTU. Messages larger than maxAggregatedMessageSize() are instead sent straight
+ * away, fragmented across as many packets as needed with consecutive SNs, after any pending messages. Each fragment is
+ * marked with DataPacketFlags.
+ *
+ * The delay is enforced by a timer thread, so sendPacket may be called from either the thread calling sendMessage or
+ * the timer thread, but never from both at once.
+ */
+class MessageAggregator {
+public:
+    using SendPacketFn = std::function<void(DataPacket&&)>;
+
+    MessageAggregator(ConversationID id,
+                      SendPacketFn sendPacket,
+                      std::chrono::microseconds maxDelay,
+                      size_t mtu = DEFAULT_MTU);
+    MessageAggregator(const MessageAggregator&) = delete;
+    MessageAggregator& operator=(const MessageAggregator&) = delete;
+    // Sends any pending messages
+    ~MessageAggregator();
+
+    // Queue a message for transmission, or fragment and send it if too large to share a packet. Throws
+    // DataPacketException if the message is larger than MAX_MESSAGE_SIZE.
+    void sendMessage(std::span<const std::byte> message);
+    // Send any pending messages without waiting for the delay to expire
+    void flush();
+
+    // Number of packets passed to sendPacket
+    size_t packetsSent() const;
+
+    // Largest message which fits in a single DataPacket, alongside other messages
+    size_t maxAggregatedMessageSize() const noexcept { return maxPayloadSize_ - sizeof(MessageLength); }
+
+private:
+    // Sends the pending packet, if any. The mutex must be held.
+    void flushLocked();
+    // Sends a message as a series of fragments. The mutex must be held.
+    void sendFragmentsLocked(std::span<const std::byte> message);
+    void timerThread();
+
+    // Identifies the current conversation
+    ConversationID id_;
+    // Function to which each packet is passed once full or timed out
+    SendPacketFn sendPacket_;
+    // Longest time for which a message may wait for others to share its packet
+    std::chrono::microseconds maxDelay_;
+    // Largest payload of a packet which fits in the MTU
+    const size_t maxPayloadSize_;
+    // Protects all of the below
+    mutable std::mutex mutex_;
+    // Notifies the timer thread of a new deadline or that it should stop
+    std::condition_variable cv_;
+    // Packet to which messages are being added, whose payload is sized to hold as many as possible until it is sent
+    std::optional<DataPacket> pending_;
+    // Bytes of the pending packet's payload used so far
+    size_t pendingLength_ = 0;
+    // Time by which the pending packet must be sent
+    std::optional<std::chrono::time_point<ClockType>> deadline_;
+    size_t packetsSent_ = 0;
+    bool stop_ = false;
+    std::thread timerThread_;
+};
+
+/*
+ * Splits the packets produced by a MessageAggregator back into messages on the receive side of an output buffer, and
+ * reassembles fragmented messages into a single buffer, allocated when the first fragment arrives. Packets are fetched
+ * from getPacket, which may either block or return std::nullopt if no packet is available.
+ */
+class MessageUnpacker {
+public:
+    using GetPacketFn = std::function<std::optional<ReceiveBufferObject>()>;
+
+    explicit MessageUnpacker(GetPacketFn getPacket) : getPacket_{std::move(getPacket)} {}
+
+    // Get the next message, if one is available. The message remains valid until the next call. Returns std::nullopt
+    // once the EoT packet has been received.
+    std::optional<std::span<const std::byte>> tryGetMessage();
+
+    // Has the EoT packet been received?
+    bool endOfTx() const noexcept { return endOfTx_; }
+
+    // Number of data packets from which messages have been unpacked
+    size_t packetsReceived() const noexcept { return packetsReceived_; }
+
+private:
+    // Get the next of the messages aggregated in the current packet, if any
+    std::optional<std::span<const std::byte>> nextAggregatedMessage();
+    // Add a fragment to the message being reassembled, returning the message if it is complete
+    std::optional<std::span<const std::byte>> addFragment(const DataPacket& fragment);
+
+    GetPacketFn getPacket_;
+    // Packet from which messages are currently being read
+    std::optional<ReceiveBufferObject> current_;
+    // Offset of the next message's length in the current packet's payload
+    size_t offset_ = 0;
+    // Fragments of the message being reassembled, which is complete once it reaches messageLength_
+    std::vector<std::byte> message_;
+    // If a fragmented message is being reassembled, its total length
+    std::optional<size_t> messageLength_;
+    size_t packetsReceived_ = 0;
+    bool endOfTx_ = false;
+};
+
+} // namespace arq
+
+#endif
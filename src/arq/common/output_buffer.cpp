@@ -1,10 +1,20 @@
 #include "arq/common/output_buffer.hpp"
 
+#include <algorithm>
+
+#include "arq/common/control_packet.hpp"
 #include "util/logging.hpp"
+#include "util/trace.hpp"
+
+arq::OutputBuffer::OutputBuffer(size_t capacity) : capacity_{std::max<size_t>(capacity, 1)} {}
 
 bool arq::OutputBuffer::addPacket(arq::DataPacket&& packet)
 {
     const auto hdr = packet.getHeader();
+    if (full()) {
+        util::logDebug("OB rejected packet with SN {} as it is full", hdr.sequenceNumber_);
+        return false;
+    }
     if (hdr.sequenceNumber_ == nextSequenceNumber_) {
         ++nextSequenceNumber_;
     }
@@ -12,9 +22,12 @@ bool arq::OutputBuffer::addPacket(arq::DataPacket&& packet)
         util::logDebug("OB rejected packet with SN {} (expected {})", hdr.sequenceNumber_, nextSequenceNumber_);
         return false;
     }
-    arq::ReceiveBufferObject temp{.packet_ = std::move(packet), .rxTime_ = ClockType::now()};
+    // Prefer the time at which the packet arrived, if known, to the time at which it was delivered
+    const auto pushTime = ClockType::now();
+    const auto rxTime = packet.rxTime().value_or(pushTime);
+    arq::ReceiveBufferObject temp{.packet_ = std::move(packet), .rxTime_ = rxTime};
 
-    std::println("Pushed packet with SN {} to OB at time {}", hdr.sequenceNumber_, temp.rxTime_);
+    util::trace(util::TraceEvent::OUTPUT_BUFFER_PUSH, hdr.id_, hdr.sequenceNumber_, pushTime);
 
     // Add packet to buffer
     outputPackets_.push(std::move(temp));
@@ -29,4 +42,15 @@ arq::ReceiveBufferObject arq::OutputBuffer::getPacket()
 std::optional<arq::ReceiveBufferObject> arq::OutputBuffer::tryGetPacket()
 {
     return outputPackets_.try_pop();
-}
\ No newline at end of file
+}
+
+uint16_t arq::OutputBuffer::receiveWindow(const SequenceNumber ackedSn) const
+{
+    // SNs wrap, so the count of acknowledged packets yet to be added is taken modulo the SN space
+    const size_t ackedNotAdded = static_cast<SequenceNumber>(ackedSn + 1 - nextSequenceNumber_);
+    const size_t used = size() + ackedNotAdded;
+    if (used >= capacity_) {
+        return 0;
+    }
+    return static_cast<uint16_t>(std::min<size_t>(capacity_ - used, UNLIMITED_RECEIVE_WINDOW));
+}
@@ -1,6 +1,8 @@
 #ifndef _ARQ_COMMON_OUTPUT_BUFFER_HPP_
 #define _ARQ_COMMON_OUTPUT_BUFFER_HPP_
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 
 #include "arq/common/rx_buffer_object.hpp"
@@ -8,9 +10,16 @@
 
 namespace arq {
 
+// Packets an output buffer holds by default before the receiver stops delivering to it
+constexpr size_t DEFAULT_OUTPUT_BUFFER_CAPACITY = 4096;
+// For transports with flow control of their own, such as SCTP
+constexpr size_t UNBOUNDED_OUTPUT_BUFFER = SIZE_MAX;
+
 class OutputBuffer {
 public:
-    // Submit a packet for output - reject if not the next in sequence
+    explicit OutputBuffer(size_t capacity = DEFAULT_OUTPUT_BUFFER_CAPACITY);
+
+    // Submit a packet for output - reject if not the next in sequence, or if the buffer is full
     bool addPacket(arq::DataPacket&& packet);
 
     // Get next packet for output from the buffer. If the buffer is empty, wait until a packet is available
@@ -19,7 +28,24 @@ public:
     // If a packet is available, get the next packet from the buffer.
     std::optional<ReceiveBufferObject> tryGetPacket();
 
+    // Number of packets waiting to be output
+    size_t size() const { return outputPackets_.size(); }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+    bool full() const { return size() >= capacity_; }
+
+    // The next SN to be accepted for addition to the output buffer
+    SequenceNumber nextSequenceNumber() const noexcept { return nextSequenceNumber_; }
+
+    // Number of packets following ackedSn for which the buffer has room, after the packets up to and including ackedSn
+    // which are yet to be added. ackedSn must not precede the SN before nextSequenceNumber(), and this must be called
+    // from the thread adding packets.
+    uint16_t receiveWindow(SequenceNumber ackedSn) const;
+
 private:
+    // Maximum number of packets held for output
+    const size_t capacity_;
     // Packets for output from the receiver
     util::SafeQueue<ReceiveBufferObject> outputPackets_;
     // The next SN to be accepted for addition to the output buffer
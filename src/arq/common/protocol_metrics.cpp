@@ -0,0 +1,55 @@
+#include "arq/common/protocol_metrics.hpp"
+
+#include <string>
+
+static util::MetricLabels conversationLabels(const arq::ConversationID id)
+{
+    return {{"conversation", std::to_string(id)}};
+}
+
+arq::TransmitterMetrics::TransmitterMetrics(ConversationID id, util::MetricsRegistry& registry) :
+    packetsSent_{registry.counter("arq_packets_sent_total", "New data packets transmitted", conversationLabels(id))},
+    timeoutRetransmissions_{registry.counter("arq_retransmissions_total",
+                                             "Data packets retransmitted",
+                                             {{"conversation", std::to_string(id)}, {"reason", "timeout"}})},
+    acksReceived_{
+        registry.counter("arq_acks_received_total", "ACKs received by the transmitter", conversationLabels(id))},
+    windowOccupancy_{registry.gauge(
+        "arq_rt_window_occupancy", "Packets awaiting acknowledgement in the RT buffer", conversationLabels(id))},
+    rtoMicroseconds_{
+        registry.gauge("arq_rto_microseconds", "Retransmission timeout of the RT buffer", conversationLabels(id))},
+    rttMicroseconds_{
+        registry.gauge("arq_rtt_microseconds", "Latest round trip time sampled from an ACK", conversationLabels(id))},
+    receiveWindow_{registry.gauge(
+        "arq_receive_window", "Latest receive window advertised by the receiver", conversationLabels(id))},
+    rtBufferBytes_{registry.gauge("arq_rt_buffer_bytes", "Memory held by the RT buffer", conversationLabels(id))},
+    inputBufferDepth_{
+        registry.gauge("arq_input_buffer_depth", "Packets waiting in the input buffer", conversationLabels(id))},
+    inputBufferFull_{registry.counter(
+        "arq_input_buffer_full_total", "Packets refused because the input buffer was full", conversationLabels(id))},
+    ackQueueDepth_{registry.gauge(
+        "arq_transmitter_ack_queue_depth", "ACKs waiting to be processed by the transmitter", conversationLabels(id))}
+{
+}
+
+arq::ReceiverMetrics::ReceiverMetrics(ConversationID id, util::MetricsRegistry& registry) :
+    packetsReceived_{
+        registry.counter("arq_packets_received_total", "Data packets received", conversationLabels(id))},
+    duplicatePackets_{registry.counter(
+        "arq_duplicate_packets_total", "Data packets received more than once", conversationLabels(id))},
+    outOfWindowPackets_{registry.counter("arq_out_of_window_drops_total",
+                                         "Data packets dropped for being ahead of the RS window",
+                                         conversationLabels(id))},
+    receiveWindowDrops_{registry.counter("arq_receive_window_drops_total",
+                                         "Data packets dropped for being beyond the advertised receive window",
+                                         conversationLabels(id))},
+    corruptPackets_{registry.counter(
+        "arq_corrupt_packets_total", "Data packets dropped for failing their checksum", conversationLabels(id))},
+    acksSent_{registry.counter("arq_acks_sent_total", "ACKs sent by the receiver", conversationLabels(id))},
+    rsBufferBytes_{registry.gauge("arq_rs_buffer_bytes", "Memory held by the RS buffer", conversationLabels(id))},
+    outputBufferDepth_{
+        registry.gauge("arq_output_buffer_depth", "Packets waiting in the output buffer", conversationLabels(id))},
+    ackQueueDepth_{registry.gauge(
+        "arq_receiver_ack_queue_depth", "ACKs waiting to be sent by the receiver", conversationLabels(id))}
+{
+}
@@ -0,0 +1,56 @@
+#ifndef _ARQ_COMMON_PROTOCOL_METRICS_HPP_
+#define _ARQ_COMMON_PROTOCOL_METRICS_HPP_
+
+#include "arq/common/conversation_id.hpp"
+#include "util/metrics.hpp"
+
+namespace arq {
+
+// Metrics updated by a Transmitter and its RT buffer, labelled with the conversation ID.
+struct TransmitterMetrics {
+    explicit TransmitterMetrics(ConversationID id, util::MetricsRegistry& registry = util::MetricsRegistry::global());
+
+    // New packets transmitted from the input buffer
+    util::Counter& packetsSent_;
+    // Packets retransmitted from the RT buffer because their timeout elapsed
+    util::Counter& timeoutRetransmissions_;
+    util::Counter& acksReceived_;
+    // Packets held in the RT buffer awaiting acknowledgement
+    util::Gauge& windowOccupancy_;
+    // Retransmission timeout of the RT buffer
+    util::Gauge& rtoMicroseconds_;
+    // Latest round trip time sampled from an ACK
+    util::Gauge& rttMicroseconds_;
+    // Latest receive window advertised by the receiver
+    util::Gauge& receiveWindow_;
+    // Memory held by the RT buffer
+    util::Gauge& rtBufferBytes_;
+    util::Gauge& inputBufferDepth_;
+    // Packets refused because the input buffer was full
+    util::Counter& inputBufferFull_;
+    util::Gauge& ackQueueDepth_;
+};
+
+// Metrics updated by a Receiver and its RS buffer, labelled with the conversation ID.
+struct ReceiverMetrics {
+    explicit ReceiverMetrics(ConversationID id, util::MetricsRegistry& registry = util::MetricsRegistry::global());
+
+    util::Counter& packetsReceived_;
+    // Packets received that had already been received
+    util::Counter& duplicatePackets_;
+    // Packets rejected because they were ahead of the RS buffer's window
+    util::Counter& outOfWindowPackets_;
+    // Packets dropped because the output buffer had no room for them
+    util::Counter& receiveWindowDrops_;
+    // Packets dropped because their checksum did not match their contents
+    util::Counter& corruptPackets_;
+    util::Counter& acksSent_;
+    // Memory held by the RS buffer
+    util::Gauge& rsBufferBytes_;
+    util::Gauge& outputBufferDepth_;
+    util::Gauge& ackQueueDepth_;
+};
+
+} // namespace arq
+
+#endif
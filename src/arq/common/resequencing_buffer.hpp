@@ -8,6 +8,7 @@
 
 #include "arq/common/data_packet.hpp"
 #include "arq/common/sequence_number.hpp"
+#include "util/metrics.hpp"
 
 namespace arq {
 namespace rs {
@@ -28,6 +29,21 @@ template <typename T>
 concept has_getNextPacket = requires(T t) {
     { t.do_getNextPacket() } -> std::same_as<std::optional<DataPacket>>;
 };
+
+template <typename T>
+concept has_memoryUsage = requires(T t) {
+    { t.do_memoryUsage() } -> std::same_as<size_t>;
+};
+
+template <typename T>
+concept has_prefault = requires(T t) {
+    { t.do_prefault() } -> std::same_as<void>;
+};
+
+template <typename T>
+concept has_localise = requires(T t) {
+    { t.do_localise() } -> std::same_as<void>;
+};
 // clang-format on
 } // namespace rs
 
@@ -59,6 +75,54 @@ public:
 
     // Retrieve the next packet from the buffer. If no packet is available, block until one is.
     std::optional<DataPacket> getNextPacket() { return static_cast<T*>(this)->do_getNextPacket(); }
+
+    // Bytes of memory held by the resequencing buffer, excluding packets awaiting delivery to the OB. Buffers which do
+    // not allocate storage for their window report only their own size.
+    size_t memoryUsage() const
+    {
+        if constexpr (rs::has_memoryUsage<T>) {
+            return static_cast<const T*>(this)->do_memoryUsage();
+        }
+        else {
+            return sizeof(T);
+        }
+    }
+
+    // Allocates storage for the whole window up front. Buffers which do not allocate storage for their window need
+    // not implement this.
+    void prefault()
+    {
+        if constexpr (rs::has_prefault<T>) {
+            static_cast<T*>(this)->do_prefault();
+        }
+    }
+
+    // Reallocates the window storage allocated at construction from the calling thread, so that a thread pinned after
+    // the buffer was constructed has it placed on its local NUMA node. Buffers which do not allocate storage for their
+    // window need not implement this.
+    void localise()
+    {
+        if constexpr (rs::has_localise<T>) {
+            static_cast<T*>(this)->do_localise();
+        }
+    }
+
+    // Set the counters incremented when a packet is rejected. Must be called from the thread adding packets.
+    void attachMetrics(util::Counter& duplicatePackets, util::Counter& outOfWindowPackets) noexcept
+    {
+        duplicatePackets_ = &duplicatePackets;
+        outOfWindowPackets_ = &outOfWindowPackets;
+    }
+
+protected:
+    // Packets which have already been received
+    util::Counter* duplicatePackets_ = &unattachedCounter_;
+    // Packets which are ahead of the window of packets the buffer can accept
+    util::Counter* outOfWindowPackets_ = &unattachedCounter_;
+
+private:
+    // Until metrics are attached, rejected packets are counted here and never exported
+    static inline util::Counter unattachedCounter_;
 };
 
 } // namespace arq
@@ -1,6 +1,9 @@
 #ifndef _ARQ_COMMON_RETRANSMISSION_BUFFER_HPP_
 #define _ARQ_COMMON_RETRANSMISSION_BUFFER_HPP_
 
+#include <algorithm>
+
+#include "arq/common/control_packet.hpp"
 #include "arq/common/tx_buffer_object.hpp"
 
 namespace arq {
@@ -28,6 +31,31 @@ concept has_packetsPending = requires(T t) {
     { t.do_packetsPending() } -> std::same_as<bool>;
 };
 
+template <typename T>
+concept has_packetCount = requires(T t) {
+    { t.do_packetCount() } -> std::same_as<size_t>;
+};
+
+template <typename T>
+concept has_memoryUsage = requires(T t) {
+    { t.do_memoryUsage() } -> std::same_as<size_t>;
+};
+
+template <typename T>
+concept has_prefault = requires(T t) {
+    { t.do_prefault() } -> std::same_as<void>;
+};
+
+template <typename T>
+concept has_localise = requires(T t) {
+    { t.do_localise() } -> std::same_as<void>;
+};
+
+template <typename T>
+concept has_unambiguousTxTime = requires(const T t, const SequenceNumber seqNum) {
+    { t.do_unambiguousTxTime(seqNum) } -> std::same_as<std::optional<std::chrono::time_point<ClockType>>>;
+};
+
 template <typename T>
 concept has_acknowledgePacket = requires(T t, const SequenceNumber seqNum) {
     { t.do_acknowledgePacket(seqNum) } -> std::same_as<void>;
@@ -51,6 +79,7 @@ public:
         static_assert(rt::has_tryGetPacketSpan<T>);
         static_assert(rt::has_readyForNewPacket<T>);
         static_assert(rt::has_packetsPending<T>);
+        static_assert(rt::has_packetCount<T>);
         static_assert(rt::has_acknowledgePacket<T>);
     }
 
@@ -63,14 +92,80 @@ public:
         return static_cast<T*>(this)->do_tryGetPacketSpan();
     }
 
-    // Can another packet be added to the retransmission buffer?
-    bool readyForNewPacket() const { return static_cast<const T*>(this)->do_readyForNewPacket(); }
+    // Can another packet be added to the retransmission buffer? Packets in flight are limited to the receive window
+    // as well as the buffer's own window. While the receive window is zero, a single packet is still let through as a
+    // zero-window probe: it is retransmitted on timeout like any other, and the ACK each copy elicits carries the
+    // receiver's current window, so the transfer resumes once the receiver has room even if a window update is lost.
+    bool readyForNewPacket() const
+    {
+        return static_cast<const T*>(this)->do_readyForNewPacket() &&
+               packetCount() < std::max<size_t>(receiveWindow_, 1);
+    }
+
+    // Record the receive window advertised by the latest ACK, i.e. the number of packets following the acknowledged
+    // SN which the receiver has room for
+    void updateReceiveWindow(const uint16_t receiveWindow) noexcept { receiveWindow_ = receiveWindow; }
+
+    // The receive window last advertised by the receiver
+    uint16_t receiveWindow() const noexcept { return receiveWindow_; }
 
     // Are there any packets in the retransmission buffer currently?
     bool packetsPending() const { return static_cast<const T*>(this)->do_packetsPending(); }
 
-    // Update tracking information for a packet which has just been acknowledged
-    void acknowledgePacket(const SequenceNumber seqNum) { static_cast<T*>(this)->do_acknowledgePacket(seqNum); }
+    // How many packets are in the retransmission buffer currently?
+    size_t packetCount() const { return static_cast<const T*>(this)->do_packetCount(); }
+
+    // Bytes of memory held by the retransmission buffer. Buffers which do not allocate storage for their window report
+    // only their own size.
+    size_t memoryUsage() const
+    {
+        if constexpr (rt::has_memoryUsage<T>) {
+            return static_cast<const T*>(this)->do_memoryUsage();
+        }
+        else {
+            return sizeof(T);
+        }
+    }
+
+    // Allocates storage for the whole window up front. Buffers which do not allocate storage for their window need
+    // not implement this.
+    void prefault()
+    {
+        if constexpr (rt::has_prefault<T>) {
+            static_cast<T*>(this)->do_prefault();
+        }
+    }
+
+    // Reallocates the window storage allocated at construction from the calling thread, so that a thread pinned after
+    // the buffer was constructed has it placed on its local NUMA node. Buffers which do not allocate storage for their
+    // window need not implement this.
+    void localise()
+    {
+        if constexpr (rt::has_localise<T>) {
+            static_cast<T*>(this)->do_localise();
+        }
+    }
+
+    // Time after which an unacknowledged packet is retransmitted
+    std::chrono::microseconds timeoutInterval() const noexcept { return timeoutInterval_; }
+
+    // Update tracking information for a packet which has just been acknowledged by an ACK that arrived at ackTime.
+    // Returns a round trip time sample if the buffer can tell when the packet was transmitted. Buffers which track
+    // transmission times implement do_unambiguousTxTime, which must not return a time for a retransmitted packet,
+    // since its ACK may belong to any of its transmissions (Karn's algorithm).
+    std::optional<std::chrono::microseconds> acknowledgePacket(
+        const SequenceNumber seqNum, const std::chrono::time_point<ClockType> ackTime = ClockType::now())
+    {
+        std::optional<std::chrono::microseconds> rttSample;
+        if constexpr (rt::has_unambiguousTxTime<T>) {
+            const auto txTime = static_cast<const T*>(this)->do_unambiguousTxTime(seqNum);
+            if (txTime.has_value() && txTime.value() <= ackTime) {
+                rttSample = std::chrono::duration_cast<std::chrono::microseconds>(ackTime - txTime.value());
+            }
+        }
+        static_cast<T*>(this)->do_acknowledgePacket(seqNum);
+        return rttSample;
+    }
 
 protected:
     // Has the timeout interval elapsed since this packet was last transmitted?
@@ -82,6 +177,9 @@ protected:
         return timeSinceLastTx.count() > timeoutInterval_.count();
     }
     const std::chrono::microseconds timeoutInterval_;
+
+private:
+    uint16_t receiveWindow_ = UNLIMITED_RECEIVE_WINDOW;
 };
 
 } // namespace arq
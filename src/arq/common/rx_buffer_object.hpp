@@ -12,7 +12,8 @@ struct ReceiveBufferObject {
     // Packet held in the OutputBuffer
     DataPacket packet_;
 
-    // The time at which the packet was received
+    // The time at which the packet was received, as timestamped by the kernel if the receive function reports it,
+    // otherwise the time at which it was pushed to the OutputBuffer
     std::chrono::time_point<ClockType> rxTime_;
 };
 
@@ -12,6 +12,13 @@ constexpr SequenceNumber FIRST_SEQUENCE_NUMBER = 0;
 // WJG: to allow roll-over SNs
 constexpr SequenceNumber MAX_SEQUENCE_NUMBER = __UINT16_MAX__;
 
+// SNs wrap, so an SN precedes another if it falls in the half of the SN space before it
+constexpr bool precedes(const SequenceNumber seqNum, const SequenceNumber other) noexcept
+{
+    const SequenceNumber distance = other - seqNum;
+    return distance != 0 && distance <= MAX_SEQUENCE_NUMBER / 2;
+}
+
 // Serialises sequenceNumber to the buffer
 bool serialiseSeqNum(const SequenceNumber sequenceNumber, std::span<std::byte> buffer) noexcept;
 
@@ -0,0 +1,107 @@
+#include "arq/common/transmit_window.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <format>
+
+arq::TransmitWindow::TransmitWindow(const uint16_t windowSize, const SequenceNumber firstSeqNum, const size_t mtu) :
+    windowSize_{windowSize},
+    mask_{std::bit_ceil(static_cast<size_t>(windowSize)) - 1},
+    mtu_{mtu},
+    occupied_{mask_ + 1},
+    lastTxTimes_(mask_ + 1),
+    firstTxTimes_(mask_ + 1),
+    retransmitCounts_(mask_ + 1),
+    packetLengths_(mask_ + 1),
+    payloadArena_{(mask_ + 1) * mtu, std::min(mask_ + 1, util::OccupancyBitmap::bitsPerWord) * mtu},
+    start_{firstSeqNum}
+{
+    assert(windowSize > 0);
+    assert(mtu > DataPacketHeader::size() && mtu <= MAX_SUPPORTED_MTU);
+}
+
+void arq::TransmitWindow::localise()
+{
+    // Copying allocates and first touches the new storage on the calling thread
+    occupied_.localise();
+    lastTxTimes_ = std::vector<TimePoint>(lastTxTimes_);
+    firstTxTimes_ = std::vector<TimePoint>(firstTxTimes_);
+    retransmitCounts_ = std::vector<uint16_t>(retransmitCounts_);
+    packetLengths_ = std::vector<uint16_t>(packetLengths_);
+    payloadArena_.localise();
+}
+
+bool arq::TransmitWindow::insert(const TransmitBufferObject& packet)
+{
+    const auto seqNum = packet.info_.sequenceNumber_;
+    const auto idx = slot(seqNum);
+    if (!contains(seqNum) || occupied_.test(idx)) {
+        return false;
+    }
+
+    const auto data = packet.packet_.getReadSpan();
+    if (data.size() > mtu_) {
+        throw ArqProtocolException(
+            std::format("packet with SN {} of size {} exceeds the MTU of {}", seqNum, data.size(), mtu_));
+    }
+    // Allocating the slot's first byte allocates its page, which holds the whole slot
+    std::ranges::copy(data, &payloadArena_.allocate(arenaOffset(idx)));
+
+    packetLengths_[idx] = data.size();
+    lastTxTimes_[idx] = packet.info_.lastTxTime_;
+    firstTxTimes_[idx] = packet.info_.firstTxTime_;
+    retransmitCounts_[idx] = 0;
+    occupied_.set(idx);
+    return true;
+}
+
+size_t arq::TransmitWindow::releaseUntil(const SequenceNumber seqNum)
+{
+    const auto toRelease = offset(seqNum);
+    assert(toRelease <= windowSize_);
+
+    const auto countBefore = count();
+    for (size_t i = 0; i < toRelease; ++i) {
+        const auto idx = slot(start_ + i);
+        occupied_.reset(idx);
+        if (occupied_.wordEmpty(idx)) {
+            payloadArena_.releasePage(arenaOffset(idx));
+        }
+    }
+    start_ = seqNum;
+    return countBefore - count();
+}
+
+std::optional<arq::SequenceNumber> arq::TransmitWindow::findLastTxBefore(const TimePoint deadline) const noexcept
+{
+    // Visit the occupied slots in SN order, starting from the beginning of the window
+    size_t idx = slot(start_);
+    for (size_t visited = 0; visited < count(); ++visited) {
+        idx = occupied_.findNextSet(idx).value();
+        if (lastTxTimes_[idx] < deadline) {
+            return static_cast<SequenceNumber>(start_ + ((idx - start_) & mask_));
+        }
+        idx = (idx + 1) & mask_;
+    }
+    return std::nullopt;
+}
+
+std::span<const std::byte> arq::TransmitWindow::retransmit(const SequenceNumber seqNum, const TimePoint now) noexcept
+{
+    const auto idx = slot(seqNum);
+    assert(contains(seqNum) && occupied_.test(idx));
+
+    lastTxTimes_[idx] = now;
+    ++retransmitCounts_[idx];
+    return std::span{&payloadArena_[arenaOffset(idx)], packetLengths_[idx]};
+}
+
+size_t arq::TransmitWindow::memoryUsage() const noexcept
+{
+    const auto metadataBytes = lastTxTimes_.capacity() * sizeof(TimePoint) +
+                               firstTxTimes_.capacity() * sizeof(TimePoint) +
+                               retransmitCounts_.capacity() * sizeof(uint16_t) +
+                               packetLengths_.capacity() * sizeof(uint16_t) + occupied_.words().size_bytes();
+    return metadataBytes + payloadArena_.memoryUsage();
+}
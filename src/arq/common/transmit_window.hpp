@@ -0,0 +1,113 @@
+#ifndef _ARQ_COMMON_TRANSMIT_WINDOW_HPP_
+#define _ARQ_COMMON_TRANSMIT_WINDOW_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "arq/common/tx_buffer_object.hpp"
+#include "util/occupancy_bitmap.hpp"
+#include "util/paged_array.hpp"
+
+namespace arq {
+
+/*
+ * The sliding window of transmitted packets held by the windowed RT buffers. Like CircularWindow, slots are keyed by
+ * SN with a power-of-two mask, but the contents are laid out as a structure of arrays. The per-packet metadata is held
+ * in dense parallel arrays, so a timeout scan reads a few KB of timestamps rather than chasing a pointer per packet,
+ * while the serialised packets are copied into an arena with a stride of one MTU, which is fixed for the session.
+ *
+ * The metadata is small and stays allocated for the whole window. The arena, which accounts for almost all of the
+ * window's memory, is paged like CircularWindow's storage, so it grows with the packets in flight and shrinks again as
+ * they are acknowledged.
+ */
+class TransmitWindow {
+public:
+    using TimePoint = std::chrono::time_point<ClockType>;
+
+    TransmitWindow(const uint16_t windowSize, const SequenceNumber firstSeqNum, const size_t mtu = DEFAULT_MTU);
+
+    // The earliest SN in the window
+    SequenceNumber start() const noexcept { return start_; }
+
+    uint16_t windowSize() const noexcept { return windowSize_; }
+
+    // The size of the largest packet which may be inserted
+    size_t mtu() const noexcept { return mtu_; }
+
+    // The number of packets in the window
+    size_t count() const noexcept { return occupied_.count(); }
+
+    bool empty() const noexcept { return count() == 0; }
+
+    bool full() const noexcept { return count() == windowSize_; }
+
+    // Bytes of memory allocated for the window's storage
+    size_t memoryUsage() const noexcept;
+
+    // Allocates storage for the whole window up front, so that no page faults occur as the window fills
+    void prefault() { payloadArena_.prefault(); }
+
+    // Reallocates the storage allocated when the window was constructed from the calling thread, so that it is placed
+    // according to that thread's memory policy
+    void localise();
+
+    // Does the SN lie within the window?
+    bool contains(const SequenceNumber seqNum) const noexcept { return offset(seqNum) < windowSize_; }
+
+    // Is a packet with the SN held in the window?
+    bool holds(const SequenceNumber seqNum) const noexcept { return contains(seqNum) && occupied_.test(slot(seqNum)); }
+
+    // Copies the packet into the slot for its SN. Returns false if the SN is outside the window or already present.
+    // Throws ArqProtocolException if the packet is larger than the MTU.
+    bool insert(const TransmitBufferObject& packet);
+
+    // Slides the window forward so that it starts at the given SN, releasing any packets before it. Returns the number
+    // of packets released.
+    size_t releaseUntil(const SequenceNumber seqNum);
+
+    // Returns the SN of the earliest packet last transmitted before the deadline
+    std::optional<SequenceNumber> findLastTxBefore(const TimePoint deadline) const noexcept;
+
+    // Records that the packet with the given SN has been retransmitted and returns its serialised data
+    std::span<const std::byte> retransmit(const SequenceNumber seqNum, const TimePoint now) noexcept;
+
+    // Per-packet metadata, for packets present in the window
+    TimePoint firstTxTime(const SequenceNumber seqNum) const noexcept { return firstTxTimes_[slot(seqNum)]; }
+    TimePoint lastTxTime(const SequenceNumber seqNum) const noexcept { return lastTxTimes_[slot(seqNum)]; }
+    uint16_t retransmitCount(const SequenceNumber seqNum) const noexcept { return retransmitCounts_[slot(seqNum)]; }
+
+private:
+    size_t slot(const SequenceNumber seqNum) const noexcept { return seqNum & mask_; }
+
+    // Distance of the SN from the start of the window, allowing for roll-over
+    size_t offset(const SequenceNumber seqNum) const noexcept
+    {
+        return static_cast<SequenceNumber>(seqNum - start_);
+    }
+
+    // Offset of the slot's serialised packet in the arena
+    size_t arenaOffset(const size_t idx) const noexcept { return idx * mtu_; }
+
+    const uint16_t windowSize_;
+    const size_t mask_;
+    const size_t mtu_;
+
+    // Per-slot metadata. Whether a slot is in use is recorded in the occupancy bitmap.
+    util::OccupancyBitmap occupied_;
+    std::vector<TimePoint> lastTxTimes_;
+    std::vector<TimePoint> firstTxTimes_;
+    std::vector<uint16_t> retransmitCounts_;
+    std::vector<uint16_t> packetLengths_;
+
+    // Serialised packets, one MTU-sized buffer per slot. Each page holds the buffers for one word of the bitmap.
+    util::PagedArray<std::byte> payloadArena_;
+
+    SequenceNumber start_;
+};
+
+} // namespace arq
+
+#endif
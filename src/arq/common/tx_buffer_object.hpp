@@ -9,6 +9,9 @@
 namespace arq {
 
 struct PacketInfo {
+    // Time at which the packet was due to be sent, from which its delay is measured. The same as firstTxTime_ unless
+    // the sender gave a scheduled send time when submitting it.
+    std::chrono::time_point<ClockType> dueTime_;
     // Time at which packet was first added to the buffer
     std::chrono::time_point<ClockType> firstTxTime_;
     // Time at which packet was last transmitted
@@ -2,6 +2,7 @@
 #define _ARQ_RECEIVER_HPP_
 
 #include <atomic>
+#include <format>
 #include <memory>
 #include <thread>
 #include <type_traits>
@@ -9,10 +10,14 @@
 #include "arq/common/arq_common.hpp"
 #include "arq/common/control_packet.hpp"
 #include "arq/common/conversation_id.hpp"
+#include "arq/common/latency_stats.hpp"
 #include "arq/common/output_buffer.hpp"
+#include "arq/common/protocol_metrics.hpp"
 #include "arq/common/resequencing_buffer.hpp"
 #include "util/logging.hpp"
+#include "util/thread_placement.hpp"
 #include "util/safe_queue.hpp"
+#include "util/trace.hpp"
 
 namespace arq {
 
@@ -22,13 +27,28 @@ concept RSBuffer = std::is_base_of<ResequencingBuffer<T>, T>::value;
 template <RSBuffer RSBufferType>
 class Receiver {
 public:
-    Receiver(ConversationID id, TransmitFn txFn, ReceiveFn rxFn, std::unique_ptr<RSBufferType>&& rsBuffer_p) :
+    Receiver(ConversationID id,
+             TransmitFn txFn,
+             ReceiveFn rxFn,
+             std::unique_ptr<RSBufferType>&& rsBuffer_p,
+             std::shared_ptr<LatencyStats> latencyStats = nullptr,
+             ThreadingMode threadingMode = ThreadingMode::SPLIT,
+             util::PlacementPolicy placement = {},
+             size_t outputBufferCapacity = DEFAULT_OUTPUT_BUFFER_CAPACITY) :
         id_{id},
         txFn_{txFn},
         rxFn_{rxFn},
+        threadingMode_{threadingMode},
+        placement_{std::move(placement)},
+        outputBuffer_{outputBufferCapacity},
         resequencingBuffer_{std::move(rsBuffer_p)},
-        resequencingThread_{[this]() { return this->resequencingThread(); }},
-        ackThread_{[this]() { return this->ackThread(); }},
+        latencyStats_{std::move(latencyStats)},
+        metrics_{id},
+        resequencingThread_{[this]() {
+            return threadingMode_ == ThreadingMode::SPLIT ? this->resequencingThread() : this->runToCompletionThread();
+        }},
+        ackThread_{threadingMode == ThreadingMode::SPLIT ? std::thread{[this]() { return this->ackThread(); }}
+                                                         : std::thread{}},
         ackQueue_{},
         ackedEndOfTx_{false},
         endOfTxSn_{std::nullopt}
@@ -45,65 +65,195 @@ public:
         }
     }
 
+    // Get the next packet from the output buffer. If the buffer is empty, wait until a packet is available.
+    ReceiveBufferObject getPacket()
+    {
+        auto packet = outputBuffer_.getPacket();
+        metrics_.outputBufferDepth_.add(-1);
+        return packet;
+    }
+
     // If a packet is available, get the next packet from the output buffer.
-    std::optional<ReceiveBufferObject> tryGetPacket() { return outputBuffer_.tryGetPacket(); }
+    std::optional<ReceiveBufferObject> tryGetPacket()
+    {
+        auto packet = outputBuffer_.tryGetPacket();
+        if (packet.has_value()) {
+            metrics_.outputBufferDepth_.add(-1);
+        }
+        return packet;
+    }
 
 private:
     std::optional<DataPacket> receivePacket() const
     {
-        std::array<std::byte, MAX_TRANSMISSION_UNIT> recvBuffer;
+        std::array<std::byte, MAX_SUPPORTED_MTU> recvBuffer;
 
-        auto bytesRxed = rxFn_(recvBuffer);
+        RxTimestamp rxTime;
+        auto bytesRxed = rxFn_(recvBuffer, rxTime);
         if (!bytesRxed.has_value() || bytesRxed == 0) {
             return std::nullopt;
         }
-        assert(bytesRxed <= MAX_TRANSMISSION_UNIT);
+        assert(bytesRxed <= MAX_SUPPORTED_MTU);
 
         util::logDebug("Received {} bytes of data", bytesRxed.value());
-        return arq::DataPacket(recvBuffer);
+        if (bytesRxed.value() < DataPacketHeader::size()) {
+            util::logWarning("Dropped datagram of {} bytes which is too short to hold a packet header",
+                             bytesRxed.value());
+            metrics_.corruptPackets_.increment();
+            return std::nullopt;
+        }
+        arq::DataPacket packet{std::span(recvBuffer).first(bytesRxed.value())};
+        if (!packet.checkSumValid()) {
+            util::logWarning("Dropped packet with SN {} which failed its checksum",
+                             packet.getHeader().sequenceNumber_);
+            metrics_.corruptPackets_.increment();
+            return std::nullopt;
+        }
+        if (packet.isProbe()) {
+            util::logDebug("Discarded path MTU probe of {} bytes", bytesRxed.value());
+            return std::nullopt;
+        }
+        packet.setRxTime(rxTime);
+        return packet;
+    }
+
+    // Feeds a received packet to the RS buffer, returning the ACK to be sent, if any. Packets beyond the receive window
+    // are dropped, so that the RS buffer never holds more than the output buffer has room for, and the last ACK is
+    // repeated with the current window in reply to any zero-window probe.
+    std::optional<ControlPacket> processPacket(DataPacket&& packet)
+    {
+        auto pktHdr = packet.getHeader();
+        util::logInfo("Received data packet with length {} and SN {}", pktHdr.length_, pktHdr.sequenceNumber_);
+        if (packet.rxTime().has_value()) {
+            util::trace(util::TraceEvent::PACKET_RX, pktHdr.id_, pktHdr.sequenceNumber_, packet.rxTime().value());
+        }
+        else {
+            util::trace(util::TraceEvent::PACKET_RX, pktHdr.id_, pktHdr.sequenceNumber_);
+        }
+        metrics_.packetsReceived_.increment();
+
+        const auto lastAckSn = lastAckSn_.value_or(outputBuffer_.nextSequenceNumber() - 1);
+        const auto window = outputBuffer_.receiveWindow(lastAckSn);
+        // SNs wrap, so a packet is ahead of the last ACK if it falls in the half of the SN space which follows it
+        const SequenceNumber offset = pktHdr.sequenceNumber_ - lastAckSn;
+        if (offset > window && offset <= MAX_SEQUENCE_NUMBER / 2) {
+            util::logInfo("Dropped packet with SN {} beyond the receive window of {} packets after SN {}",
+                          pktHdr.sequenceNumber_,
+                          window,
+                          lastAckSn);
+            metrics_.receiveWindowDrops_.increment();
+            if (!lastAckSn_.has_value()) {
+                return std::nullopt;
+            }
+            return ControlPacket{.sequenceNumber_ = lastAckSn, .receiveWindow_ = window};
+        }
+
+        // Record if EoT received
+        if (packet.isEndOfTx()) {
+            endOfTxSn_ = pktHdr.sequenceNumber_;
+        }
+
+        auto ack = resequencingBuffer_->addPacket(std::move(packet));
+        metrics_.rsBufferBytes_.set(resequencingBuffer_->memoryUsage());
+        if (!ack.has_value()) {
+            return std::nullopt;
+        }
+        lastAckSn_ = ack.value();
+        return ControlPacket{.sequenceNumber_ = ack.value(),
+                             .receiveWindow_ = outputBuffer_.receiveWindow(ack.value())};
+    }
+
+    // Pushes every packet the RS buffer can release to the output buffer, until it is full.
+    void deliverPackets()
+    {
+        for (std::optional<DataPacket> packetForDelivery;
+             !outputBuffer_.full() && ((packetForDelivery = resequencingBuffer_->getNextPacket()) != std::nullopt);) {
+            const auto sn = packetForDelivery->getHeader().sequenceNumber_;
+            const bool isEndOfTx = packetForDelivery->isEndOfTx();
+            if (outputBuffer_.addPacket(std::move(packetForDelivery.value()))) {
+                metrics_.outputBufferDepth_.add(1);
+                if (latencyStats_ != nullptr && !isEndOfTx) {
+                    latencyStats_->packetDelivered(sn, ClockType::now());
+                }
+            }
+        }
     }
 
     // The resequencing thread receives packets and determines whether they should be acked. Before
     // receiving a new packet, it checks whether any packets can be delivered to the output buffer.
     void resequencingThread()
     {
+        util::applyPlacement(placement_, 0, std::format("arq-rx{}", id_));
+        // The buffer was constructed on another thread, so move its window onto this thread's NUMA node
+        if (!placement_.cpus_.empty()) {
+            resequencingBuffer_->localise();
+        }
+        if (placement_.prefault_) {
+            resequencingBuffer_->prefault();
+        }
+        resequencingBuffer_->attachMetrics(metrics_.duplicatePackets_, metrics_.outOfWindowPackets_);
+        metrics_.rsBufferBytes_.set(resequencingBuffer_->memoryUsage());
+
         while (!ackedEndOfTx_) {
             auto packet = receivePacket();
 
-            // If a packet is received, feed it to the RS buffer and process any resulting ACKs.
+            // If a packet is received, feed it to the RS buffer and queue any resulting ACK.
             if (packet.has_value()) {
-                auto pktHdr = packet->getHeader();
-                util::logInfo("Received data packet with length {} and SN {}", pktHdr.length_, pktHdr.sequenceNumber_);
-
-                // Record if EoT received
-                if (packet->isEndOfTx()) {
-                    endOfTxSn_ = pktHdr.sequenceNumber_;
-                }
-
-                auto ack = resequencingBuffer_->addPacket(std::move(packet.value()));
+                auto ack = processPacket(std::move(packet.value()));
                 if (ack.has_value()) {
+                    metrics_.ackQueueDepth_.add(1);
                     ackQueue_.push(std::move(ack.value()));
                 }
             }
 
-            // Send any outstanding ACKs
-            for (std::optional<DataPacket> packetForDelivery;
-                 ((packetForDelivery = resequencingBuffer_->getNextPacket()) != std::nullopt);) {
-                outputBuffer_.addPacket(std::move(packetForDelivery.value()));
-            }
+            deliverPackets();
         }
 
         util::logInfo("Receiver resequencing thread exited");
     }
 
-    void sendAck(SequenceNumber sequenceNumberToAck)
+    // In run-to-completion mode, a single thread replaces the resequencing and ACK threads. It busy-polls the
+    // non-blocking socket and sends each ACK inline as soon as the RS buffer produces it. It exits once the ACK for an
+    // EoT packet has been sent.
+    void runToCompletionThread()
+    {
+        util::applyPlacement(placement_, 0, std::format("arq-rx{}", id_));
+        // The buffer was constructed on another thread, so move its window onto this thread's NUMA node
+        if (!placement_.cpus_.empty()) {
+            resequencingBuffer_->localise();
+        }
+        if (placement_.prefault_) {
+            resequencingBuffer_->prefault();
+        }
+        resequencingBuffer_->attachMetrics(metrics_.duplicatePackets_, metrics_.outOfWindowPackets_);
+        metrics_.rsBufferBytes_.set(resequencingBuffer_->memoryUsage());
+
+        while (!ackedEndOfTx_) {
+            auto packet = receivePacket();
+            if (packet.has_value()) {
+                auto ack = processPacket(std::move(packet.value()));
+                if (ack.has_value()) {
+                    acknowledge(ack.value());
+                }
+            }
+
+            deliverPackets();
+        }
+
+        util::logInfo("Receiver run-to-completion thread exited");
+    }
+
+    void sendAck(const ControlPacket& ctrlPkt)
     {
-        util::logInfo("Sending ACK for packet with SN {}", sequenceNumberToAck);
-        arq::ControlPacket ctrlPkt = {.sequenceNumber_ = sequenceNumberToAck};
-        std::array<std::byte, sizeof(arq::ControlPacket)> sendBuffer;
+        util::logInfo("Sending ACK for packet with SN {} with receive window {}",
+                      ctrlPkt.sequenceNumber_,
+                      ctrlPkt.receiveWindow_);
+        util::trace(util::TraceEvent::ACK_TX, id_, ctrlPkt.sequenceNumber_);
+        std::array<std::byte, arq::ControlPacket::size()> sendBuffer;
 
         if (ctrlPkt.serialise(sendBuffer)) {
             txFn_(sendBuffer);
+            metrics_.acksSent_.increment();
             util::logDebug("Sent {} bytes", sendBuffer.size());
         }
         else {
@@ -115,37 +265,55 @@ private:
     // It exits once the last ACK has been sent.
     void ackThread()
     {
+        util::applyPlacement(placement_, 1, std::format("arq-rx{}-ack", id_));
         while (!ackedEndOfTx_) {
             auto nextToAck = ackQueue_.try_pop();
             if (nextToAck.has_value()) {
-                sendAck(nextToAck.value());
-
-                // Check if we've rx'd the last packet
-                if (endOfTxSn_.load().has_value() && nextToAck.value() == endOfTxSn_.load().value()) {
-                    util::logInfo("Sent ACK for End of Tx packet");
-                    ackedEndOfTx_ = true;
-                }
+                metrics_.ackQueueDepth_.add(-1);
+                acknowledge(nextToAck.value());
             }
         }
         util::logInfo("Receiver ACK thread exited");
     }
 
+    // Sends an ACK, noting whether it completes the conversation.
+    void acknowledge(const ControlPacket& ack)
+    {
+        sendAck(ack);
+
+        // Check if we've rx'd the last packet
+        if (endOfTxSn_.load().has_value() && ack.sequenceNumber_ == endOfTxSn_.load().value()) {
+            util::logInfo("Sent ACK for End of Tx packet");
+            ackedEndOfTx_ = true;
+        }
+    }
+
     // Identifies the current conversation (TO DO: issue #24)
     ConversationID id_;
     // Function pointer for raw data transmission
     TransmitFn txFn_;
     // Function pointer for raw data reception
     ReceiveFn rxFn_;
+    // Whether data and ACKs are handled on separate threads
+    ThreadingMode threadingMode_;
+    // CPUs and scheduling class for the threads below, in the order they are created
+    util::PlacementPolicy placement_;
     // Store packets for delivery
     OutputBuffer outputBuffer_;
+    // The SN last acknowledged, relative to which the receive window is advertised
+    std::optional<SequenceNumber> lastAckSn_;
     // Store packets that have been received but not yet pushed to the output buffer
     std::unique_ptr<RSBufferType> resequencingBuffer_;
+    // If set, records the delay of each packet pushed to the output buffer (shared with the Transmitter)
+    std::shared_ptr<LatencyStats> latencyStats_;
+    // Counters and gauges exported for this conversation
+    ReceiverMetrics metrics_;
     // Thread handling packet reception and delivery to output buffer
     std::thread resequencingThread_;
-    // Thread handling sending ACKs back to the transmitter
+    // Thread handling sending ACKs back to the transmitter (split mode only)
     std::thread ackThread_;
 
-    util::SafeQueue<SequenceNumber> ackQueue_;
+    util::SafeQueue<ControlPacket> ackQueue_;
     // // If an EoT has been received, store the SN here
     // std::optional<SequenceNumber> endOfTxSeqNum_;
     // If an EoT has been received, store time of last packet reception
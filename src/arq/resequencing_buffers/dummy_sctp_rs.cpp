@@ -24,14 +24,19 @@ std::optional<arq::SequenceNumber> arq::rs::DummySCTP::do_addPacket(DataPacket&&
         /* Unlike UDP, SCTP does not use datagrams, instead delivering a stream of bytes with
          * length equal to the MTU of the interface. Although the data is guaranteed to arrive
          * as in-order packets, we need to trim the extra bytes before passing the packet to
-         * the RS buffer.*/
-        const size_t packetLen = arq::packet_payload_length + arq::DataPacketHeader::size();
+         * the RS buffer. The header gives the length of the packet, which may be up to the MTU.*/
+        const size_t packetLen = receivedPacket.getHeader().length_ + arq::DataPacketHeader::size();
+        if (packetLen > pktSpan.size()) {
+            util::logError("Recieved data is shorter than the data packet length of {} bytes", packetLen);
+            return std::nullopt;
+        }
         pktSpan = pktSpan.subspan(0, packetLen);
     }
 
     auto receivedSequenceNumber = DataPacket(pktSpan).getHeader().sequenceNumber_;
     if (receivedSequenceNumber != nextSequenceNumber_) {
         util::logDebug("Dummy RS buffer rejected packet with SN {}", receivedSequenceNumber);
+        (receivedSequenceNumber < nextSequenceNumber_ ? duplicatePackets_ : outOfWindowPackets_)->increment();
         return std::nullopt;
     }
     else {
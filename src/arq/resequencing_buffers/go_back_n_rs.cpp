@@ -20,6 +20,7 @@ std::optional<arq::SequenceNumber> arq::rs::GoBackN::do_addPacket(DataPacket&& p
     else {
         // Reject packet - ACK last correctly received packet instead
         util::logDebug("Rejected packet with SN {}", receivedSeqNum);
+        (receivedSeqNum < nextSequenceNumber_ ? duplicatePackets_ : outOfWindowPackets_)->increment();
         return canSendAcks_ ? std::make_optional(nextSequenceNumber_ - 1) : std::nullopt;
     }
 }
@@ -1,6 +1,7 @@
 #ifndef _ARQ_RS_BUFFERS_SELECTIVE_REPEAT_HPP_
 #define _ARQ_RS_BUFFERS_SELECTIVE_REPEAT_HPP_
 
+#include "arq/common/circular_window.hpp"
 #include "arq/common/resequencing_buffer.hpp"
 #include "util/safe_queue.hpp"
 
@@ -21,24 +22,18 @@ public:
     bool do_packetsPending() const noexcept;
     std::optional<DataPacket> do_getNextPacket();
 
+    // Optional functions of the ResequencingBuffer CRTP interface
+    size_t do_memoryUsage() const noexcept;
+    void do_prefault();
+    void do_localise();
+
 private:
-    // If possible, move packets from the circular buffer to the shadow buffer.
+    // If possible, move packets from the window to the shadow buffer.
     void updateBuffer();
 
-    // The window defines the maximum number of packets that can be in the RS buffer.
-    const uint16_t windowSize_;
-
-    // A circular buffer holding the packets for resequencing.
-    std::vector<std::optional<arq::DataPacket>> buffer_;
-
-    // The index within the buffer of the earliest packet.
-    size_t startIdx_ = 0;
-
-    // The SN corresponding to the earliest packet in the RS buffer.
-    SequenceNumber earliestExpected_;
-
-    // Packets in the circular buffer.
-    size_t packetsInBuffer_ = 0;
+    // The sliding window of packets awaiting resequencing. The start of the window is the SN corresponding to the
+    // earliest packet expected.
+    CircularWindow<arq::DataPacket> window_;
 
     // Store packets received here for delivery to the output buffer.
     util::SafeQueue<arq::DataPacket> shadowBuffer_;
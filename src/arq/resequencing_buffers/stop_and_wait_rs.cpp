@@ -13,6 +13,7 @@ std::optional<arq::SequenceNumber> arq::rs::StopAndWait::do_addPacket(DataPacket
 
     if (packetForDelivery_.has_value()) {
         util::logInfo("Received packet with SN {} but RS buffer is full", receivedSequenceNumber);
+        (receivedSequenceNumber <= expectedPacketSeqNum_ ? duplicatePackets_ : outOfWindowPackets_)->increment();
         return std::nullopt;
     }
 
@@ -27,11 +28,13 @@ std::optional<arq::SequenceNumber> arq::rs::StopAndWait::do_addPacket(DataPacket
         util::logInfo("Packet {} received but RS buffer has already ACKed packet with SN {}",
                       receivedSequenceNumber,
                       expectedPacketSeqNum_ - 1);
+        duplicatePackets_->increment();
         return receivedSequenceNumber;
     }
     else {
         util::logDebug(
             "RS buffer rejected packet with SN {} (expected {})", receivedSequenceNumber, expectedPacketSeqNum_);
+        outOfWindowPackets_->increment();
     }
 
     return std::nullopt;
@@ -23,4 +23,9 @@ bool arq::rt::DummySCTP::do_packetsPending() const
     return false;
 }
 
+size_t arq::rt::DummySCTP::do_packetCount() const
+{
+    return 0;
+}
+
 void arq::rt::DummySCTP::do_acknowledgePacket([[maybe_unused]] const SequenceNumber seqNum) {}
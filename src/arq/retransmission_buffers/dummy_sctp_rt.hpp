@@ -15,6 +15,7 @@ public:
     std::optional<std::span<const std::byte>> do_tryGetPacketSpan();
     bool do_readyForNewPacket() const;
     bool do_packetsPending() const;
+    size_t do_packetCount() const;
     void do_acknowledgePacket(const SequenceNumber seqNum);
 };
 
@@ -1,76 +1,102 @@
 #include "arq/retransmission_buffers/go_back_n_rt.hpp"
+
+#include <format>
+
 #include "util/logging.hpp"
 
 arq::rt::GoBackN::GoBackN(const uint16_t windowSize,
                           const std::chrono::microseconds timeout,
-                          const SequenceNumber firstSeqNum) :
+                          const SequenceNumber firstSeqNum,
+                          const size_t mtu) :
     RetransmissionBuffer{timeout},
-    windowSize_{windowSize},
-    buffer_{std::vector<std::optional<TransmitBufferObject>>(windowSize, std::nullopt)},
-    startIdx_{0},
-    nextToAck_{firstSeqNum},
-    packetsInBuffer_{0}
+    window_{windowSize, firstSeqNum, mtu}
 {
 }
 
-// Add a packet to the next space in the circular buffer
+// Add a packet to the slot in the window for its SN
 void arq::rt::GoBackN::do_addPacket(TransmitBufferObject&& packet)
 {
-    size_t pkt_idx = startIdx_;
-    do {
-        if (buffer_[pkt_idx] == std::nullopt) {
-            buffer_[pkt_idx] = packet;
-            packetsInBuffer_++;
-            return;
-        }
-
-        pkt_idx = (pkt_idx + 1) % windowSize_;
-    } while (pkt_idx != startIdx_);
-    throw ArqProtocolException("tried to add packet to Go-Back-N RT buffer, but buffer was full");
+    if (window_.full()) {
+        throw ArqProtocolException("tried to add packet to Go-Back-N RT buffer, but buffer was full");
+    }
+
+    const auto seqNum = packet.info_.sequenceNumber_;
+    if (!window_.insert(packet)) {
+        throw ArqProtocolException(
+            std::format("tried to add packet with SN {} to Go-Back-N RT buffer, but SN was not free in window "
+                        "starting at {}",
+                        seqNum,
+                        window_.start()));
+    }
 }
 
 std::optional<std::span<const std::byte>> arq::rt::GoBackN::do_tryGetPacketSpan()
 {
-    if (!do_packetsPending()) {
+    // Retransmit the earliest packet that has timed out.
+    const auto now = arq::ClockType::now();
+    const auto seqNum = window_.findLastTxBefore(now - timeoutInterval_);
+    if (!seqNum.has_value()) {
         return std::nullopt;
     }
 
-    // Retransmit the earliest packet that has not timed out.
-    size_t pkt_idx = startIdx_;
-    do {
-        auto& this_pkt = buffer_[pkt_idx];
-
-        if (this_pkt.has_value() && isPacketTimedOut(this_pkt.value())) {
-            util::logDebug("Retransmit packet at idx {} (start_idx {})", pkt_idx, startIdx_);
-            this_pkt->info_.lastTxTime_ = arq::ClockType::now();
-            return this_pkt->packet_.getReadSpan();
-        }
-
-        pkt_idx = (pkt_idx + 1) % windowSize_;
-    } while (pkt_idx != startIdx_);
-    return std::nullopt;
+    util::logDebug("Retransmit packet with SN {} (window start {}, previous retransmissions {})",
+                   seqNum.value(),
+                   window_.start(),
+                   window_.retransmitCount(seqNum.value()));
+    return window_.retransmit(seqNum.value(), now);
 }
 
-// A new packet may be added if there is space in the circular buffer.
+// A new packet may be added if there is space in the window.
 bool arq::rt::GoBackN::do_readyForNewPacket() const noexcept
 {
-    return packetsInBuffer_ < windowSize_;
+    return !window_.full();
 }
 
 bool arq::rt::GoBackN::do_packetsPending() const noexcept
 {
-    return packetsInBuffer_ > 0;
+    return !window_.empty();
+}
+
+size_t arq::rt::GoBackN::do_packetCount() const noexcept
+{
+    return window_.count();
+}
+
+size_t arq::rt::GoBackN::do_memoryUsage() const noexcept
+{
+    return sizeof(*this) + window_.memoryUsage();
+}
+
+void arq::rt::GoBackN::do_prefault()
+{
+    window_.prefault();
+}
+
+void arq::rt::GoBackN::do_localise()
+{
+    window_.localise();
+}
+
+// The time of a packet's only transmission, or nullopt if it has been retransmitted
+std::optional<arq::TransmitWindow::TimePoint> arq::rt::GoBackN::do_unambiguousTxTime(
+    const SequenceNumber seqNum) const noexcept
+{
+    if (!window_.holds(seqNum) || window_.retransmitCount(seqNum) != 0) {
+        return std::nullopt;
+    }
+    return window_.lastTxTime(seqNum);
 }
 
 // in GBN ARQ, ACKs are only sent for in order packets.
 void arq::rt::GoBackN::do_acknowledgePacket(const SequenceNumber ackedSeqNum)
 {
-    if (ackedSeqNum >= nextToAck_ + windowSize_) {
+    // An ACK preceding the window is for packets already released
+    if (!window_.contains(ackedSeqNum) && !precedes(ackedSeqNum, window_.start())) {
         util::logError(
             "Tried to ACK packet with SN {}, which is outside of possible range for GBN RT buffer starting at {} of size {}",
             ackedSeqNum,
-            nextToAck_,
-            windowSize_);
+            window_.start(),
+            window_.windowSize());
         return;
     }
 
@@ -79,21 +105,9 @@ void arq::rt::GoBackN::do_acknowledgePacket(const SequenceNumber ackedSeqNum)
         return;
     }
 
-    // Since packets are only ACK'd in order, any packet before the ACK is also ACK'd
-    for (int i = 0; i < windowSize_; ++i) {
-        const auto pkt_idx = (startIdx_ + i) % windowSize_;
-
-        // WJG: Here we assume non-wrapping SNs
-        if (nextToAck_ + i <= ackedSeqNum) {
-            buffer_[pkt_idx] = std::nullopt;
-            packetsInBuffer_--;
-        }
-    }
-
-    // Update the circular buffer info based on the new 'next packet to ACK'
-    if (ackedSeqNum >= nextToAck_) {
-        startIdx_ += (ackedSeqNum + 1 - nextToAck_);
-        startIdx_ %= windowSize_;
-        nextToAck_ = ackedSeqNum + 1;
+    // Since packets are only ACK'd in order, any packet before the ACK is also ACK'd. Sliding the window releases
+    // only these packets.
+    if (window_.contains(ackedSeqNum)) {
+        window_.releaseUntil(ackedSeqNum + 1);
     }
 }
@@ -3,9 +3,9 @@
 
 #include <cstdint>
 #include <optional>
-#include <vector>
 
 #include "arq/common/retransmission_buffer.hpp"
+#include "arq/common/transmit_window.hpp"
 
 namespace arq {
 namespace rt {
@@ -15,27 +15,27 @@ class GoBackN : public RetransmissionBuffer<GoBackN> {
 public:
     GoBackN(const uint16_t windowSize,
             const std::chrono::microseconds timeout,
-            const SequenceNumber firstSeqNum = FIRST_SEQUENCE_NUMBER);
+            const SequenceNumber firstSeqNum = FIRST_SEQUENCE_NUMBER,
+            const size_t mtu = DEFAULT_MTU);
 
     // Standard functions required by RetransmissionBuffer CRTP interface
     void do_addPacket(TransmitBufferObject&& packet);
     std::optional<std::span<const std::byte>> do_tryGetPacketSpan();
     bool do_readyForNewPacket() const noexcept;
     bool do_packetsPending() const noexcept;
+    size_t do_packetCount() const noexcept;
     void do_acknowledgePacket(const SequenceNumber ackedSeqNum);
 
+    // Optional functions of the RetransmissionBuffer CRTP interface
+    size_t do_memoryUsage() const noexcept;
+    void do_prefault();
+    void do_localise();
+    std::optional<TransmitWindow::TimePoint> do_unambiguousTxTime(const SequenceNumber seqNum) const noexcept;
+
 private:
-    // The window defines the maximum number of packets that can be in the RT buffer.
-    const uint16_t windowSize_;
-    // A circular buffer holding the packets for retransmission.
-    std::vector<std::optional<TransmitBufferObject>> buffer_;
-    // The index within the buffer of the earliest packet.
-    size_t startIdx_;
-    // The next SN to acknowledge - this corresponds to the earliest packet in the buffer.
-    SequenceNumber nextToAck_;
-    // The current number of packets in the buffer. By keeping track of this, we can cut down on
-    // unneccessary buffer iteration.
-    size_t packetsInBuffer_;
+    // The sliding window of packets awaiting acknowledgement. The start of the window is the next SN to acknowledge,
+    // which corresponds to the earliest packet in the buffer.
+    TransmitWindow window_;
 };
 
 } // namespace rt
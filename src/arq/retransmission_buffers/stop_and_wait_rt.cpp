@@ -10,12 +10,14 @@ void arq::rt::StopAndWait::do_addPacket(arq::TransmitBufferObject&& packet)
         throw ArqProtocolException("tried to add packet to S&W RT buffer but packet was already present");
     }
     retransmitPacket_ = packet;
+    retransmitted_ = false;
 }
 
 std::optional<std::span<const std::byte>> arq::rt::StopAndWait::do_tryGetPacketSpan()
 {
     if (retransmitPacket_.has_value() && isPacketTimedOut(retransmitPacket_.value())) {
         retransmitPacket_->updateLastTxTime();
+        retransmitted_ = true;
         return retransmitPacket_->packet_.getReadSpan();
     }
     else {
@@ -33,6 +35,21 @@ bool arq::rt::StopAndWait::do_packetsPending() const
     return retransmitPacket_.has_value();
 }
 
+size_t arq::rt::StopAndWait::do_packetCount() const
+{
+    return retransmitPacket_.has_value() ? 1 : 0;
+}
+
+// The time of the stored packet's only transmission, or nullopt if it has been retransmitted
+std::optional<std::chrono::time_point<arq::ClockType>> arq::rt::StopAndWait::do_unambiguousTxTime(
+    const SequenceNumber seqNum) const noexcept
+{
+    if (!retransmitPacket_.has_value() || retransmitPacket_->info_.sequenceNumber_ != seqNum || retransmitted_) {
+        return std::nullopt;
+    }
+    return retransmitPacket_->info_.lastTxTime_;
+}
+
 void arq::rt::StopAndWait::do_acknowledgePacket(const SequenceNumber ackSequenceNumber)
 {
     if (!retransmitPacket_.has_value()) {
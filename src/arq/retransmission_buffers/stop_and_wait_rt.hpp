@@ -17,11 +17,17 @@ public:
     std::optional<std::span<const std::byte>> do_tryGetPacketSpan();
     bool do_readyForNewPacket() const;
     bool do_packetsPending() const;
+    size_t do_packetCount() const;
     void do_acknowledgePacket(const SequenceNumber ackSequenceNumber);
 
+    // Optional functions of the RetransmissionBuffer CRTP interface
+    std::optional<std::chrono::time_point<ClockType>> do_unambiguousTxTime(const SequenceNumber seqNum) const noexcept;
+
 private:
     // In Stop and Wait, only one packet is stored for retransmission at a time.
     std::optional<TransmitBufferObject> retransmitPacket_ = std::nullopt;
+    // Has the stored packet been retransmitted?
+    bool retransmitted_ = false;
 };
 
 } // namespace rt
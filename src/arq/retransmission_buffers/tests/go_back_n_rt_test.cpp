@@ -127,3 +127,65 @@ TEST_CASE("Go-Back-N RT buffer - add and remove packets", "[arq/rt_buffers]")
 
     REQUIRE_FALSE(rt_buffer.packetsPending());
 }
+
+TEST_CASE("Go-Back-N RT buffer - receive window", "[arq/rt_buffers]")
+{
+    constexpr uint16_t window_size = 20;
+    constexpr arq::SequenceNumber first_seq_num_to_add = 100;
+    arq::rt::GoBackN rt_buffer{window_size, std::chrono::milliseconds(large_timeout), first_seq_num_to_add};
+
+    // The receive window limits packets in flight when it is smaller than the buffer's window
+    rt_buffer.updateReceiveWindow(5);
+    for (const auto sn : std::views::iota(first_seq_num_to_add) | std::views::take(5)) {
+        REQUIRE(rt_buffer.readyForNewPacket());
+        REQUIRE(try_add_packet(rt_buffer, sn));
+    }
+    REQUIRE_FALSE(rt_buffer.readyForNewPacket());
+
+    // The window advertised with an ACK counts from the acknowledged packet
+    rt_buffer.acknowledgePacket(first_seq_num_to_add + 1);
+    rt_buffer.updateReceiveWindow(3);
+    REQUIRE_FALSE(rt_buffer.readyForNewPacket());
+    rt_buffer.updateReceiveWindow(4);
+    REQUIRE(rt_buffer.readyForNewPacket());
+
+    // A zero window still lets a single probe through once every packet in flight has been acknowledged
+    rt_buffer.acknowledgePacket(first_seq_num_to_add + 4);
+    rt_buffer.updateReceiveWindow(0);
+    REQUIRE(rt_buffer.readyForNewPacket());
+    REQUIRE(try_add_packet(rt_buffer, first_seq_num_to_add + 5));
+    REQUIRE_FALSE(rt_buffer.readyForNewPacket());
+
+    // A larger receive window leaves the buffer's own window as the limit
+    rt_buffer.updateReceiveWindow(arq::UNLIMITED_RECEIVE_WINDOW);
+    for (const auto sn : std::views::iota(first_seq_num_to_add + 6) | std::views::take(window_size - 1)) {
+        REQUIRE(rt_buffer.readyForNewPacket());
+        REQUIRE(try_add_packet(rt_buffer, sn));
+    }
+    REQUIRE_FALSE(rt_buffer.readyForNewPacket());
+}
+
+TEST_CASE("Go-Back-N RT buffer - acknowledge across SN roll-over", "[arq/rt_buffers]")
+{
+    constexpr uint16_t window_size = 20;
+    constexpr arq::SequenceNumber first_seq_num_to_add = arq::MAX_SEQUENCE_NUMBER - 9;
+    arq::rt::GoBackN rt_buffer{window_size, std::chrono::milliseconds(large_timeout), first_seq_num_to_add};
+
+    for (size_t i = 0; i < window_size; ++i) {
+        REQUIRE(try_add_packet(rt_buffer, static_cast<arq::SequenceNumber>(first_seq_num_to_add + i)));
+    }
+
+    // An ACK preceding the window is ignored
+    rt_buffer.acknowledgePacket(first_seq_num_to_add - 1);
+    REQUIRE(rt_buffer.packetCount() == window_size);
+
+    // An ACK after roll-over releases every packet up to it, including those before roll-over
+    rt_buffer.acknowledgePacket(4);
+    REQUIRE(rt_buffer.packetCount() == window_size - 15);
+    REQUIRE(rt_buffer.readyForNewPacket());
+    const auto next_seq_num = static_cast<arq::SequenceNumber>(first_seq_num_to_add + window_size);
+    REQUIRE(try_add_packet(rt_buffer, next_seq_num));
+
+    rt_buffer.acknowledgePacket(next_seq_num);
+    REQUIRE_FALSE(rt_buffer.packetsPending());
+}
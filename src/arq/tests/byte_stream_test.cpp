@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <numeric>
+#include <vector>
+
+#include "arq/common/byte_stream.hpp"
+
+// Returns a stream of the given length whose bytes count upwards from the given value
+static std::vector<std::byte> make_stream(size_t length, uint8_t first = 0)
+{
+    std::vector<std::byte> stream(length);
+    std::ranges::generate(stream, [value = first]() mutable { return std::byte{value++}; });
+    return stream;
+}
+
+// Returns a function which takes the next of the packets, if any
+static arq::StreamReader::GetPacketFn pop_packet(std::deque<arq::DataPacket>& packets)
+{
+    return [&packets]() -> std::optional<arq::ReceiveBufferObject> {
+        if (packets.empty()) {
+            return std::nullopt;
+        }
+        arq::ReceiveBufferObject obj{.packet_ = std::move(packets.front()), .rxTime_ = arq::ClockType::now()};
+        packets.pop_front();
+        return obj;
+    };
+}
+
+TEST_CASE("Stream writer fills packets", "[arq/common]")
+{
+    std::deque<arq::DataPacket> packets;
+    const auto stream = make_stream(3 * arq::maxPayloadSize(arq::DEFAULT_MTU) + 100);
+    {
+        arq::StreamWriter writer{3, [&packets](arq::DataPacket&& pkt) { packets.push_back(pkt); }};
+
+        // Small writes are held until a packet is filled
+        const auto data = std::span(stream);
+        writer.write(data.first(10));
+        REQUIRE(packets.empty());
+
+        // Gathered buffers share packets
+        const std::array<std::span<const std::byte>, 2> buffers{data.subspan(10, 1000), data.subspan(1010)};
+        writer.writev(buffers);
+        REQUIRE(packets.size() == 3);
+        REQUIRE(writer.packetsSent() == 3);
+    }
+
+    // The remainder is sent when the writer is destroyed
+    REQUIRE(packets.size() == 4);
+    std::vector<std::byte> received;
+    for (const auto& pkt : packets) {
+        REQUIRE(pkt.getHeader().id_ == 3);
+        std::ranges::copy(pkt.getPayloadReadSpan(), std::back_inserter(received));
+    }
+    REQUIRE(packets.back().getHeader().length_ == 100);
+    REQUIRE(received == stream);
+}
+
+TEST_CASE("Stream reader reads across packet boundaries", "[arq/common]")
+{
+    std::deque<arq::DataPacket> packets;
+    const auto stream = make_stream(2 * arq::maxPayloadSize(arq::DEFAULT_MTU) + 100, 7);
+    {
+        arq::StreamWriter writer{1, [&packets](arq::DataPacket&& pkt) { packets.push_back(pkt); }};
+        writer.write(stream);
+    }
+    packets.push_back(arq::DataPacket{});
+
+    size_t waits = 0;
+    arq::StreamReader reader{[&]() {
+                                 ++waits;
+                                 return pop_packet(packets)();
+                             },
+                             pop_packet(packets)};
+
+    // A read which ends part way through a packet is continued by the next
+    std::vector<std::byte> received(150);
+    REQUIRE(reader.read(std::span(received).first(50)) == 50);
+    std::array<std::span<std::byte>, 2> buffers{std::span(received).subspan(50, 20), std::span(received).subspan(70)};
+    REQUIRE(reader.readv(buffers) == 100);
+    REQUIRE(std::ranges::equal(received, std::span(stream).first(150)));
+    REQUIRE(waits == 1);
+
+    // Packets already delivered are read without waiting
+    received.resize(stream.size());
+    REQUIRE(reader.read(std::span(received).subspan(150)) == stream.size() - 150);
+    REQUIRE(received == stream);
+    REQUIRE(waits == 1);
+    REQUIRE_FALSE(reader.endOfStream());
+
+    // The EoT packet ends the stream
+    REQUIRE(reader.read(received) == 0);
+    REQUIRE(reader.endOfStream());
+    REQUIRE(reader.read(received) == 0);
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <ranges>
+
+#include "arq/common/circular_window.hpp"
+
+TEST_CASE("Circular window - insert and release", "[arq/common]")
+{
+    constexpr uint16_t window_size = 20;
+    constexpr arq::SequenceNumber first_seq_num = 100;
+    arq::CircularWindow<int> window{window_size, first_seq_num};
+
+    // Storage is rounded up to a power of two
+    REQUIRE(window.capacity() == 32);
+    REQUIRE(window.empty());
+
+    // SNs outside the window are rejected
+    REQUIRE_FALSE(window.insert(first_seq_num - 1, 0));
+    REQUIRE_FALSE(window.insert(first_seq_num + window_size, 0));
+
+    for (const auto sn : std::views::iota(first_seq_num) | std::views::take(window_size)) {
+        REQUIRE(window.insert(sn, int{sn}));
+    }
+    REQUIRE(window.full());
+
+    // SNs already present are rejected
+    REQUIRE_FALSE(window.insert(first_seq_num + 5, 0));
+    REQUIRE(*window.find(first_seq_num + 5) == first_seq_num + 5);
+
+    // Releasing slides the window past the released SNs only
+    REQUIRE(window.releaseUntil(first_seq_num + 10) == 10);
+    REQUIRE(window.start() == first_seq_num + 10);
+    REQUIRE(window.count() == window_size - 10);
+    REQUIRE(window.find(first_seq_num + 5) == nullptr);
+    REQUIRE(*window.find(first_seq_num + 10) == first_seq_num + 10);
+
+    // The freed slots are reused for later SNs
+    for (const auto sn : std::views::iota(first_seq_num + window_size) | std::views::take(10)) {
+        REQUIRE(window.insert(sn, int{sn}));
+    }
+    REQUIRE(window.full());
+}
+
+TEST_CASE("Circular window - pop in sequence", "[arq/common]")
+{
+    constexpr uint16_t window_size = 8;
+    arq::CircularWindow<int> window{window_size, 0};
+
+    // Nothing can be popped until the earliest SN arrives
+    REQUIRE(window.insert(2, 2));
+    REQUIRE(window.insert(1, 1));
+    REQUIRE_FALSE(window.popFront().has_value());
+
+    REQUIRE(window.insert(0, 0));
+    for (const int sn : {0, 1, 2}) {
+        REQUIRE(window.popFront() == sn);
+    }
+    REQUIRE_FALSE(window.popFront().has_value());
+    REQUIRE(window.start() == 3);
+    REQUIRE(window.empty());
+}
+
+TEST_CASE("Circular window - find earliest matching", "[arq/common]")
+{
+    constexpr uint16_t window_size = 16;
+    constexpr arq::SequenceNumber first_seq_num = 10;
+    arq::CircularWindow<int> window{window_size, first_seq_num};
+
+    REQUIRE(window.findFirst([](int) { return true; }) == nullptr);
+
+    // Occupy every other SN, so the window wraps around the end of the storage
+    for (const auto sn : std::views::iota(first_seq_num) | std::views::take(window_size)) {
+        if (sn % 2 == 0) {
+            REQUIRE(window.insert(sn, int{sn}));
+        }
+    }
+
+    REQUIRE(*window.findFirst([](int) { return true; }) == first_seq_num);
+    REQUIRE(*window.findFirst([](int sn) { return sn > 20; }) == 22);
+    REQUIRE(window.findFirst([](int sn) { return sn % 2 == 1; }) == nullptr);
+}
+
+TEST_CASE("Circular window - SN roll-over", "[arq/common]")
+{
+    constexpr uint16_t window_size = 10;
+    constexpr arq::SequenceNumber first_seq_num = arq::MAX_SEQUENCE_NUMBER - 4;
+    arq::CircularWindow<int> window{window_size, first_seq_num};
+
+    for (size_t i = 0; i < window_size; ++i) {
+        REQUIRE(window.insert(static_cast<arq::SequenceNumber>(first_seq_num + i), static_cast<int>(i)));
+    }
+    REQUIRE(window.full());
+    REQUIRE(window.contains(0));
+    REQUIRE(*window.find(0) == 5);
+
+    REQUIRE(window.releaseUntil(2) == 7);
+    REQUIRE(window.start() == 2);
+    REQUIRE(*window.findFirst([](int) { return true; }) == 7);
+}
+
+TEST_CASE("Circular window - storage follows occupancy", "[arq/common]")
+{
+    constexpr uint16_t window_size = 1000;
+    arq::CircularWindow<int> window{window_size, 0};
+    const auto empty_usage = window.memoryUsage();
+
+    for (const auto sn : std::views::iota(arq::SequenceNumber{0}) | std::views::take(window_size)) {
+        REQUIRE(window.insert(sn, int{sn}));
+    }
+    const auto full_usage = window.memoryUsage();
+    REQUIRE(full_usage > empty_usage);
+
+    // Releasing most of the window returns its storage, keeping at most one spare page
+    window.releaseUntil(990);
+    REQUIRE(window.memoryUsage() <= empty_usage + 2 * 64 * sizeof(std::optional<int>));
+
+    window.releaseUntil(1000);
+    REQUIRE(window.memoryUsage() <= empty_usage + 64 * sizeof(std::optional<int>));
+}
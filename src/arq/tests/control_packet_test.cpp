@@ -10,7 +10,7 @@ TEST_CASE("ControlPacket serialisation", "[arq]")
 
     // Check serialisation for invalid buffer
     std::array<std::byte, 1> tooSmall;
-    REQUIRE(tooSmall.size() < sizeof(arq::ControlPacket));
+    REQUIRE(tooSmall.size() < arq::ControlPacket::size());
 
     const arq::SequenceNumber testSN = 0x1234;
     arq::ControlPacket ctrlPkt{.sequenceNumber_ = testSN};
@@ -23,23 +23,38 @@ TEST_CASE("ControlPacket serialisation", "[arq]")
     // Test serialisation and deserialisation for all possible sequence numbers
     static_assert(sizeof(arq::SequenceNumber) == 2);
     for (uint16_t i = 0;; ++i) {
-        std::array<std::byte, 2> buffer;
+        std::array<std::byte, arq::ControlPacket::size()> buffer;
 
-        arq::ControlPacket testCtrlPkt{.sequenceNumber_ = i};
+        arq::ControlPacket testCtrlPkt{.sequenceNumber_ = i, .receiveWindow_ = static_cast<uint16_t>(~i)};
         // Serialise
         REQUIRE(testCtrlPkt.serialise(buffer) == true);
 
-        // Set SN to incorrect value before deserialisation
+        // Set SN and window to incorrect values before deserialisation
         testCtrlPkt.sequenceNumber_ += 10;
+        testCtrlPkt.receiveWindow_ += 10;
 
         // Deserialise
         REQUIRE(testCtrlPkt.deserialise(buffer) == true);
 
         // Check value is unchanged
         REQUIRE(testCtrlPkt.sequenceNumber_ == i);
+        REQUIRE(testCtrlPkt.receiveWindow_ == static_cast<uint16_t>(~i));
 
         if (i == UINT16_MAX) {
             break;
         }
     }
 }
+
+TEST_CASE("ControlPacket without a receive window", "[arq]")
+{
+    // An ACK holding only a sequence number advertises an unlimited window
+    std::array<std::byte, sizeof(arq::SequenceNumber)> buffer;
+    REQUIRE(arq::serialiseSeqNum(0x1234, buffer));
+
+    arq::ControlPacket ctrlPkt{.sequenceNumber_ = 0, .receiveWindow_ = 0};
+    REQUIRE(ctrlPkt.serialise(buffer) == false);
+    REQUIRE(ctrlPkt.deserialise(buffer) == true);
+    REQUIRE(ctrlPkt.sequenceNumber_ == 0x1234);
+    REQUIRE(ctrlPkt.receiveWindow_ == arq::UNLIMITED_RECEIVE_WINDOW);
+}
@@ -8,7 +8,8 @@ static void data_packet_header_serialisation()
     util::Logger::setLoggingLevel(util::LoggingLevel::LOGGING_LEVEL_DEBUG);
 
     // Initialise a header with random data
-    arq::DataPacketHeader hdr_before{.id_ = 0x4F, .sequenceNumber_ = 0xE810, .length_ = 0x13C2};
+    arq::DataPacketHeader hdr_before{
+        .id_ = 0x4F, .sequenceNumber_ = 0xE810, .length_ = 0x13C2, .flags_ = arq::FIRST_FRAGMENT};
 
     // Check that packed size is no bigger than unpacked size
     REQUIRE(hdr_before.size() <= sizeof(hdr_before));
@@ -38,7 +39,7 @@ static void data_packet_serialisation()
     util::Logger::setLoggingLevel(util::LoggingLevel::LOGGING_LEVEL_DEBUG);
 
     // Initialise a header indicative of an oversized packet
-    arq::DataPacketHeader hdr_before{.id_ = 0x2C, .sequenceNumber_ = 0x2BB0, .length_ = 0x11D4};
+    arq::DataPacketHeader hdr_before{.id_ = 0x2C, .sequenceNumber_ = 0x2BB0, .length_ = 0x2BD4};
 
     REQUIRE(hdr_before.length_ > arq::DATA_PKT_MAX_PAYLOAD_SIZE);
     arq::DataPacket packet_before(hdr_before);
@@ -92,7 +93,7 @@ static void data_packet_serialisation()
     // Create a packet with non-maximal length and random data
     const size_t test_pkt_len = 256;
 
-    arq::DataPacketHeader test_hdr_before{.id_ = 0x2C, .sequenceNumber_ = 0x2BB0, .length_ = 0x11D4};
+    arq::DataPacketHeader test_hdr_before{.id_ = 0x2C, .sequenceNumber_ = 0x2BB0, .length_ = 0x2BD4};
 
     test_hdr_before.length_ = test_pkt_len;
     std::vector<std::byte> test_pkt_data(test_pkt_len);
@@ -139,3 +140,29 @@ TEST_CASE("DataPacket serialisation", "[arq]")
 {
     data_packet_serialisation();
 }
+
+TEST_CASE("DataPacket checksum", "[arq]")
+{
+    arq::DataPacket packet(arq::DataPacketHeader{.id_ = 0x2C, .sequenceNumber_ = 0x2BB0, .length_ = 256});
+    for (size_t i = 0; auto& b : packet.getPayloadSpan()) {
+        b = std::byte(i * i - 123 * i); // pseudo-random data
+        ++i;
+    }
+    packet.updateCheckSum();
+    REQUIRE(packet.getHeader().checksum_ == packet.getCheckSum());
+
+    // The checksum survives serialisation
+    arq::DataPacket received(packet.getReadSpan());
+    REQUIRE(received.checkSumValid());
+
+    // Corrupting the payload or the header invalidates the checksum
+    auto corrupted = std::vector<std::byte>(packet.getReadSpan().begin(), packet.getReadSpan().end());
+    corrupted.back() ^= std::byte{0x01};
+    REQUIRE_FALSE(arq::DataPacket(corrupted).checkSumValid());
+    corrupted.back() ^= std::byte{0x01};
+    corrupted.front() ^= std::byte{0x80};
+    REQUIRE_FALSE(arq::DataPacket(corrupted).checkSumValid());
+
+    // A truncated packet is invalid
+    REQUIRE_FALSE(arq::DataPacket(packet.getReadSpan().first(packet.getReadSpan().size() - 1)).checkSumValid());
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include "arq/common/input_buffer.hpp"
+
+using namespace std::chrono_literals;
+
+// Returns a packet of the given conversation with a small payload
+static arq::DataPacket make_packet(arq::ConversationID id)
+{
+    return arq::DataPacket{arq::DataPacketHeader{.id_ = id, .length_ = 10}};
+}
+
+TEST_CASE("Input buffer refuses packets once full", "[arq/common]")
+{
+    arq::InputBuffer buffer{arq::FIRST_SEQUENCE_NUMBER, {.capacity_ = 2}};
+    REQUIRE(buffer.capacity() == 2);
+    REQUIRE(buffer.tryAddPacket(make_packet(1)) == arq::SendStatus::QUEUED);
+    REQUIRE(buffer.tryAddPacket(make_packet(1)) == arq::SendStatus::QUEUED);
+
+    // The refused packet is left intact and consumes no sequence number
+    auto refused = make_packet(3);
+    REQUIRE(buffer.tryAddPacket(std::move(refused)) == arq::SendStatus::FULL);
+    REQUIRE(refused.getHeader().id_ == 3);
+    REQUIRE(buffer.size() == 2);
+
+    REQUIRE(buffer.tryGetPacket()->info_.sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER);
+    REQUIRE(buffer.tryAddPacket(std::move(refused)) == arq::SendStatus::QUEUED);
+    REQUIRE(buffer.tryGetPacket()->info_.sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER + 1);
+    const auto last = buffer.tryGetPacket();
+    REQUIRE(last->info_.sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER + 2);
+    REQUIRE(last->packet_.getHeader().id_ == 3);
+    REQUIRE_FALSE(buffer.tryGetPacket().has_value());
+}
+
+TEST_CASE("Input buffer blocks senders until there is room", "[arq/common]")
+{
+    arq::InputBuffer buffer{arq::FIRST_SEQUENCE_NUMBER, {.capacity_ = 1}};
+    buffer.addPacket(make_packet(1));
+
+    std::atomic<bool> added = false;
+    std::thread sender{[&]() {
+        buffer.addPacket(make_packet(2));
+        added = true;
+    }};
+
+    std::this_thread::sleep_for(50ms);
+    REQUIRE_FALSE(added);
+    REQUIRE(buffer.getPacket().packet_.getHeader().id_ == 1);
+    sender.join();
+    REQUIRE(added);
+    REQUIRE(buffer.size() == 1);
+}
+
+TEST_CASE("Input buffer releases blocked senders once drained by half", "[arq/common]")
+{
+    constexpr size_t capacity = 4;
+    arq::InputBuffer buffer{arq::FIRST_SEQUENCE_NUMBER, {.capacity_ = capacity}};
+    for (size_t i = 0; i < capacity; ++i) {
+        buffer.addPacket(make_packet(1));
+    }
+
+    std::atomic<bool> added = false;
+    std::thread sender{[&]() {
+        buffer.addPacket(make_packet(2));
+        added = true;
+    }};
+
+    // Taking one packet makes room, but the sender waits until half the buffer is free
+    std::this_thread::sleep_for(50ms);
+    REQUIRE_FALSE(added);
+    REQUIRE(buffer.getPacket().packet_.getHeader().id_ == 1);
+    std::this_thread::sleep_for(50ms);
+    REQUIRE_FALSE(added);
+    REQUIRE(buffer.size() == capacity - 1);
+
+    REQUIRE(buffer.getPacket().packet_.getHeader().id_ == 1);
+    sender.join();
+    REQUIRE(added);
+    REQUIRE(buffer.size() == capacity - 1);
+}
+
+TEST_CASE("Input buffer watermark callbacks alternate", "[arq/common]")
+{
+    size_t highCount = 0;
+    size_t lowCount = 0;
+    arq::InputBuffer buffer{arq::FIRST_SEQUENCE_NUMBER,
+                            {.capacity_ = 10,
+                             .highWatermark_ = 4,
+                             .lowWatermark_ = 1,
+                             .onHighWatermark_ = [&highCount]() { ++highCount; },
+                             .onLowWatermark_ = [&lowCount]() { ++lowCount; }}};
+
+    for (size_t i = 0; i < 6; ++i) {
+        buffer.addPacket(make_packet(1));
+    }
+    REQUIRE(highCount == 1);
+
+    // Draining to just above the low watermark and refilling does not call either again
+    for (size_t i = 0; i < 4; ++i) {
+        buffer.getPacket();
+    }
+    REQUIRE(lowCount == 0);
+    buffer.addPacket(make_packet(1));
+    REQUIRE(highCount == 1);
+
+    for (size_t i = 0; i < 2; ++i) {
+        buffer.getPacket();
+    }
+    REQUIRE(lowCount == 1);
+
+    for (size_t i = 0; i < 3; ++i) {
+        buffer.addPacket(make_packet(1));
+    }
+    REQUIRE(highCount == 2);
+}
@@ -0,0 +1,38 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+#include "arq/common/latency_stats.hpp"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("LatencyStats splits delay into queueing and network delay", "[arq]")
+{
+    arq::LatencyStats stats;
+    const std::chrono::time_point<arq::ClockType> due{1s};
+
+    // Sent 3 ms after it was due, then delivered 2 ms later
+    stats.packetSent(1, due, due + 3ms);
+    stats.packetDelivered(1, due + 5ms);
+
+    REQUIRE(stats.histogram().count() == 1);
+    REQUIRE(stats.histogram().max() == 5'000'000);
+    REQUIRE(stats.queueingHistogram().max() == 3'000'000);
+    REQUIRE(stats.networkHistogram().max() == 2'000'000);
+    REQUIRE(stats.unmatched() == 0);
+}
+
+TEST_CASE("LatencyStats counts packets delivered without a send time", "[arq]")
+{
+    arq::LatencyStats stats;
+    const std::chrono::time_point<arq::ClockType> due{1s};
+
+    stats.packetDelivered(2, due);
+    stats.packetSent(3, due, due);
+    stats.packetDelivered(3, due + 1ms);
+    // Each send time is only matched once
+    stats.packetDelivered(3, due + 2ms);
+
+    REQUIRE(stats.histogram().count() == 1);
+    REQUIRE(stats.unmatched() == 2);
+}
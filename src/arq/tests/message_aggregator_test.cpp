@@ -0,0 +1,194 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "arq/common/message_aggregator.hpp"
+
+using namespace std::chrono_literals;
+
+// Payload sizes for the default MTU
+constexpr size_t max_payload_size = arq::maxPayloadSize(arq::DEFAULT_MTU);
+constexpr size_t max_aggregated_message_size = max_payload_size - sizeof(uint16_t);
+
+// Returns a message of the given length filled with the given value
+static std::vector<std::byte> make_message(size_t length, uint8_t value)
+{
+    return std::vector<std::byte>(length, std::byte{value});
+}
+
+TEST_CASE("Message aggregator packs messages into packets", "[arq/common]")
+{
+    std::deque<arq::DataPacket> packets;
+    constexpr size_t message_size = 100;
+    constexpr size_t num_messages = 40;
+    constexpr size_t messages_per_packet = max_payload_size / (message_size + sizeof(uint16_t));
+    {
+        arq::MessageAggregator aggregator{7, [&packets](arq::DataPacket&& pkt) { packets.push_back(pkt); }, 1h};
+        for (size_t i = 0; i < num_messages; ++i) {
+            aggregator.sendMessage(make_message(message_size, i));
+        }
+        // Packets are only sent early once full
+        REQUIRE(packets.size() == num_messages / messages_per_packet);
+        REQUIRE(aggregator.packetsSent() == packets.size());
+        for (const auto& pkt : packets) {
+            REQUIRE(pkt.getHeader().id_ == 7);
+            REQUIRE(pkt.getHeader().length_ == messages_per_packet * (message_size + sizeof(uint16_t)));
+        }
+    }
+    // The remaining messages are sent when the aggregator is destroyed
+    REQUIRE(packets.size() == num_messages / messages_per_packet + 1);
+    REQUIRE_FALSE(packets.back().isEndOfTx());
+
+    // Every message is unpacked in order
+    packets.push_back(arq::DataPacket{});
+    arq::MessageUnpacker unpacker{[&packets]() -> std::optional<arq::ReceiveBufferObject> {
+        if (packets.empty()) {
+            return std::nullopt;
+        }
+        arq::ReceiveBufferObject obj{.packet_ = std::move(packets.front()), .rxTime_ = arq::ClockType::now()};
+        packets.pop_front();
+        return obj;
+    }};
+    for (size_t i = 0; i < num_messages; ++i) {
+        const auto message = unpacker.tryGetMessage();
+        REQUIRE(message.has_value());
+        REQUIRE(std::ranges::equal(message.value(), make_message(message_size, i)));
+    }
+    REQUIRE_FALSE(unpacker.tryGetMessage().has_value());
+    REQUIRE(unpacker.endOfTx());
+    REQUIRE(unpacker.packetsReceived() == num_messages / messages_per_packet + 1);
+}
+
+TEST_CASE("Message aggregator sends packets after the maximum delay", "[arq/common]")
+{
+    std::mutex mut;
+    std::vector<arq::DataPacket> packets;
+    arq::MessageAggregator aggregator{1,
+                                      [&](arq::DataPacket&& pkt) {
+                                          std::unique_lock lock(mut);
+                                          packets.push_back(pkt);
+                                      },
+                                      1ms};
+    aggregator.sendMessage(make_message(10, 1));
+    aggregator.sendMessage(make_message(20, 2));
+
+    for (int i = 0; i < 1000; ++i) {
+        if (aggregator.packetsSent() > 0) {
+            break;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    std::unique_lock lock(mut);
+    REQUIRE(packets.size() == 1);
+    REQUIRE(packets.front().getHeader().length_ == 10 + 20 + 2 * sizeof(uint16_t));
+}
+
+TEST_CASE("Message aggregator without delay sends each message immediately", "[arq/common]")
+{
+    std::vector<arq::DataPacket> packets;
+    arq::MessageAggregator aggregator{1, [&packets](arq::DataPacket&& pkt) { packets.push_back(pkt); }, 0us};
+    aggregator.sendMessage(make_message(10, 1));
+    aggregator.sendMessage({});
+    REQUIRE(packets.size() == 2);
+    // An empty message still has its length, so is not mistaken for an EoT packet
+    REQUIRE_FALSE(packets.back().isEndOfTx());
+
+    aggregator.sendMessage(make_message(max_aggregated_message_size, 1));
+    REQUIRE(packets.size() == 3);
+    REQUIRE(packets.back().getHeader().length_ == max_payload_size);
+}
+
+TEST_CASE("Message aggregator fragments large messages", "[arq/common]")
+{
+    std::deque<arq::DataPacket> packets;
+    const auto large_message = make_message(3 * max_payload_size, 2);
+    {
+        arq::MessageAggregator aggregator{1, [&packets](arq::DataPacket&& pkt) { packets.push_back(pkt); }, 1h};
+        aggregator.sendMessage(make_message(10, 1));
+        aggregator.sendMessage(large_message);
+        aggregator.sendMessage(make_message(max_aggregated_message_size + 1, 3));
+        aggregator.sendMessage(make_message(10, 4));
+    }
+
+    // The pending message is sent ahead of the fragments, which allow for the total length in the first
+    REQUIRE(packets.size() == 1 + 4 + 2 + 1);
+    REQUIRE(packets[0].getHeader().flags_ == arq::UNFRAGMENTED);
+    REQUIRE(packets[1].getHeader().flags_ == arq::FIRST_FRAGMENT);
+    REQUIRE(packets[2].getHeader().flags_ == 0);
+    REQUIRE(packets[3].getHeader().flags_ == 0);
+    REQUIRE(packets[4].getHeader().flags_ == arq::LAST_FRAGMENT);
+    REQUIRE(packets[4].getHeader().length_ == sizeof(uint32_t));
+    REQUIRE(packets[5].getHeader().flags_ == arq::FIRST_FRAGMENT);
+    REQUIRE(packets[6].getHeader().flags_ == arq::LAST_FRAGMENT);
+    REQUIRE(packets[7].getHeader().flags_ == arq::UNFRAGMENTED);
+
+    // Messages are reassembled in order
+    packets.push_back(arq::DataPacket{});
+    arq::MessageUnpacker unpacker{[&packets]() -> std::optional<arq::ReceiveBufferObject> {
+        if (packets.empty()) {
+            return std::nullopt;
+        }
+        arq::ReceiveBufferObject obj{.packet_ = std::move(packets.front()), .rxTime_ = arq::ClockType::now()};
+        packets.pop_front();
+        return obj;
+    }};
+    REQUIRE(std::ranges::equal(unpacker.tryGetMessage().value(), make_message(10, 1)));
+    REQUIRE(std::ranges::equal(unpacker.tryGetMessage().value(), large_message));
+    REQUIRE(std::ranges::equal(unpacker.tryGetMessage().value(),
+                               make_message(max_aggregated_message_size + 1, 3)));
+    REQUIRE(std::ranges::equal(unpacker.tryGetMessage().value(), make_message(10, 4)));
+    REQUIRE_FALSE(unpacker.tryGetMessage().has_value());
+    REQUIRE(unpacker.endOfTx());
+}
+
+TEST_CASE("Message aggregator fills packets up to the MTU", "[arq/common]")
+{
+    constexpr size_t jumbo_mtu = 9000;
+    std::vector<arq::DataPacket> packets;
+    arq::MessageAggregator aggregator{
+        1, [&packets](arq::DataPacket&& pkt) { packets.push_back(pkt); }, 0us, jumbo_mtu};
+    REQUIRE(aggregator.maxAggregatedMessageSize() == arq::maxPayloadSize(jumbo_mtu) - sizeof(uint16_t));
+
+    // A message too large for the default MTU still fits in a single packet
+    aggregator.sendMessage(make_message(aggregator.maxAggregatedMessageSize(), 1));
+    REQUIRE(packets.size() == 1);
+    REQUIRE(packets.back().getReadSpan().size() == jumbo_mtu);
+
+    aggregator.sendMessage(make_message(aggregator.maxAggregatedMessageSize() + 1, 2));
+    REQUIRE(packets.size() == 3);
+    REQUIRE(packets[1].getHeader().flags_ == arq::FIRST_FRAGMENT);
+    REQUIRE(packets[1].getReadSpan().size() == jumbo_mtu);
+}
+
+TEST_CASE("Message unpacker discards malformed messages", "[arq/common]")
+{
+    // A length which overruns the payload
+    arq::DataPacket pkt{};
+    pkt.updateDataLength(4);
+    pkt.getPayloadSpan()[1] = std::byte{10};
+
+    bool supplied = false;
+    arq::MessageUnpacker unpacker{[&]() -> std::optional<arq::ReceiveBufferObject> {
+        if (std::exchange(supplied, true)) {
+            return std::nullopt;
+        }
+        return arq::ReceiveBufferObject{.packet_ = pkt, .rxTime_ = arq::ClockType::now()};
+    }};
+    REQUIRE_FALSE(unpacker.tryGetMessage().has_value());
+    REQUIRE_FALSE(unpacker.endOfTx());
+    REQUIRE(unpacker.packetsReceived() == 1);
+
+    // A fragment with no first fragment
+    arq::DataPacket fragment{};
+    fragment.updateDataLength(4);
+    fragment.updateFlags(arq::LAST_FRAGMENT);
+    supplied = false;
+    pkt = fragment;
+    REQUIRE_FALSE(unpacker.tryGetMessage().has_value());
+    REQUIRE(unpacker.packetsReceived() == 2);
+}
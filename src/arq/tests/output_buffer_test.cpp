@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "arq/common/output_buffer.hpp"
+
+// Returns a packet with the given sequence number
+static arq::DataPacket make_packet(arq::SequenceNumber sn)
+{
+    return arq::DataPacket{arq::DataPacketHeader{.sequenceNumber_ = sn, .length_ = 10}};
+}
+
+constexpr uint16_t capacity = 4;
+
+TEST_CASE("Output buffer receive window follows occupancy", "[arq/common]")
+{
+    arq::OutputBuffer buffer{capacity};
+
+    // Nothing has been acknowledged, so the whole buffer is available
+    const auto noneAcked = static_cast<arq::SequenceNumber>(arq::FIRST_SEQUENCE_NUMBER - 1);
+    REQUIRE(buffer.receiveWindow(noneAcked) == capacity);
+
+    for (arq::SequenceNumber sn = arq::FIRST_SEQUENCE_NUMBER; sn < capacity; ++sn) {
+        REQUIRE(buffer.addPacket(make_packet(sn)));
+        REQUIRE(buffer.receiveWindow(sn) == capacity - sn - 1);
+    }
+    REQUIRE(buffer.full());
+    REQUIRE_FALSE(buffer.addPacket(make_packet(capacity)));
+    REQUIRE(buffer.receiveWindow(capacity - 1) == 0);
+
+    // The window reopens as the reader drains the buffer
+    REQUIRE(buffer.tryGetPacket().has_value());
+    REQUIRE(buffer.receiveWindow(capacity - 1) == 1);
+    while (buffer.tryGetPacket().has_value()) {
+    }
+    REQUIRE(buffer.receiveWindow(capacity - 1) == capacity);
+}
+
+TEST_CASE("Output buffer receive window allows for acknowledged packets not yet added", "[arq/common]")
+{
+    arq::OutputBuffer buffer{capacity};
+    REQUIRE(buffer.addPacket(make_packet(arq::FIRST_SEQUENCE_NUMBER)));
+
+    // SNs 1 and 2 have been acknowledged but are still held in the RS buffer
+    REQUIRE(buffer.receiveWindow(arq::FIRST_SEQUENCE_NUMBER + 2) == capacity - 3);
+    REQUIRE(buffer.receiveWindow(arq::FIRST_SEQUENCE_NUMBER + 3) == 0);
+    REQUIRE(buffer.receiveWindow(arq::FIRST_SEQUENCE_NUMBER + 10) == 0);
+
+    REQUIRE(buffer.addPacket(make_packet(arq::FIRST_SEQUENCE_NUMBER + 1)));
+    REQUIRE(buffer.receiveWindow(arq::FIRST_SEQUENCE_NUMBER + 2) == capacity - 3);
+}
+
+TEST_CASE("Output buffer receive window across SN roll-over", "[arq/common]")
+{
+    arq::OutputBuffer buffer{capacity};
+
+    // Pass packets through the buffer until the next SN to be added is two before roll-over
+    for (arq::SequenceNumber sn = arq::FIRST_SEQUENCE_NUMBER; sn != arq::MAX_SEQUENCE_NUMBER - 1; ++sn) {
+        REQUIRE(buffer.addPacket(make_packet(sn)));
+        REQUIRE(buffer.tryGetPacket().has_value());
+    }
+    REQUIRE(buffer.nextSequenceNumber() == arq::MAX_SEQUENCE_NUMBER - 1);
+    REQUIRE(buffer.receiveWindow(arq::MAX_SEQUENCE_NUMBER - 2) == capacity);
+
+    // Acknowledged packets either side of roll-over count against the window
+    REQUIRE(buffer.receiveWindow(arq::MAX_SEQUENCE_NUMBER) == capacity - 2);
+    REQUIRE(buffer.receiveWindow(arq::FIRST_SEQUENCE_NUMBER) == capacity - 3);
+
+    REQUIRE(buffer.addPacket(make_packet(arq::MAX_SEQUENCE_NUMBER - 1)));
+    REQUIRE(buffer.addPacket(make_packet(arq::MAX_SEQUENCE_NUMBER)));
+    REQUIRE(buffer.nextSequenceNumber() == arq::FIRST_SEQUENCE_NUMBER);
+    REQUIRE(buffer.receiveWindow(arq::MAX_SEQUENCE_NUMBER) == capacity - 2);
+    REQUIRE(buffer.receiveWindow(arq::FIRST_SEQUENCE_NUMBER) == capacity - 3);
+}
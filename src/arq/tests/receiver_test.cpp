@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "arq/receiver.hpp"
+#include "arq/resequencing_buffers/go_back_n_rs.hpp"
+
+// Stands in for a socket: datagrams queued by the test are returned by rxFn, and ACKs sent by the receiver are
+// collected from txFn.
+struct LoopbackChannel {
+    util::SafeQueue<std::vector<std::byte>> datagrams_;
+    util::SafeQueue<arq::ControlPacket> acks_;
+
+    arq::TransmitFn txFn()
+    {
+        return [this](std::span<const std::byte> buffer) -> std::optional<size_t> {
+            arq::ControlPacket ack;
+            if (!ack.deserialise(buffer)) {
+                return std::nullopt;
+            }
+            acks_.push(std::move(ack));
+            return buffer.size();
+        };
+    }
+
+    arq::ReceiveFn rxFn()
+    {
+        return [this](std::span<std::byte> buffer, arq::RxTimestamp&) -> std::optional<size_t> {
+            auto datagram = datagrams_.try_pop();
+            if (!datagram.has_value()) {
+                return std::nullopt;
+            }
+            std::copy(datagram->begin(), datagram->end(), buffer.begin());
+            return datagram->size();
+        };
+    }
+
+    // Queues a checksummed packet with the given SN. A payload length of zero marks the End of Tx.
+    void sendPacket(arq::ConversationID id, arq::SequenceNumber sn, uint16_t length = 10)
+    {
+        arq::DataPacket packet{arq::DataPacketHeader{.id_ = id, .sequenceNumber_ = sn, .length_ = length}};
+        packet.updateCheckSum();
+        const auto serialised = packet.getReadSpan();
+        datagrams_.push(std::vector<std::byte>(serialised.begin(), serialised.end()));
+    }
+};
+
+TEST_CASE("Receiver drops datagrams shorter than a packet header", "[arq]")
+{
+    constexpr arq::ConversationID id = 201;
+    auto& corruptPackets = util::MetricsRegistry::global().counter(
+        "arq_corrupt_packets_total", "", {{"conversation", std::to_string(id)}});
+    const auto corruptBefore = corruptPackets.value();
+
+    LoopbackChannel channel;
+    channel.datagrams_.push(std::vector<std::byte>(arq::DataPacketHeader::size() - 1));
+    channel.sendPacket(id, arq::FIRST_SEQUENCE_NUMBER, 0);
+    {
+        arq::Receiver<arq::rs::GoBackN> receiver{
+            id, channel.txFn(), channel.rxFn(), std::make_unique<arq::rs::GoBackN>()};
+    }
+
+    // The runt is counted as corrupt, and the receiver goes on to acknowledge the End of Tx
+    REQUIRE(corruptPackets.value() == corruptBefore + 1);
+    REQUIRE(channel.acks_.pop_wait().sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER);
+}
+
+TEST_CASE("Receiver drops packets beyond the receive window", "[arq]")
+{
+    constexpr arq::ConversationID id = 202;
+    auto& receiveWindowDrops = util::MetricsRegistry::global().counter(
+        "arq_receive_window_drops_total", "", {{"conversation", std::to_string(id)}});
+    const auto dropsBefore = receiveWindowDrops.value();
+
+    // With room for two packets, the third is beyond the window until the reader drains the output buffer
+    constexpr uint16_t output_buffer_capacity = 2;
+    LoopbackChannel channel;
+    for (arq::SequenceNumber sn = arq::FIRST_SEQUENCE_NUMBER; sn < 3; ++sn) {
+        channel.sendPacket(id, sn);
+    }
+    arq::Receiver<arq::rs::GoBackN> receiver{id,
+                                             channel.txFn(),
+                                             channel.rxFn(),
+                                             std::make_unique<arq::rs::GoBackN>(),
+                                             nullptr,
+                                             arq::ThreadingMode::SPLIT,
+                                             {},
+                                             output_buffer_capacity};
+
+    auto ack = channel.acks_.pop_wait();
+    REQUIRE(ack.sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER);
+    REQUIRE(ack.receiveWindow_ == 1);
+    ack = channel.acks_.pop_wait();
+    REQUIRE(ack.sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER + 1);
+    REQUIRE(ack.receiveWindow_ == 0);
+
+    // The third packet is answered with the last ACK and the current window
+    ack = channel.acks_.pop_wait();
+    REQUIRE(ack.sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER + 1);
+    REQUIRE(ack.receiveWindow_ == 0);
+    REQUIRE(receiveWindowDrops.value() == dropsBefore + 1);
+
+    // Once the reader has made room, the retransmitted packet is accepted
+    REQUIRE(receiver.getPacket().packet_.getHeader().sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER);
+    REQUIRE(receiver.getPacket().packet_.getHeader().sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER + 1);
+    channel.sendPacket(id, arq::FIRST_SEQUENCE_NUMBER + 2, 0);
+    ack = channel.acks_.pop_wait();
+    REQUIRE(ack.sequenceNumber_ == arq::FIRST_SEQUENCE_NUMBER + 2);
+    REQUIRE(ack.receiveWindow_ == output_buffer_capacity - 1);
+    REQUIRE(receiveWindowDrops.value() == dropsBefore + 1);
+}
@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <ranges>
+
+#include "arq/common/transmit_window.hpp"
+
+using namespace std::chrono_literals;
+
+// Returns a Tx buffer object with the given sequence number and last transmission time
+static arq::TransmitBufferObject get_tx_buffer_object(arq::SequenceNumber sn, arq::TransmitWindow::TimePoint lastTxTime)
+{
+    arq::DataPacket pkt{};
+    pkt.updateSequenceNumber(sn);
+    pkt.updateDataLength(sn % 100);
+    std::ranges::fill(pkt.getPayloadSpan(), static_cast<std::byte>(sn));
+    return arq::TransmitBufferObject{
+        .packet_ = std::move(pkt),
+        .info_ = {.firstTxTime_ = lastTxTime, .lastTxTime_ = lastTxTime, .sequenceNumber_ = sn}};
+}
+
+TEST_CASE("Transmit window - packets are copied into the arena", "[arq/common]")
+{
+    constexpr uint16_t window_size = 20;
+    constexpr arq::SequenceNumber first_seq_num = 100;
+    arq::TransmitWindow window{window_size, first_seq_num};
+    const auto now = arq::ClockType::now();
+
+    for (const auto sn : std::views::iota(first_seq_num) | std::views::take(window_size)) {
+        REQUIRE(window.insert(get_tx_buffer_object(sn, now)));
+    }
+    REQUIRE(window.full());
+
+    // SNs already present or outside the window are rejected
+    REQUIRE_FALSE(window.insert(get_tx_buffer_object(first_seq_num, now)));
+    REQUIRE_FALSE(window.insert(get_tx_buffer_object(first_seq_num + window_size, now)));
+
+    for (const auto sn : std::views::iota(first_seq_num) | std::views::take(window_size)) {
+        const auto expected = get_tx_buffer_object(sn, now);
+        REQUIRE(std::ranges::equal(window.retransmit(sn, now), expected.packet_.getReadSpan()));
+        REQUIRE(window.retransmitCount(sn) == 1);
+    }
+
+    REQUIRE(window.holds(first_seq_num + 4));
+    REQUIRE(window.releaseUntil(first_seq_num + 5) == 5);
+    REQUIRE_FALSE(window.holds(first_seq_num + 4));
+    REQUIRE(window.holds(first_seq_num + 5));
+    REQUIRE_FALSE(window.holds(first_seq_num + window_size));
+    REQUIRE(window.count() == window_size - 5);
+    REQUIRE(window.insert(get_tx_buffer_object(first_seq_num + window_size, now)));
+}
+
+TEST_CASE("Transmit window - find earliest timed out packet", "[arq/common]")
+{
+    constexpr uint16_t window_size = 10;
+    constexpr arq::SequenceNumber first_seq_num = arq::MAX_SEQUENCE_NUMBER - 4;
+    arq::TransmitWindow window{window_size, first_seq_num};
+    const auto now = arq::ClockType::now();
+
+    REQUIRE_FALSE(window.findLastTxBefore(now).has_value());
+
+    // Packets either side of SN roll-over, with only the later ones timed out
+    for (size_t i = 0; i < window_size; ++i) {
+        const auto sn = static_cast<arq::SequenceNumber>(first_seq_num + i);
+        REQUIRE(window.insert(get_tx_buffer_object(sn, i < 7 ? now : now - 1s)));
+    }
+
+    REQUIRE(window.findLastTxBefore(now - 500ms) == 2);
+    REQUIRE(window.findLastTxBefore(now + 1ms) == first_seq_num);
+
+    // Once retransmitted, a packet is no longer timed out
+    window.retransmit(2, now);
+    REQUIRE(window.lastTxTime(2) == now);
+    REQUIRE(window.findLastTxBefore(now - 500ms) == 3);
+}
+
+TEST_CASE("Transmit window - packets up to the MTU are accepted", "[arq/common]")
+{
+    constexpr size_t jumbo_mtu = 9000;
+    arq::TransmitWindow window{10, 0, jumbo_mtu};
+    REQUIRE(window.mtu() == jumbo_mtu);
+    const auto now = arq::ClockType::now();
+
+    auto packet = get_tx_buffer_object(0, now);
+    packet.packet_.updateDataLength(arq::maxPayloadSize(jumbo_mtu));
+    std::ranges::fill(packet.packet_.getPayloadSpan(), std::byte{0x5A});
+    REQUIRE(window.insert(packet));
+    REQUIRE(std::ranges::equal(window.retransmit(0, now), packet.packet_.getReadSpan()));
+
+    // Neighbouring slots do not overlap
+    REQUIRE(window.insert(get_tx_buffer_object(1, now)));
+    REQUIRE(std::ranges::equal(window.retransmit(0, now), packet.packet_.getReadSpan()));
+
+    // A packet larger than the MTU is rejected
+    auto oversized = get_tx_buffer_object(2, now);
+    oversized.packet_.updateDataLength(arq::maxPayloadSize(jumbo_mtu) + 1);
+    REQUIRE_THROWS_AS(window.insert(oversized), arq::ArqProtocolException);
+    REQUIRE_FALSE(window.holds(2));
+}
+
+TEST_CASE("Transmit window - localising keeps the window's contents", "[arq/common]")
+{
+    constexpr uint16_t window_size = 100;
+    constexpr arq::SequenceNumber first_seq_num = 10;
+    arq::TransmitWindow window{window_size, first_seq_num};
+    const auto now = arq::ClockType::now();
+
+    for (const auto sn : std::views::iota(first_seq_num) | std::views::take(70)) {
+        REQUIRE(window.insert(get_tx_buffer_object(sn, now)));
+    }
+    window.retransmit(first_seq_num + 1, now + 1ms);
+    window.localise();
+
+    REQUIRE(window.count() == 70);
+    REQUIRE(window.retransmitCount(first_seq_num) == 0);
+    REQUIRE(window.retransmitCount(first_seq_num + 1) == 1);
+    REQUIRE(window.lastTxTime(first_seq_num + 1) == now + 1ms);
+    REQUIRE(window.findLastTxBefore(now + 1ms) == first_seq_num);
+    for (const auto sn : std::views::iota(static_cast<arq::SequenceNumber>(first_seq_num + 2)) | std::views::take(68)) {
+        REQUIRE(std::ranges::equal(window.retransmit(sn, now), get_tx_buffer_object(sn, now).packet_.getReadSpan()));
+    }
+    REQUIRE(window.insert(get_tx_buffer_object(first_seq_num + 70, now)));
+}
@@ -1,16 +1,24 @@
 #ifndef _ARQ_TRANSMITTER_HPP_
 #define _ARQ_TRANSMITTER_HPP_
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <format>
 #include <memory>
+#include <optional>
 #include <thread>
 
 #include "arq/common/arq_common.hpp"
 #include "arq/common/conversation_id.hpp"
 #include "arq/common/input_buffer.hpp"
+#include "arq/common/latency_stats.hpp"
+#include "arq/common/protocol_metrics.hpp"
 #include "arq/common/retransmission_buffer.hpp"
 
 #include "util/logging.hpp"
+#include "util/thread_placement.hpp"
+#include "util/trace.hpp"
 
 namespace arq {
 
@@ -20,13 +28,28 @@ concept RTBuffer = std::is_base_of<RetransmissionBuffer<T>, T>::value;
 template <RTBuffer RTBufferType>
 class Transmitter {
 public:
-    Transmitter(ConversationID id, TransmitFn txFn, ReceiveFn rxFn, std::unique_ptr<RTBufferType>&& rtBuffer_p) :
+    Transmitter(ConversationID id,
+                TransmitFn txFn,
+                ReceiveFn rxFn,
+                std::unique_ptr<RTBufferType>&& rtBuffer_p,
+                std::shared_ptr<LatencyStats> latencyStats = nullptr,
+                ThreadingMode threadingMode = ThreadingMode::SPLIT,
+                util::PlacementPolicy placement = {},
+                InputBufferPolicy inputBufferPolicy = {}) :
         id_{id},
         txFn_{txFn},
         rxFn_{rxFn},
+        threadingMode_{threadingMode},
+        placement_{std::move(placement)},
+        inputBuffer_{FIRST_SEQUENCE_NUMBER, std::move(inputBufferPolicy)},
         retransmissionBuffer_{std::move(rtBuffer_p)},
-        transmitThread_{[this]() { return this->transmitThread(); }},
-        ackThread_{[this]() { return this->ackThread(); }},
+        latencyStats_{std::move(latencyStats)},
+        metrics_{id},
+        transmitThread_{[this]() {
+            return threadingMode_ == ThreadingMode::SPLIT ? this->transmitThread() : this->runToCompletionThread();
+        }},
+        ackThread_{threadingMode == ThreadingMode::SPLIT ? std::thread{[this]() { return this->ackThread(); }}
+                                                         : std::thread{}},
         ackQueue_{},
         endOfTxSeqNum_{std::nullopt},
         endOfTxAcked_{false}
@@ -44,9 +67,50 @@ public:
         util::logDebug("Transmitter exiting");
     }
 
-    void sendPacket(arq::DataPacket&& packet) { inputBuffer_.addPacket(std::move(packet)); }
+    // Submit a packet for transmission, waiting for room if the input buffer is full. An open-loop sender gives the
+    // time at which the packet was scheduled to be sent, so that any delay in submitting it counts towards its
+    // queueing delay.
+    void sendPacket(arq::DataPacket&& packet, std::optional<std::chrono::time_point<ClockType>> dueTime = std::nullopt)
+    {
+        // Count the packet once it is queued, rather than while the sender waits for room
+        inputBuffer_.addPacket(std::move(packet), dueTime);
+        metrics_.inputBufferDepth_.add(1);
+    }
+
+    // As sendPacket, but if the input buffer is full, return SendStatus::FULL at once, leaving the packet with the
+    // caller to retry or drop
+    SendStatus trySendPacket(arq::DataPacket&& packet,
+                             std::optional<std::chrono::time_point<ClockType>> dueTime = std::nullopt)
+    {
+        const auto status = inputBuffer_.tryAddPacket(std::move(packet), dueTime);
+        if (status == SendStatus::QUEUED) {
+            metrics_.inputBufferDepth_.add(1);
+        }
+        else {
+            metrics_.inputBufferFull_.increment();
+        }
+        return status;
+    }
+
+    // Has an EoT packet been transmitted and acknowledged?
+    bool finished() const noexcept { return endOfTxAcked_; }
+
+    // Number of packets submitted which are yet to be transmitted for the first time. The depth is counted after a
+    // packet is queued, so may briefly fall below zero if the transmit thread takes the packet first.
+    size_t queuedPackets() const noexcept
+    {
+        return static_cast<size_t>(std::max<int64_t>(metrics_.inputBufferDepth_.value(), 0));
+    }
 
 private:
+    // An ACK passed from the ACK thread to the transmit thread
+    struct ReceivedAck {
+        SequenceNumber sequenceNumber_;
+        uint16_t receiveWindow_;
+        // The time at which the ACK arrived, from which an RTT sample is taken
+        std::chrono::time_point<ClockType> rxTime_;
+    };
+
     // Transmits data using the transmit function.
     void transmitPacketData(auto dataToTx) const
     {
@@ -69,6 +133,8 @@ private:
             hdr.deserialise(packetSpanToReTx.value());
 
             util::logInfo("Retransmitting packet with SN {} and length {}", hdr.sequenceNumber_, hdr.length_);
+            util::trace(util::TraceEvent::PACKET_RETX, hdr.id_, hdr.sequenceNumber_);
+            metrics_.timeoutRetransmissions_.increment();
             transmitPacketData(packetSpanToReTx.value());
         }
         return packetAvailable;
@@ -84,6 +150,7 @@ private:
         auto newPkt = inputBuffer_.tryGetPacket();
         bool packetAvailable = newPkt.has_value();
         if (packetAvailable) {
+            metrics_.inputBufferDepth_.add(-1);
             if (newPkt->isEndOfTx()) {
                 util::logInfo("Transmitter received end of EndofTx from input buffer");
                 endOfTxSeqNum_ = newPkt->info_.sequenceNumber_;
@@ -91,33 +158,86 @@ private:
 
             util::logInfo("Transmitting packet with SN {} and adding to retransmission buffer",
                           newPkt->info_.sequenceNumber_);
+            util::trace(util::TraceEvent::PACKET_TX, id_, newPkt->info_.sequenceNumber_);
+            // Time the first transmission from here rather than from entry to the input buffer, so that queueing
+            // delay counts towards neither the timeout nor the RTT
+            newPkt->updateLastTxTime();
+            if (latencyStats_ != nullptr && !newPkt->isEndOfTx()) {
+                latencyStats_->packetSent(
+                    newPkt->info_.sequenceNumber_, newPkt->info_.dueTime_, newPkt->info_.lastTxTime_);
+            }
             transmitPacketData(newPkt->packet_.getReadSpan());
+            metrics_.packetsSent_.increment();
 
             retransmissionBuffer_->addPacket(std::move(newPkt.value()));
+            metrics_.windowOccupancy_.set(retransmissionBuffer_->packetCount());
+            metrics_.rtBufferBytes_.set(retransmissionBuffer_->memoryUsage());
         }
         return packetAvailable;
     }
 
+    // Passes an ACK which arrived at rxTime, and the receive window it advertises, to the RT buffer.
+    void processAck(const SequenceNumber snToAck,
+                    const uint16_t receiveWindow,
+                    const std::chrono::time_point<ClockType> rxTime)
+    {
+        if (snToAck == endOfTxSeqNum_) {
+            endOfTxAcked_ = true;
+        }
+        else {
+            if (const auto rttSample = retransmissionBuffer_->acknowledgePacket(snToAck, rxTime);
+                rttSample.has_value()) {
+                metrics_.rttMicroseconds_.set(rttSample->count());
+            }
+            retransmissionBuffer_->updateReceiveWindow(receiveWindow);
+            metrics_.receiveWindow_.set(receiveWindow);
+            metrics_.windowOccupancy_.set(retransmissionBuffer_->packetCount());
+            metrics_.rtBufferBytes_.set(retransmissionBuffer_->memoryUsage());
+        }
+    }
+
     // Passes every sequence number from the ACK queue to the RT buffer for acknowledgement.
     void processAckQueue()
     {
-        for (std::optional<SequenceNumber> snToAck;
+        for (std::optional<ReceivedAck> snToAck;
              !endOfTxAcked_ && ((snToAck = ackQueue_.try_pop()) != std::nullopt);) {
             assert(snToAck.has_value());
-            if (snToAck == endOfTxSeqNum_) {
-                endOfTxAcked_ = true;
-            }
-            else {
-                retransmissionBuffer_->acknowledgePacket(snToAck.value());
-            }
+            metrics_.ackQueueDepth_.add(-1);
+            processAck(snToAck->sequenceNumber_, snToAck->receiveWindow_, snToAck->rxTime_);
+        }
+    }
+
+    // Decodes an ACK which arrived from the receiver at rxTime, returning it if it is valid.
+    std::optional<ControlPacket> decodeAck(std::span<const std::byte> ackData,
+                                           const std::chrono::time_point<ClockType> rxTime)
+    {
+        arq::ControlPacket ack;
+        if (!ack.deserialise(ackData)) {
+            util::logWarning("Received packet that is too short to be an ACK");
+            return std::nullopt;
         }
+
+        util::logInfo("Received ACK for SN {} with receive window {}", ack.sequenceNumber_, ack.receiveWindow_);
+        util::trace(util::TraceEvent::ACK_RX, id_, ack.sequenceNumber_, rxTime);
+        metrics_.acksReceived_.increment();
+        return ack;
     }
 
     // The transmit thread handles transmission and retransmission of all packets. It continues
     // running until an ACK corresponding to an end of transmission (EoT) packet has been received.
     void transmitThread()
     {
+        util::applyPlacement(placement_, 0, std::format("arq-tx{}", id_));
         util::logInfo("Transmitter Tx thread started");
+        // The buffer was constructed on another thread, so move its window onto this thread's NUMA node
+        if (!placement_.cpus_.empty()) {
+            retransmissionBuffer_->localise();
+        }
+        if (placement_.prefault_) {
+            retransmissionBuffer_->prefault();
+        }
+        metrics_.rtoMicroseconds_.set(retransmissionBuffer_->timeoutInterval().count());
+        metrics_.rtBufferBytes_.set(retransmissionBuffer_->memoryUsage());
 
         while (!endOfTxAcked_) {
             if (!attemptPacketRetransmission()) {
@@ -136,22 +256,22 @@ private:
     // an ACK is received for an EoT packet.
     void ackThread()
     {
+        util::applyPlacement(placement_, 1, std::format("arq-tx{}-ack", id_));
         util::logInfo("Transmitter ACK thread started");
 
         while (!endOfTxAcked_) {
             // If an ACK is recieved, add it to the ACK queue.
-            std::array<std::byte, arq::MAX_TRANSMISSION_UNIT> recvBuffer;
-            auto receivedBytes = rxFn_(recvBuffer);
+            std::array<std::byte, arq::MAX_SUPPORTED_MTU> recvBuffer;
+            RxTimestamp rxTime;
+            auto receivedBytes = rxFn_(recvBuffer, rxTime);
             if (receivedBytes > 0) {
-                arq::SequenceNumber receivedSequenceNumber;
-                if (arq::deserialiseSeqNum(receivedSequenceNumber, recvBuffer)) {
-                    util::logInfo("Received ACK for SN {}", receivedSequenceNumber);
-
-                    // WJG: we shouldn't have to move here - check queue implementation
-                    ackQueue_.push(std::move(receivedSequenceNumber));
-                }
-                else {
-                    util::logWarning("Received packet that is too short to be an ACK");
+                const auto ackTime = rxTime.value_or(ClockType::now());
+                auto ack = decodeAck(std::span(recvBuffer).first(receivedBytes.value()), ackTime);
+                if (ack.has_value()) {
+                    metrics_.ackQueueDepth_.add(1);
+                    ackQueue_.push({.sequenceNumber_ = ack->sequenceNumber_,
+                                    .receiveWindow_ = ack->receiveWindow_,
+                                    .rxTime_ = ackTime});
                 }
             }
             else {
@@ -162,23 +282,68 @@ private:
         util::logInfo("Transmitter ACK thread exited");
     }
 
+    // In run-to-completion mode, a single thread replaces the transmit and ACK threads. Before each transmission, it
+    // drains the non-blocking socket and applies every ACK to the RT buffer directly, without a queue or a second
+    // thread. It busy-polls until an ACK corresponding to an EoT packet has been received.
+    void runToCompletionThread()
+    {
+        util::applyPlacement(placement_, 0, std::format("arq-tx{}", id_));
+        util::logInfo("Transmitter run-to-completion thread started");
+        // The buffer was constructed on another thread, so move its window onto this thread's NUMA node
+        if (!placement_.cpus_.empty()) {
+            retransmissionBuffer_->localise();
+        }
+        if (placement_.prefault_) {
+            retransmissionBuffer_->prefault();
+        }
+        metrics_.rtoMicroseconds_.set(retransmissionBuffer_->timeoutInterval().count());
+        metrics_.rtBufferBytes_.set(retransmissionBuffer_->memoryUsage());
+
+        std::array<std::byte, arq::MAX_SUPPORTED_MTU> recvBuffer;
+        RxTimestamp rxTime;
+        while (!endOfTxAcked_) {
+            for (auto receivedBytes = rxFn_(recvBuffer, rxTime); !endOfTxAcked_ && receivedBytes > 0;
+                 receivedBytes = rxFn_(recvBuffer, rxTime)) {
+                const auto ackTime = rxTime.value_or(ClockType::now());
+                if (auto ack = decodeAck(std::span(recvBuffer).first(receivedBytes.value()), ackTime);
+                    ack.has_value()) {
+                    processAck(ack->sequenceNumber_, ack->receiveWindow_, ackTime);
+                }
+            }
+
+            if (!endOfTxAcked_ && !attemptPacketRetransmission()) {
+                attemptNewPacketTransmission();
+            }
+        }
+
+        util::logInfo("Transmitter run-to-completion thread exited");
+    }
+
     // Identifies the current conversation (TO DO: issue #24)
     ConversationID id_;
     // Function pointer for raw data transmission
     TransmitFn txFn_;
     // Function pointer for raw data reception
     ReceiveFn rxFn_;
+    // Whether data and ACKs are handled on separate threads
+    ThreadingMode threadingMode_;
+    // CPUs and scheduling class for the threads below, in the order they are created
+    util::PlacementPolicy placement_;
     // Store packets for transmission that are yet to be transmitted
     InputBuffer inputBuffer_;
     // Store packets that have been transmitted but not acknowledged, and so may
     // require retransmission
     std::unique_ptr<RTBufferType> retransmissionBuffer_;
-    // Thread handling data packet transmission and retransmission
+    // If set, records the time at which each packet entered the input buffer (shared with the Receiver)
+    std::shared_ptr<LatencyStats> latencyStats_;
+    // Counters and gauges exported for this conversation
+    TransmitterMetrics metrics_;
+    // Thread handling data packet transmission and retransmission, and in run-to-completion mode, ACKs
     std::thread transmitThread_;
-    // Thread handling reception of ACKs for processing by the transmit thread
+    // Thread handling reception of ACKs for processing by the transmit thread (split mode only)
     std::thread ackThread_;
     // Keeps track of ACKs received at the transmitter
-    util::SafeQueue<SequenceNumber> ackQueue_; // wjg: arguably, this should be a priority queue
+    util::SafeQueue<ReceivedAck> ackQueue_; // wjg: arguably, this should be a priority queue
     // If an EoT has been received, store the sequence number
     std::optional<SequenceNumber> endOfTxSeqNum_;
     // Has an EoT packet been transmitted and acknowledged?
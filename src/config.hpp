@@ -2,6 +2,7 @@
 #define _LAUNCHER_CONFIG_HPP_
 
 #include <array>
+#include <chrono>
 #include <optional>
 #include <stdexcept>
 #include <string_view>
@@ -10,6 +11,10 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 
+#include "util/metrics.hpp"
+#include "util/thread_placement.hpp"
+#include "util/workload.hpp"
+
 namespace arq {
 
 struct config_AddressInfo {
@@ -40,10 +45,28 @@ struct config_common {
     config_AddressInfo clientNames;
     ArqProtocol arqProtocol;
     std::optional<uint16_t> windowSize;
+    std::optional<std::string> traceFile;
+    bool asyncLogging;
+    std::optional<std::string> latencyHistogramFile;
+    std::optional<std::string> metricsFile;
+    std::optional<std::string> metricsSocket;
+    util::MetricsFormat metricsFormat;
+    uint16_t executorThreads;
+    uint16_t sessions;
+    bool runToCompletion;
+    bool lowLatency;
+    util::PlacementPolicy txPlacement;
+    util::PlacementPolicy rxPlacement;
+    uint16_t messageSize;
+    std::chrono::microseconds aggregationDelay;
+    bool stream;
+    size_t mtu;
+    bool probeMtu;
 };
 
 struct config_txPkts {
-    uint16_t num;
+    uint32_t num;
+    uint16_t size;
     uint16_t msInterval;
 };
 
@@ -51,9 +74,16 @@ struct config_Server {
     bool doNotVerifyClientAddr;
     config_txPkts txPkts;
     uint16_t arqTimeout;
+    util::WorkloadSpec workload;
+    bool openLoop;
+    bool throughput;
+    size_t txBufferSize;
+    bool shedLoad;
 };
 
-struct config_Client {};
+struct config_Client {
+    size_t outputBufferCapacity;
+};
 
 struct config_Launcher {
     config_common common;
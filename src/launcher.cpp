@@ -1,20 +1,34 @@
 #include <netinet/in.h>
 #include <signal.h>
+#include <sys/mman.h>
+#include <algorithm>
 #include <array>
 #include <boost/program_options.hpp>
+#include <cerrno>
 #include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
 #include <future>
 #include <iostream>
+#include <memory>
 #include <random>
 #include <ranges>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <variant>
+#include <vector>
 
 #include "config.hpp"
 
+#include "arq/async_receiver.hpp"
+#include "arq/async_transmitter.hpp"
+#include "arq/common/byte_stream.hpp"
 #include "arq/common/input_buffer.hpp"
+#include "arq/common/latency_stats.hpp"
+#include "arq/common/message_aggregator.hpp"
+#include "arq/common/protocol_metrics.hpp"
 #include "arq/receiver.hpp"
 #include "arq/resequencing_buffers/dummy_sctp_rs.hpp"
 #include "arq/resequencing_buffers/go_back_n_rs.hpp"
@@ -26,13 +40,18 @@
 #include "arq/retransmission_buffers/stop_and_wait_rt.hpp"
 #include "arq/transmitter.hpp"
 #include "util/endpoint.hpp"
+#include "util/executor.hpp"
 #include "util/logging.hpp"
+#include "util/metrics.hpp"
+#include "util/path_mtu.hpp"
+#include "util/trace.hpp"
+#include "util/workload.hpp"
 
 static_assert(std::is_same_v<std::underlying_type_t<util::LoggingLevel>, uint16_t>);
 
 struct ProgramOption {
     std::string name;
-    std::variant<std::monostate, uint16_t, std::string> defaultValue;
+    std::variant<std::monostate, uint16_t, uint32_t, std::string> defaultValue;
     std::string helpText;
 };
 
@@ -46,31 +65,101 @@ struct ProgramOption {
 #define PROG_OPTION_LAUNCH_SERVER "launch-server"
 #define PROG_OPTION_LAUNCH_CLIENT "launch-client"
 #define PROG_OPTION_TX_PKT_NUM "tx-pkt-num"
+#define PROG_OPTION_TX_PKT_SIZE "tx-pkt-size"
 #define PROG_OPTION_TX_PKT_INTERVAL "tx-pkt-interval"
 #define PROG_OPTION_ARQ_TIMEOUT "arq-timeout"
 #define PROG_OPTION_ARQ_PROTOCOL "arq-protocol"
 #define PROG_OPTION_ARQ_WINDOW_SZ "window-size"
+#define PROG_OPTION_TRACE_FILE "trace-file"
+#define PROG_OPTION_ASYNC_LOGGING "async-logging"
+#define PROG_OPTION_LATENCY_HISTOGRAM "latency-histogram"
+#define PROG_OPTION_METRICS_FILE "metrics-file"
+#define PROG_OPTION_METRICS_SOCKET "metrics-socket"
+#define PROG_OPTION_METRICS_FORMAT "metrics-format"
+#define PROG_OPTION_EXECUTOR_THREADS "executor-threads"
+#define PROG_OPTION_SESSIONS "sessions"
+#define PROG_OPTION_RUN_TO_COMPLETION "run-to-completion"
+#define PROG_OPTION_TX_CPUS "tx-cpus"
+#define PROG_OPTION_RX_CPUS "rx-cpus"
+#define PROG_OPTION_SCHED_FIFO "sched-fifo"
+#define PROG_OPTION_LOW_LATENCY "low-latency"
+#define PROG_OPTION_TX_MSG_SIZE "tx-msg-size"
+#define PROG_OPTION_AGGREGATION_DELAY "aggregation-delay"
+#define PROG_OPTION_STREAM "stream"
+#define PROG_OPTION_MTU "mtu"
+#define PROG_OPTION_PROBE_MTU "probe-mtu"
+#define PROG_OPTION_WORKLOAD "workload"
+#define PROG_OPTION_TX_RATE "tx-rate"
+#define PROG_OPTION_BURST_ON "burst-on"
+#define PROG_OPTION_BURST_OFF "burst-off"
+#define PROG_OPTION_SIZE_DIST "size-dist"
+#define PROG_OPTION_WORKLOAD_TRACE "workload-trace"
+#define PROG_OPTION_OPEN_LOOP "open-loop"
+#define PROG_OPTION_THROUGHPUT "throughput"
+#define PROG_OPTION_TX_MEGABYTES "tx-megabytes"
+#define PROG_OPTION_TX_DURATION "tx-duration"
+#define PROG_OPTION_RX_BUFFER_SIZE "rx-buffer-size"
+#define PROG_OPTION_TX_BUFFER_SIZE "tx-buffer-size"
+#define PROG_OPTION_SHED_LOAD "shed-load"
 
 using namespace std::string_literals;
 // clang-format off
 auto programOptionData = std::to_array<ProgramOption>({
-    {PROG_OPTION_HELP,            std::monostate{},                                  "display help message"},
-    {PROG_OPTION_LOGGING,         std::to_underlying(util::LOGGING_LEVEL_INFO),      util::Logger::helpText()},
-    {PROG_OPTION_SERVER_ADDR,     "127.0.0.1"s,                                      "server IPv4 address"},
-    {PROG_OPTION_SERVER_PORT,     "65534"s,                                          "server port"},
-    {PROG_OPTION_CLIENT_ADDR,     "127.0.0.1"s,                                      "client IPv4 address"},
-    {PROG_OPTION_CLIENT_PORT,     "65535"s,                                          "client port"},
-    {PROG_OPTION_LAUNCH_SERVER,   std::monostate{},                                  "start server thread"},
-    {PROG_OPTION_LAUNCH_CLIENT,   std::monostate{},                                  "start client thread"},
-    {PROG_OPTION_TX_PKT_NUM,      uint16_t{10},                                      "number of packets to transmit"},
-    {PROG_OPTION_TX_PKT_INTERVAL, uint16_t{10},                                      "ms between transmitted packets"},
-    {PROG_OPTION_ARQ_TIMEOUT,     uint16_t{50},                                      "ARQ timeout in ms"},
-    {PROG_OPTION_ARQ_PROTOCOL,    arqProtocolToString(arq::ArqProtocol::DUMMY_SCTP), "ARQ protocol to use"},
-    {PROG_OPTION_ARQ_WINDOW_SZ,   uint16_t{100},                                     "window size for GBN and SR ARQ"}
+    {PROG_OPTION_HELP,              std::monostate{},                                  "display help message"},
+    {PROG_OPTION_LOGGING,           std::to_underlying(util::LOGGING_LEVEL_INFO),      util::Logger::helpText()},
+    {PROG_OPTION_SERVER_ADDR,       "127.0.0.1"s,                                      "server IPv4 address"},
+    {PROG_OPTION_SERVER_PORT,       "65534"s,                                          "server port"},
+    {PROG_OPTION_CLIENT_ADDR,       "127.0.0.1"s,                                      "client IPv4 address"},
+    {PROG_OPTION_CLIENT_PORT,       "65535"s,                                          "client port"},
+    {PROG_OPTION_LAUNCH_SERVER,     std::monostate{},                                  "start server thread"},
+    {PROG_OPTION_LAUNCH_CLIENT,     std::monostate{},                                  "start client thread"},
+    {PROG_OPTION_TX_PKT_NUM,        uint32_t{10},                                      "number of packets to transmit"},
+    {PROG_OPTION_TX_PKT_SIZE,       uint16_t{1000},                                    "payload bytes in each transmitted packet"},
+    {PROG_OPTION_TX_PKT_INTERVAL,   uint16_t{10},                                      "ms between transmitted packets"},
+    {PROG_OPTION_ARQ_TIMEOUT,       uint16_t{50},                                      "ARQ timeout in ms"},
+    {PROG_OPTION_ARQ_PROTOCOL,      arqProtocolToString(arq::ArqProtocol::DUMMY_SCTP), "ARQ protocol to use"},
+    {PROG_OPTION_ARQ_WINDOW_SZ,     uint16_t{100},                                     "window size for GBN and SR ARQ"},
+    {PROG_OPTION_TRACE_FILE,        ""s,                                               "binary packet trace output file"},
+    {PROG_OPTION_ASYNC_LOGGING,     std::monostate{},                                  "format and print logs on a background thread"},
+    {PROG_OPTION_LATENCY_HISTOGRAM, ""s,                                               "delay histogram CSV output file (server and client only)"},
+    {PROG_OPTION_METRICS_FILE,      ""s,                                               "file to which protocol metrics are periodically written"},
+    {PROG_OPTION_METRICS_SOCKET,    ""s,                                               "UNIX socket from which protocol metrics can be read"},
+    {PROG_OPTION_METRICS_FORMAT,    "prometheus"s,                                     "protocol metrics format (prometheus or json)"},
+    {PROG_OPTION_EXECUTOR_THREADS,  uint16_t{0},                                       "threads on which to run sessions as coroutines (0 to disable)"},
+    {PROG_OPTION_SESSIONS,          uint16_t{1},                                       "concurrent sessions, using ports counting down in pairs"},
+    {PROG_OPTION_RUN_TO_COMPLETION, std::monostate{},                                  "handle data and ACKs on a single busy-polling thread"},
+    {PROG_OPTION_TX_CPUS,           ""s,                                               "CPUs to which transmitter threads are pinned (e.g. 2,3)"},
+    {PROG_OPTION_RX_CPUS,           ""s,                                               "CPUs to which receiver threads are pinned (e.g. 4-5)"},
+    {PROG_OPTION_SCHED_FIFO,        uint16_t{0},                                       "SCHED_FIFO priority for transmitter and receiver threads, which need a CPU each (0 to disable)"},
+    {PROG_OPTION_LOW_LATENCY,       std::monostate{},                                  "busy-poll sockets and lock and pre-fault memory (implies run-to-completion)"},
+    {PROG_OPTION_TX_MSG_SIZE,       uint16_t{0},                                       "if non-zero, send tx-pkt-num messages of this size, packed into or fragmented across packets"},
+    {PROG_OPTION_AGGREGATION_DELAY, uint16_t{1000},                                    "us for which a message may wait for others to share its packet"},
+    {PROG_OPTION_STREAM,            std::monostate{},                                  "write tx-msg-size bytes at a time to a byte stream rather than sending messages"},
+    {PROG_OPTION_MTU,               uint16_t{arq::DEFAULT_MTU},                        "largest UDP payload to send, up to 9216 for jumbo frames"},
+    {PROG_OPTION_PROBE_MTU,         std::monostate{},                                  "probe the path to the client for the largest datagram, up to mtu, which can be sent"},
+    {PROG_OPTION_WORKLOAD,          "constant"s,                                       "arrival pattern of packets or messages (constant, poisson, on-off, saturate or trace)"},
+    {PROG_OPTION_TX_RATE,           uint32_t{0},                                       "packets or messages per second (0 to send one every tx-pkt-interval)"},
+    {PROG_OPTION_BURST_ON,          uint32_t{10000},                                   "us for which each burst of an on-off workload sends"},
+    {PROG_OPTION_BURST_OFF,         uint32_t{90000},                                   "us between bursts of an on-off workload"},
+    {PROG_OPTION_SIZE_DIST,         "fixed"s,                                          "distribution of sizes about tx-pkt-size or tx-msg-size (fixed, uniform or exponential)"},
+    {PROG_OPTION_WORKLOAD_TRACE,    ""s,                                               "file of 'gap_us size' lines to replay with the trace workload"},
+    {PROG_OPTION_OPEN_LOOP,         std::monostate{},                                  "measure each packet's delay from when the workload scheduled it rather than from when it was submitted"},
+    {PROG_OPTION_THROUGHPUT,        std::monostate{},                                  "send as fast as the protocol allows and report goodput, retransmissions, ACKs and CPU time"},
+    {PROG_OPTION_TX_MEGABYTES,      uint32_t{0},                                       "MB to transfer, instead of tx-pkt-num packets or messages (0 to use tx-pkt-num)"},
+    {PROG_OPTION_TX_DURATION,       uint32_t{0},                                       "seconds for which to send (0 for no limit)"},
+    {PROG_OPTION_RX_BUFFER_SIZE,    uint32_t{arq::DEFAULT_OUTPUT_BUFFER_CAPACITY},     "packets the client holds for delivery, which bounds the receive window it advertises (0 for no limit)"},
+    {PROG_OPTION_TX_BUFFER_SIZE,    uint32_t{0},                                       "packets queued for the transmitter before the sender waits (0 for no limit)"},
+    {PROG_OPTION_SHED_LOAD,         std::monostate{},                                  "drop packets which find tx-buffer-size packets queued rather than waiting (plain packets only)"}
 });
 // clang-format on
 
 const uint32_t socket_rx_timeout_seconds = 10;
+const std::chrono::microseconds low_latency_busy_poll_time{50};
+// In throughput mode, the sender waits while two windows of packets, or at least this many, are queued for the
+// transmitter, which keeps the window full without letting the input buffer grow without bound
+const size_t throughput_min_queue_limit = 256;
+// Interval at which the sender checks whether the transmitter has caught up, or has finished
+const std::chrono::microseconds transfer_poll_interval{20};
 
 static auto generateOptionsDescription()
 {
@@ -93,6 +182,13 @@ static auto generateOptionsDescription()
                                       option.helpText.c_str());
         }
 
+        // Add options with uint32_t type arguments
+        else if (std::holds_alternative<uint32_t>(option.defaultValue)) {
+            description.add_options()(option.name.c_str(),
+                                      po::value<uint32_t>()->default_value(std::get<uint32_t>(option.defaultValue)),
+                                      option.helpText.c_str());
+        }
+
         // Add options with string  arguments
         else if (std::holds_alternative<std::string>(option.defaultValue)) {
             description.add_options()(
@@ -131,6 +227,125 @@ static arq::ArqProtocol getArqProtocolFromStr(const std::string& input)
     throw HelpException(std::format("invalid ARQ protocol \"{}\" provided", input));
 }
 
+static util::MetricsFormat getMetricsFormatFromStr(const std::string& input)
+{
+    if (input == "prometheus") {
+        return util::MetricsFormat::PROMETHEUS;
+    }
+    else if (input == "json") {
+        return util::MetricsFormat::JSON;
+    }
+
+    throw HelpException(std::format("invalid metrics format \"{}\" provided", input));
+}
+
+static util::ArrivalPattern getArrivalPatternFromStr(const std::string& input)
+{
+    if (input == "constant") {
+        return util::ArrivalPattern::CONSTANT;
+    }
+    else if (input == "poisson") {
+        return util::ArrivalPattern::POISSON;
+    }
+    else if (input == "on-off") {
+        return util::ArrivalPattern::ON_OFF;
+    }
+    else if (input == "saturate") {
+        return util::ArrivalPattern::SATURATE;
+    }
+    else if (input == "trace") {
+        return util::ArrivalPattern::TRACE;
+    }
+
+    throw HelpException(std::format("invalid workload \"{}\" provided", input));
+}
+
+static util::SizeDistribution getSizeDistributionFromStr(const std::string& input)
+{
+    if (input == "fixed") {
+        return util::SizeDistribution::FIXED;
+    }
+    else if (input == "uniform") {
+        return util::SizeDistribution::UNIFORM;
+    }
+    else if (input == "exponential") {
+        return util::SizeDistribution::EXPONENTIAL;
+    }
+
+    throw HelpException(std::format("invalid size distribution \"{}\" provided", input));
+}
+
+// Builds the server's workload from the options, after the packet or message size has been parsed
+static util::WorkloadSpec parseWorkload(const boost::program_options::variables_map& vm,
+                                        const arq::config_Launcher& config)
+{
+    util::WorkloadSpec workload{
+        .arrivals_ = getArrivalPatternFromStr(vm[PROG_OPTION_WORKLOAD].as<std::string>()),
+        .onTime_ = std::chrono::microseconds(vm[PROG_OPTION_BURST_ON].as<uint32_t>()),
+        .offTime_ = std::chrono::microseconds(vm[PROG_OPTION_BURST_OFF].as<uint32_t>()),
+        .sizes_ = getSizeDistributionFromStr(vm[PROG_OPTION_SIZE_DIST].as<std::string>()),
+        .meanSize_ = config.common.messageSize > 0 ? config.common.messageSize : config.server->txPkts.size,
+        .count_ = config.server->txPkts.num,
+        .traceFile_ = vm[PROG_OPTION_WORKLOAD_TRACE].as<std::string>()};
+
+    // Without a rate, keep to the packet interval, or send as fast as possible if there is none
+    if (vm[PROG_OPTION_TX_RATE].as<uint32_t>() > 0) {
+        workload.rate_ = vm[PROG_OPTION_TX_RATE].as<uint32_t>();
+    }
+    else if (config.server->txPkts.msInterval > 0) {
+        workload.rate_ = 1000.0 / config.server->txPkts.msInterval;
+    }
+    else if (workload.arrivals_ == util::ArrivalPattern::CONSTANT) {
+        workload.arrivals_ = util::ArrivalPattern::SATURATE;
+    }
+
+    if (vm.contains(PROG_OPTION_THROUGHPUT)) {
+        if (!vm[PROG_OPTION_WORKLOAD].defaulted() && workload.arrivals_ != util::ArrivalPattern::SATURATE) {
+            throw HelpException("throughput mode requires a saturating workload");
+        }
+        workload.arrivals_ = util::ArrivalPattern::SATURATE;
+    }
+
+    // Transfer a number of bytes, or run for a time, rather than sending a number of messages
+    if (const auto megabytes = vm[PROG_OPTION_TX_MEGABYTES].as<uint32_t>(); megabytes > 0) {
+        workload.count_ = (uint64_t{megabytes} * 1'000'000 + workload.meanSize_ - 1) / workload.meanSize_;
+        if (workload.sizes_ != util::SizeDistribution::FIXED) {
+            throw HelpException("tx-megabytes requires fixed sizes");
+        }
+    }
+    if (const auto seconds = vm[PROG_OPTION_TX_DURATION].as<uint32_t>(); seconds > 0) {
+        workload.duration_ = std::chrono::seconds(seconds);
+        if (vm[PROG_OPTION_TX_PKT_NUM].defaulted() && vm[PROG_OPTION_TX_MEGABYTES].defaulted()) {
+            workload.count_ = UINT64_MAX;
+        }
+    }
+
+    if (workload.arrivals_ == util::ArrivalPattern::TRACE) {
+        if (workload.traceFile_.empty()) {
+            throw HelpException("trace workload requires workload-trace");
+        }
+        // Replay the whole trace unless told how many messages to send
+        if (vm[PROG_OPTION_TX_PKT_NUM].defaulted()) {
+            workload.count_ = 0;
+        }
+    }
+
+    // Check that the workload can be generated, and load any trace, before starting
+    try {
+        util::WorkloadGenerator generator{workload};
+        if (workload.duration_ > std::chrono::nanoseconds::zero()) {
+            util::logInfo("server workload of up to {} s", vm[PROG_OPTION_TX_DURATION].as<uint32_t>());
+        }
+        else {
+            util::logInfo("server workload of {} messages", generator.count());
+        }
+    }
+    catch (const util::WorkloadException& e) {
+        throw HelpException(e.what());
+    }
+    return workload;
+}
+
 static auto parseOptions(int argc, char** argv, boost::program_options::options_description description)
 {
     arq::config_Launcher config{};
@@ -150,6 +365,11 @@ static auto parseOptions(int argc, char** argv, boost::program_options::options_
             const auto newLevel{static_cast<util::LoggingLevel>(vm[PROG_OPTION_LOGGING].as<uint16_t>())};
             util::Logger::setLoggingLevel(newLevel);
             util::logInfo("logging level set to {}", util::Logger::loggingLevelStr());
+            if (newLevel > util::compiledLoggingLevel) {
+                util::logWarning("logging level {} exceeds compiled logging level {}",
+                                 util::Logger::loggingLevelStr(),
+                                 util::Logger::loggingLevelStr(util::compiledLoggingLevel));
+            }
         }
 
         if (vm.contains(PROG_OPTION_SERVER_ADDR)) {
@@ -189,11 +409,15 @@ static auto parseOptions(int argc, char** argv, boost::program_options::options_
         }
 
         if (vm.contains(PROG_OPTION_LAUNCH_CLIENT)) {
-            config.client = arq::config_Client{}; // No content currently
+            config.client = arq::config_Client{};
         }
 
         if (vm.contains(PROG_OPTION_TX_PKT_NUM) && config.server.has_value()) {
-            config.server->txPkts.num = vm[PROG_OPTION_TX_PKT_NUM].as<uint16_t>();
+            config.server->txPkts.num = vm[PROG_OPTION_TX_PKT_NUM].as<uint32_t>();
+        }
+
+        if (vm.contains(PROG_OPTION_TX_PKT_SIZE) && config.server.has_value()) {
+            config.server->txPkts.size = vm[PROG_OPTION_TX_PKT_SIZE].as<uint16_t>();
         }
 
         if (vm.contains(PROG_OPTION_TX_PKT_INTERVAL) && config.server.has_value()) {
@@ -212,11 +436,201 @@ static auto parseOptions(int argc, char** argv, boost::program_options::options_
             config.common.windowSize = vm[PROG_OPTION_ARQ_WINDOW_SZ].as<uint16_t>();
         }
 
+        if (vm.contains(PROG_OPTION_TRACE_FILE) && !vm[PROG_OPTION_TRACE_FILE].as<std::string>().empty()) {
+            config.common.traceFile = vm[PROG_OPTION_TRACE_FILE].as<std::string>();
+            util::logInfo("packet trace file set to {}", config.common.traceFile.value());
+        }
+
+        if (vm.contains(PROG_OPTION_ASYNC_LOGGING)) {
+            config.common.asyncLogging = true;
+        }
+
+        if (vm.contains(PROG_OPTION_LATENCY_HISTOGRAM) &&
+            !vm[PROG_OPTION_LATENCY_HISTOGRAM].as<std::string>().empty()) {
+            config.common.latencyHistogramFile = vm[PROG_OPTION_LATENCY_HISTOGRAM].as<std::string>();
+            util::logInfo("latency histogram file set to {}", config.common.latencyHistogramFile.value());
+        }
+
+        if (vm.contains(PROG_OPTION_METRICS_FILE) && !vm[PROG_OPTION_METRICS_FILE].as<std::string>().empty()) {
+            config.common.metricsFile = vm[PROG_OPTION_METRICS_FILE].as<std::string>();
+            util::logInfo("metrics file set to {}", config.common.metricsFile.value());
+        }
+
+        if (vm.contains(PROG_OPTION_METRICS_SOCKET) && !vm[PROG_OPTION_METRICS_SOCKET].as<std::string>().empty()) {
+            config.common.metricsSocket = vm[PROG_OPTION_METRICS_SOCKET].as<std::string>();
+            util::logInfo("metrics socket set to {}", config.common.metricsSocket.value());
+        }
+
+        if (vm.contains(PROG_OPTION_METRICS_FORMAT)) {
+            config.common.metricsFormat = getMetricsFormatFromStr(vm[PROG_OPTION_METRICS_FORMAT].as<std::string>());
+        }
+
+        if (vm.contains(PROG_OPTION_EXECUTOR_THREADS)) {
+            config.common.executorThreads = vm[PROG_OPTION_EXECUTOR_THREADS].as<uint16_t>();
+        }
+
+        if (vm.contains(PROG_OPTION_SESSIONS)) {
+            config.common.sessions = vm[PROG_OPTION_SESSIONS].as<uint16_t>();
+            if (config.common.sessions == 0 || config.common.sessions > UINT8_MAX) {
+                throw HelpException(std::format("sessions must be between 1 and {}", UINT8_MAX));
+            }
+            if (config.common.sessions > 1 && config.common.executorThreads == 0) {
+                throw HelpException("multiple sessions require executor-threads");
+            }
+        }
+
+        if (vm.contains(PROG_OPTION_LOW_LATENCY)) {
+            config.common.lowLatency = true;
+            util::logInfo("low-latency mode enabled");
+        }
+
+        if (vm.contains(PROG_OPTION_RUN_TO_COMPLETION) || config.common.lowLatency) {
+            if (config.common.executorThreads > 0) {
+                throw HelpException("run-to-completion and low-latency cannot be combined with executor-threads");
+            }
+            config.common.runToCompletion = true;
+            util::logInfo("transmitter and receiver will run to completion on a single thread each");
+        }
+
+        if (vm.contains(PROG_OPTION_TX_CPUS) && !vm[PROG_OPTION_TX_CPUS].as<std::string>().empty()) {
+            config.common.txPlacement.cpus_ = util::parseCpuList(vm[PROG_OPTION_TX_CPUS].as<std::string>());
+        }
+
+        if (vm.contains(PROG_OPTION_RX_CPUS) && !vm[PROG_OPTION_RX_CPUS].as<std::string>().empty()) {
+            config.common.rxPlacement.cpus_ = util::parseCpuList(vm[PROG_OPTION_RX_CPUS].as<std::string>());
+        }
+
+        if (vm.contains(PROG_OPTION_SCHED_FIFO) && vm[PROG_OPTION_SCHED_FIFO].as<uint16_t>() > 0) {
+            config.common.txPlacement.fifoPriority_ = vm[PROG_OPTION_SCHED_FIFO].as<uint16_t>();
+            config.common.rxPlacement.fifoPriority_ = vm[PROG_OPTION_SCHED_FIFO].as<uint16_t>();
+        }
+
+        if (vm.contains(PROG_OPTION_TX_MSG_SIZE) && vm[PROG_OPTION_TX_MSG_SIZE].as<uint16_t>() > 0) {
+            config.common.messageSize = vm[PROG_OPTION_TX_MSG_SIZE].as<uint16_t>();
+            if (config.common.executorThreads > 0) {
+                throw HelpException("tx-msg-size cannot be combined with executor-threads");
+            }
+            config.common.aggregationDelay =
+                std::chrono::microseconds(vm[PROG_OPTION_AGGREGATION_DELAY].as<uint16_t>());
+            config.common.stream = vm.contains(PROG_OPTION_STREAM);
+            if (config.common.stream) {
+                util::logInfo("writing {} bytes at a time to a byte stream", config.common.messageSize);
+            }
+            else {
+                util::logInfo("sending messages of {} bytes, aggregated for up to {} us",
+                              config.common.messageSize,
+                              config.common.aggregationDelay.count());
+            }
+        }
+        else if (vm.contains(PROG_OPTION_STREAM)) {
+            throw HelpException("stream requires tx-msg-size");
+        }
+
+        if (vm.contains(PROG_OPTION_MTU)) {
+            config.common.mtu = vm[PROG_OPTION_MTU].as<uint16_t>();
+            if (config.common.mtu <= arq::DataPacketHeader::size() || config.common.mtu > arq::MAX_SUPPORTED_MTU) {
+                throw HelpException(std::format(
+                    "mtu must be between {} and {}", arq::DataPacketHeader::size() + 1, arq::MAX_SUPPORTED_MTU));
+            }
+        }
+
+        if (vm.contains(PROG_OPTION_PROBE_MTU)) {
+            if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP || config.common.executorThreads > 0) {
+                throw HelpException("probe-mtu cannot be combined with dummy-sctp or executor-threads");
+            }
+            config.common.probeMtu = true;
+            util::logInfo("probing path for MTU of up to {} bytes", config.common.mtu);
+        }
+        else {
+            util::logInfo("MTU set to {} bytes", config.common.mtu);
+        }
+
+        if (config.server.has_value() &&
+            (config.server->txPkts.size == 0 || config.server->txPkts.size > arq::maxPayloadSize(config.common.mtu))) {
+            throw HelpException(
+                std::format("tx-pkt-size must be between 1 and {}", arq::maxPayloadSize(config.common.mtu)));
+        }
+
+        if (config.server.has_value()) {
+            config.server->workload = parseWorkload(vm, config);
+        }
+
+        if (vm.contains(PROG_OPTION_THROUGHPUT) && config.server.has_value()) {
+            config.server->throughput = true;
+            util::logInfo("throughput mode enabled");
+        }
+
+        if (config.server.has_value()) {
+            const auto txBufferSize = vm[PROG_OPTION_TX_BUFFER_SIZE].as<uint32_t>();
+            config.server->txBufferSize = txBufferSize > 0 ? txBufferSize : arq::UNBOUNDED_INPUT_BUFFER;
+
+            if (vm.contains(PROG_OPTION_SHED_LOAD)) {
+                if (txBufferSize == 0) {
+                    throw HelpException("shed-load requires tx-buffer-size");
+                }
+                if (config.common.messageSize > 0 || config.server->throughput) {
+                    throw HelpException("shed-load cannot be combined with messages, streams or throughput mode");
+                }
+                config.server->shedLoad = true;
+            }
+            if (config.server->txBufferSize != arq::UNBOUNDED_INPUT_BUFFER) {
+                util::logInfo("transmitter input buffer holds {} packets, after which the sender {}",
+                              config.server->txBufferSize,
+                              config.server->shedLoad ? "drops them" : "waits");
+            }
+        }
+
+        if (vm.contains(PROG_OPTION_OPEN_LOOP) && config.server.has_value()) {
+            config.server->openLoop = true;
+            if (config.common.messageSize > 0) {
+                util::logWarning("open-loop delays are measured for plain packets only, as a packet may carry many "
+                                 "messages");
+            }
+        }
+
+        if (config.client.has_value()) {
+            // SCTP has flow control of its own, and the dummy-sctp transmitter ignores the receive window
+            const auto rxBufferSize = vm[PROG_OPTION_RX_BUFFER_SIZE].as<uint32_t>();
+            if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
+                if (!vm[PROG_OPTION_RX_BUFFER_SIZE].defaulted()) {
+                    throw HelpException("rx-buffer-size cannot be combined with dummy-sctp");
+                }
+                config.client->outputBufferCapacity = arq::UNBOUNDED_OUTPUT_BUFFER;
+            }
+            else {
+                config.client->outputBufferCapacity = rxBufferSize > 0 ? rxBufferSize : arq::UNBOUNDED_OUTPUT_BUFFER;
+            }
+        }
+
+        // Avoid page faults on the data path by faulting in window storage before any packets are sent
+        config.common.txPlacement.prefault_ = config.common.lowLatency;
+        config.common.rxPlacement.prefault_ = config.common.lowLatency;
+
+        if (config.common.runToCompletion && config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
+            // The SCTP buffers rely on a blocking socket, since they never retransmit a send which would block
+            throw HelpException("dummy-sctp cannot be combined with run-to-completion or low-latency");
+        }
+
+        if (config.common.executorThreads > 0) {
+            if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
+                throw HelpException("dummy-sctp cannot be run on executor threads");
+            }
+            if (config.server.has_value() && config.server->throughput) {
+                throw HelpException("throughput cannot be combined with executor-threads");
+            }
+            if (!config.common.txPlacement.cpus_.empty() || !config.common.rxPlacement.cpus_.empty() ||
+                config.common.txPlacement.fifoPriority_.has_value()) {
+                util::logWarning("thread placement is not applied to executor threads");
+            }
+            util::logInfo("running {} sessions on {} executor threads",
+                          config.common.sessions,
+                          config.common.executorThreads);
+        }
+
         if (config.server.has_value()) {
             util::logInfo(
-                "server configured to transmit {} packets with interval {} ms using ARQ protocol {} with initial timeout {} ms",
-                config.server->txPkts.num,
-                config.server->txPkts.msInterval,
+                "server configured to transmit a {} workload using ARQ protocol {} with initial timeout {} ms",
+                vm[PROG_OPTION_WORKLOAD].as<std::string>(),
                 arqProtocolToString(config.common.arqProtocol),
                 config.server->arqTimeout);
         }
@@ -295,40 +709,425 @@ static arq::ConversationID receiveConversationID(const arq::config_AddressInfo&
     return receivedID;
 }
 
-static void transmitPackets(std::function<void(arq::DataPacket&&)> txerSendPacket,
-                            const uint16_t numPackets,
-                            const uint16_t msPacketInterval)
+// Makes a packet filled with random data
+static arq::DataPacket makeRandomPacket(uint64_t& randomState, const arq::ConversationID id, const size_t payloadLength)
 {
-    // Send a few packets with random data
-    std::random_device rd;
-    std::mt19937 mt(rd());
-    std::uniform_int_distribution<uint8_t> dist(0, UINT8_MAX);
+    arq::DataPacket inputPacket{};
 
-    for (size_t i = 0; i < numPackets; ++i) {
-        arq::DataPacket inputPacket{};
+    // Populate packet
+    inputPacket.updateDataLength(payloadLength);
+    inputPacket.updateConversationID(id);
+    util::fillRandom(inputPacket.getPayloadSpan(), randomState);
+    return inputPacket;
+}
 
-        // Populate packet
-        inputPacket.updateDataLength(arq::packet_payload_length);
-        inputPacket.updateConversationID(1); // WJG temp - should be based on conversation ID
-        auto dataSpan = inputPacket.getPayloadSpan();
-        for (auto& el : dataSpan) {
-            el = std::byte{dist(mt)};
+static arq::DataPacket makeEndOfTxPacket(const arq::ConversationID id)
+{
+    arq::DataPacket endOfTxPacket{};
+    endOfTxPacket.updateConversationID(id);
+    endOfTxPacket.updateDataLength(0);
+    assert(endOfTxPacket.isEndOfTx());
+    return endOfTxPacket;
+}
+
+// Submits a packet to a transmitter, along with the time at which an open-loop sender scheduled it. Returns false if
+// the packet was dropped to shed load.
+using DueTime = std::chrono::time_point<arq::ClockType>;
+using TxerSendFn = std::function<bool(arq::DataPacket&&, std::optional<DueTime>)>;
+
+struct WorkloadTotals {
+    uint64_t messages_ = 0;
+    uint64_t bytes_ = 0;
+};
+
+// Calls send with the size and due time of each message of the workload once it is due, returning the number of
+// messages and bytes sent. Each message is sent as soon as possible once due, however far the sender has fallen
+// behind, so the schedule is kept to independently of how quickly messages are accepted.
+static WorkloadTotals runWorkload(const util::WorkloadSpec& spec, const std::function<void(size_t, DueTime)>& send)
+{
+    util::WorkloadGenerator workload{spec};
+    WorkloadTotals totals;
+    const auto start = arq::ClockType::now();
+    const bool timed = spec.duration_ > std::chrono::nanoseconds::zero();
+    arq::ClockType::duration maxLag{0};
+    while (const auto event = workload.next()) {
+        const DueTime dueTime = start + std::chrono::duration_cast<arq::ClockType::duration>(event->sendTime_);
+        util::sleepUntil(dueTime);
+        const auto now = arq::ClockType::now();
+        if (timed && now - start >= spec.duration_) {
+            break;
         }
+        maxLag = std::max(maxLag, now - dueTime);
+        send(event->size_, dueTime);
+        ++totals.messages_;
+        totals.bytes_ += event->size_;
+    }
 
+    util::logInfo("Workload of {} messages fell up to {} us behind schedule",
+                  totals.messages_,
+                  std::chrono::duration_cast<std::chrono::microseconds>(maxLag).count());
+    return totals;
+}
+
+static uint64_t transmitPackets(TxerSendFn txerSendPacket, const util::WorkloadSpec& workload, const bool openLoop)
+{
+    // Send packets with random data
+    uint64_t randomState = std::random_device{}();
+    WorkloadTotals shed;
+    const auto totals = runWorkload(workload, [&](size_t size, DueTime dueTime) {
         // Add packet to transmitter's input buffer
-        txerSendPacket(std::move(inputPacket));
-        usleep(1000 * msPacketInterval);
+        if (!txerSendPacket(makeRandomPacket(randomState, 1, size), // WJG temp - should be based on conversation ID
+                            openLoop ? std::optional{dueTime} : std::nullopt)) {
+            ++shed.messages_;
+            shed.bytes_ += size;
+        }
+    });
+    if (shed.messages_ > 0) {
+        util::logWarning("Shed {} of {} packets as the transmitter's input buffer was full",
+                         shed.messages_,
+                         totals.messages_);
     }
 
-    // Send end of Tx packet (WJG: should have function to make one of these)
-    arq::DataPacket endOfTxPacket{};
-    endOfTxPacket.updateConversationID(1);
-    endOfTxPacket.updateDataLength(0);
-    assert(endOfTxPacket.isEndOfTx());
-    txerSendPacket(std::move(endOfTxPacket));
+    // Send end of Tx packet
+    txerSendPacket(makeEndOfTxPacket(1), std::nullopt);
+    return totals.bytes_ - shed.bytes_;
+}
+
+// Sends messages filled with random data through an aggregator, which packs as many as it can into each packet
+static uint64_t transmitMessages(std::function<void(arq::DataPacket&&)> txerSendPacket,
+                                 const util::WorkloadSpec& workload,
+                                 const std::chrono::microseconds maxDelay,
+                                 const size_t mtu)
+{
+    uint64_t randomState = std::random_device{}();
+    std::vector<std::byte> message;
+
+    // WJG temp - should be based on conversation ID
+    arq::MessageAggregator aggregator{1, txerSendPacket, maxDelay, mtu};
+    const auto totals = runWorkload(workload, [&](size_t size, DueTime) {
+        message.resize(size);
+        util::fillRandom(message, randomState);
+        aggregator.sendMessage(message);
+    });
+
+    // Send any pending messages ahead of the end of Tx packet
+    aggregator.flush();
+    util::logInfo("Sent {} messages in {} packets", totals.messages_, aggregator.packetsSent());
+    txerSendPacket(makeEndOfTxPacket(1));
+    return totals.bytes_;
+}
+
+// Writes a byte stream of random data, with each message of the workload written in one go
+static uint64_t transmitStream(std::function<void(arq::DataPacket&&)> txerSendPacket,
+                               const util::WorkloadSpec& workload,
+                               const size_t mtu)
+{
+    uint64_t randomState = std::random_device{}();
+    std::vector<std::byte> buffer;
+
+    // Unless saturating, each write is flushed rather than held until the next is due
+    const bool flushEachWrite = workload.arrivals_ != util::ArrivalPattern::SATURATE;
+    arq::StreamWriter writer{1, txerSendPacket, mtu}; // WJG temp - should be based on conversation ID
+    const auto totals = runWorkload(workload, [&](size_t size, DueTime) {
+        buffer.resize(size);
+        util::fillRandom(buffer, randomState);
+        writer.write(buffer);
+        if (flushEachWrite) {
+            writer.flush();
+        }
+    });
+
+    writer.flush();
+    util::logInfo("Wrote {} bytes in {} packets", totals.bytes_, writer.packetsSent());
+    txerSendPacket(makeEndOfTxPacket(1));
+    return totals.bytes_;
+}
+
+// Limits the sizes of plain packets drawn from the workload to the payload which fits the MTU
+static util::WorkloadSpec fitPacketsToMtu(util::WorkloadSpec workload, const size_t mtu)
+{
+    workload.maxSize_ = arq::maxPayloadSize(mtu);
+    if (workload.meanSize_ > workload.maxSize_) {
+        util::logWarning("Packet payloads reduced to {} bytes to fit the MTU", workload.maxSize_);
+    }
+    return workload;
+}
+
+// Sends packets, aggregated messages or a byte stream, as configured, in datagrams of up to the MTU
+// Returns the number of payload bytes sent
+static uint64_t transmitData(TxerSendFn txerSendPacket, const arq::config_Launcher& config, const size_t mtu)
+{
+    // Messages and stream writes share packets, so their delays are measured from entry to the input buffer
+    auto sendNow = [&txerSendPacket](arq::DataPacket&& pkt) { txerSendPacket(std::move(pkt), std::nullopt); };
+
+    auto workload = config.server->workload;
+    if (config.common.stream) {
+        return transmitStream(sendNow, workload, mtu);
+    }
+    else if (config.common.messageSize > 0) {
+        workload.maxSize_ = arq::MAX_MESSAGE_SIZE;
+        return transmitMessages(sendNow, workload, config.common.aggregationDelay, mtu);
+    }
+    else {
+        return transmitPackets(txerSendPacket, fitPacketsToMtu(workload, mtu), config.server->openLoop);
+    }
 }
 
-static void startTransmitter(const arq::config_Launcher& config)
+// Returns a function which submits packets to the transmitter, waiting for room in its input buffer or, when shedding
+// load, dropping packets which find it full. The EoT packet is never dropped. In throughput mode, it first waits for
+// the transmitter to catch up if too many packets are queued.
+template <typename TransmitterType>
+static TxerSendFn makeTxerSend(TransmitterType& txer, const arq::config_Launcher& config)
+{
+    const size_t queueLimit = config.server->throughput
+                                  ? std::max<size_t>(throughput_min_queue_limit, 2 * config.common.windowSize.value_or(0))
+                                  : SIZE_MAX;
+    return [&txer, queueLimit, shedLoad = config.server->shedLoad](arq::DataPacket&& pkt,
+                                                                    std::optional<DueTime> dueTime) {
+        if (shedLoad && !pkt.isEndOfTx()) {
+            return txer.trySendPacket(std::move(pkt), dueTime) == arq::SendStatus::QUEUED;
+        }
+        while (txer.queuedPackets() >= queueLimit) {
+            std::this_thread::sleep_for(transfer_poll_interval);
+        }
+        txer.sendPacket(std::move(pkt), dueTime);
+        return true;
+    };
+}
+
+// The transmitter's input buffer limits, with watermarks at which the launcher logs that the sender is being held back
+// and has been released
+static arq::InputBufferPolicy makeInputBufferPolicy(const arq::config_Server& config)
+{
+    if (config.txBufferSize == arq::UNBOUNDED_INPUT_BUFFER) {
+        return {};
+    }
+    return {.capacity_ = config.txBufferSize,
+            .highWatermark_ = config.txBufferSize,
+            .lowWatermark_ = config.txBufferSize / 2,
+            .onHighWatermark_ = []() { util::logDebug("Transmitter input buffer full - holding back the sender"); },
+            .onLowWatermark_ = []() { util::logDebug("Transmitter input buffer half empty - releasing the sender"); }};
+}
+
+// Prints the goodput of a completed transfer, along with the retransmissions and ACKs it took and the CPU time the
+// process used per GB
+static void reportThroughput(const arq::ConversationID id,
+                             const uint64_t bytes,
+                             const arq::ClockType::duration elapsed,
+                             const std::clock_t cpuTime)
+{
+    const arq::TransmitterMetrics metrics{id};
+    const auto packets = metrics.packetsSent_.value();
+    const auto retransmissions = metrics.timeoutRetransmissions_.value();
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    const auto cpuSeconds = static_cast<double>(cpuTime) / CLOCKS_PER_SEC;
+
+    std::println("Transferred {} bytes in {:.3f} s: goodput {:.1f} Mbit/s, {} packets, {} retransmissions "
+                 "(overhead {:.4f}), {} ACKs, {:.3f} CPU s/GB",
+                 bytes,
+                 seconds,
+                 seconds > 0.0 ? bytes * 8 / seconds / 1e6 : 0.0,
+                 packets,
+                 retransmissions,
+                 packets > 0 ? static_cast<double>(retransmissions) / packets : 0.0,
+                 metrics.acksReceived_.value(),
+                 bytes > 0 ? cpuSeconds / (bytes / 1e9) : 0.0);
+}
+
+// Sends the configured data through the transmitter, then waits for the EoT packet to be acknowledged, and so for the
+// transfer to complete, before reporting it
+template <typename TransmitterType>
+static void transmitAndReport(TransmitterType& txer,
+                              const arq::ConversationID id,
+                              const arq::config_Launcher& config,
+                              const size_t mtu)
+{
+    const auto startTime = arq::ClockType::now();
+    const auto startCpuTime = std::clock();
+    const auto bytesSent = transmitData(makeTxerSend(txer, config), config, mtu);
+
+    while (!txer.finished()) {
+        std::this_thread::sleep_for(transfer_poll_interval);
+    }
+    reportThroughput(id, bytesSent, arq::ClockType::now() - startTime, std::clock() - startCpuTime);
+}
+
+// Unpacks messages from the receiver's output buffer until the end of Tx packet arrives, then reports the rate at which
+// they were received
+template <typename ReceiverType>
+static void receiveMessages(ReceiverType& rxer)
+{
+    arq::MessageUnpacker unpacker{[&rxer]() { return std::optional{rxer.getPacket()}; }};
+    size_t numMessages = 0;
+    std::optional<std::chrono::time_point<arq::ClockType>> firstRxTime;
+    while (unpacker.tryGetMessage().has_value()) {
+        if (!firstRxTime.has_value()) {
+            firstRxTime = arq::ClockType::now();
+        }
+        ++numMessages;
+    }
+
+    const std::chrono::duration<double> elapsed = arq::ClockType::now() - firstRxTime.value_or(arq::ClockType::now());
+    std::println("Received {} messages in {} packets over {:.3f} s ({:.0f} messages/s)",
+                 numMessages,
+                 unpacker.packetsReceived(),
+                 elapsed.count(),
+                 elapsed.count() > 0 ? numMessages / elapsed.count() : 0.0);
+}
+
+// Reads a byte stream from the receiver's output buffer until it ends, then reports the rate at which it was received
+template <typename ReceiverType>
+static void receiveStream(ReceiverType& rxer)
+{
+    arq::StreamReader reader{[&rxer]() { return std::optional{rxer.getPacket()}; },
+                             [&rxer]() { return rxer.tryGetPacket(); }};
+    std::vector<std::byte> buffer(64 * 1024);
+    size_t numBytes = 0;
+    std::optional<std::chrono::time_point<arq::ClockType>> firstRxTime;
+    for (size_t bytesRead; (bytesRead = reader.read(buffer)) > 0;) {
+        if (!firstRxTime.has_value()) {
+            firstRxTime = arq::ClockType::now();
+        }
+        numBytes += bytesRead;
+    }
+
+    const std::chrono::duration<double> elapsed = arq::ClockType::now() - firstRxTime.value_or(arq::ClockType::now());
+    std::println("Received {} bytes over {:.3f} s ({:.1f} MB/s)",
+                 numBytes,
+                 elapsed.count(),
+                 elapsed.count() > 0 ? numBytes / elapsed.count() / 1e6 : 0.0);
+}
+
+// Takes packets from the receiver's output buffer until the end of Tx packet arrives, so that the buffer does not fill
+// and close the receive window, then reports the rate at which they were received
+template <typename ReceiverType>
+static void receivePackets(ReceiverType& rxer)
+{
+    size_t numPackets = 0;
+    size_t numBytes = 0;
+    std::optional<std::chrono::time_point<arq::ClockType>> firstRxTime;
+    for (auto rxObject = rxer.getPacket(); !rxObject.packet_.isEndOfTx(); rxObject = rxer.getPacket()) {
+        if (!firstRxTime.has_value()) {
+            firstRxTime = arq::ClockType::now();
+        }
+        ++numPackets;
+        numBytes += rxObject.packet_.getPayloadReadSpan().size();
+    }
+
+    const std::chrono::duration<double> elapsed = arq::ClockType::now() - firstRxTime.value_or(arq::ClockType::now());
+    std::println("Received {} packets ({} bytes) over {:.3f} s ({:.1f} MB/s)",
+                 numPackets,
+                 numBytes,
+                 elapsed.count(),
+                 elapsed.count() > 0 ? numBytes / elapsed.count() / 1e6 : 0.0);
+}
+
+// Reads packets, aggregated messages or a byte stream from the receiver, as configured
+template <typename ReceiverType>
+static void receiveData(ReceiverType& rxer, const arq::config_Launcher& config)
+{
+    if (config.common.stream) {
+        receiveStream(rxer);
+    }
+    else if (config.common.messageSize > 0) {
+        receiveMessages(rxer);
+    }
+    else {
+        receivePackets(rxer);
+    }
+}
+
+// As receivePackets, but run as a coroutine alongside the receiver on its executor. The receiver's output buffer cannot
+// be waited on, so it is polled until the receiver finishes.
+template <arq::RSBuffer RSBufferType>
+static util::Task receivePacketsAsync(util::Executor& executor, arq::AsyncReceiver<RSBufferType>& rxer)
+{
+    for (bool finished = false; !finished;) {
+        // Check before draining, since the receiver delivers every packet before it finishes
+        finished = rxer.finished();
+        while (rxer.tryGetPacket().has_value()) {
+        }
+        if (!finished) {
+            co_await executor.sleepUntil(util::Executor::ClockType::now() + transfer_poll_interval);
+        }
+    }
+}
+
+// As transmitPackets, but run as a coroutine alongside the transmitter on its executor. The transmitter never blocks a
+// sender, so packets which find its input buffer full wait until it becomes writable, or are dropped to shed load.
+template <arq::RTBuffer RTBufferType>
+static util::Task transmitPacketsAsync(util::Executor& executor,
+                                       arq::AsyncTransmitter<RTBufferType>& txer,
+                                       const arq::ConversationID id,
+                                       const arq::config_Server config,
+                                       const size_t mtu)
+{
+    uint64_t randomState = std::random_device{}();
+    util::WorkloadGenerator generator{fitPacketsToMtu(config.workload, mtu)};
+    // The executor sleeps on its own clock, while due times are recorded on the transmitter's
+    const auto start = util::Executor::ClockType::now();
+    const auto arqStart = arq::ClockType::now();
+    uint64_t shed = 0;
+
+    while (const auto event = generator.next()) {
+        co_await executor.sleepUntil(start + event->sendTime_);
+        const DueTime dueTime = arqStart + std::chrono::duration_cast<arq::ClockType::duration>(event->sendTime_);
+        const auto due = config.openLoop ? std::optional{dueTime} : std::nullopt;
+
+        // A refused packet is left intact, so it can be offered again
+        auto pkt = makeRandomPacket(randomState, id, event->size_);
+        while (txer.sendPacket(std::move(pkt), due) == arq::SendStatus::FULL) {
+            if (config.shedLoad) {
+                ++shed;
+                break;
+            }
+            co_await txer.writable();
+        }
+    }
+    if (shed > 0) {
+        util::logWarning(
+            "Shed {} of {} packets as the transmitter's input buffer was full", shed, generator.generated());
+    }
+
+    auto endOfTx = makeEndOfTxPacket(id);
+    while (txer.sendPacket(std::move(endOfTx)) == arq::SendStatus::FULL) {
+        co_await txer.writable();
+    }
+}
+
+// Returns a receive function for a UDP data channel which reports the time at which the kernel received each datagram.
+// If the kernel cannot timestamp datagrams, the ARQ components time them as they are read instead.
+static arq::ReceiveFn makeTimestampedRecvFrom(const util::Endpoint& dataChannel)
+{
+    if (!dataChannel.enableTimestamping()) {
+        util::logWarning("Failed to enable kernel timestamps on data channel");
+    }
+    return [&dataChannel](std::span<std::byte> buffer, arq::RxTimestamp& rxTime) {
+        std::optional<util::Socket::Timestamp> kernelTime;
+        auto ret = dataChannel.recvFrom(buffer, kernelTime);
+        rxTime = kernelTime.transform(arq::fromSystemTime);
+        return ret;
+    };
+}
+
+// Probes the path to the receiver for the largest datagram, up to maxMtu, which can be sent. Falls back to the default
+// MTU if probing fails.
+static size_t probeMtu(const arq::ConversationID id, const arq::config_AddressInfo& rxerAddress, const size_t maxMtu)
+{
+    const auto mtu = util::probePathMtu(rxerAddress.hostName, rxerAddress.serviceName, maxMtu, [id](size_t size) {
+        const auto probe = arq::DataPacket::makeProbe(id, size);
+        return std::vector<std::byte>(probe.getReadSpan().begin(), probe.getReadSpan().end());
+    });
+    if (!mtu.has_value()) {
+        const auto fallback = std::min(maxMtu, arq::DEFAULT_MTU);
+        util::logWarning("Failed to probe path MTU - using {} bytes", fallback);
+        return fallback;
+    }
+    util::logInfo("Probed path MTU of {} bytes", mtu.value());
+    return mtu.value();
+}
+
+static void startTransmitter(const arq::config_Launcher& config, std::shared_ptr<arq::LatencyStats> latencyStats)
 {
     // Generate a new conversation ID and share with receiver
     arq::ConversationIDAllocator allocator{};
@@ -340,6 +1139,8 @@ static void startTransmitter(const arq::config_Launcher& config)
     shareConversationID(convID, txerAddress, rxerAddress.hostName);
     util::logInfo("Conversation ID {} shared with receiver", convID);
 
+    const auto mtu = config.common.probeMtu ? probeMtu(convID, rxerAddress, config.common.mtu) : config.common.mtu;
+
     util::Endpoint dataChannel(
         txerAddress.hostName,
         txerAddress.serviceName,
@@ -366,12 +1167,22 @@ static void startTransmitter(const arq::config_Launcher& config)
         }
     }
 
-    // Add Rx timeout in case last ACK is lost
-    if (config.common.arqProtocol != arq::ArqProtocol::DUMMY_SCTP &&
+    // Add Rx timeout in case last ACK is lost. A run-to-completion thread polls instead, so never blocks.
+    if (config.common.arqProtocol != arq::ArqProtocol::DUMMY_SCTP && !config.common.runToCompletion &&
         !dataChannel.setRecvTimeout(socket_rx_timeout_seconds, 0)) {
         throw std::runtime_error("failed to set data channel Rx timeout");
     }
 
+    // In run-to-completion mode, a single thread polls the data channel
+    if (config.common.runToCompletion && !dataChannel.setNonBlocking(true)) {
+        throw std::runtime_error("failed to make data channel non-blocking");
+    }
+    if (config.common.lowLatency && !dataChannel.setBusyPoll(low_latency_busy_poll_time)) {
+        util::logWarning("Failed to enable busy polling on data channel");
+    }
+    const auto threadingMode =
+        config.common.runToCompletion ? arq::ThreadingMode::RUN_TO_COMPLETION : arq::ThreadingMode::SPLIT;
+
     arq::TransmitFn txToClient;
     if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
         txToClient = [&dataChannel](std::span<const std::byte> buffer) { return dataChannel.send(buffer); };
@@ -384,30 +1195,39 @@ static void startTransmitter(const arq::config_Launcher& config)
 
     arq::ReceiveFn rxFromClient;
     if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
-        rxFromClient = [&dataChannel](std::span<std::byte> buffer) { return dataChannel.recv(buffer); };
+        rxFromClient = [&dataChannel](std::span<std::byte> buffer, arq::RxTimestamp&) {
+            return dataChannel.recv(buffer);
+        };
     }
     else {
-        rxFromClient = [&dataChannel](std::span<std::byte> buffer) { return dataChannel.recvFrom(buffer); };
+        rxFromClient = makeTimestampedRecvFrom(dataChannel);
     }
 
     // WJG to clean up branches - possible template function?
     if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
-        arq::Transmitter txer(convID, txToClient, rxFromClient, std::make_unique<arq::rt::DummySCTP>());
-
-        auto txerSend = [&txer](arq::DataPacket&& pkt) { txer.sendPacket(std::move(pkt)); };
+        arq::Transmitter txer(convID,
+                              txToClient,
+                              rxFromClient,
+                              std::make_unique<arq::rt::DummySCTP>(),
+                              latencyStats,
+                              threadingMode,
+                              config.common.txPlacement,
+                              makeInputBufferPolicy(*config.server));
 
-        transmitPackets(txerSend, config.server->txPkts.num, config.server->txPkts.msInterval);
+        transmitAndReport(txer, convID, config, mtu);
     }
     else if (config.common.arqProtocol == arq::ArqProtocol::STOP_AND_WAIT) {
         arq::Transmitter txer(
             convID,
             txToClient,
             rxFromClient,
-            std::make_unique<arq::rt::StopAndWait>(std::chrono::milliseconds(config.server->arqTimeout)));
-
-        auto txerSend = [&txer](arq::DataPacket&& pkt) { txer.sendPacket(std::move(pkt)); };
+            std::make_unique<arq::rt::StopAndWait>(std::chrono::milliseconds(config.server->arqTimeout)),
+            latencyStats,
+            threadingMode,
+            config.common.txPlacement,
+            makeInputBufferPolicy(*config.server));
 
-        transmitPackets(txerSend, config.server->txPkts.num, config.server->txPkts.msInterval);
+        transmitAndReport(txer, convID, config, mtu);
     }
     else if (config.common.arqProtocol == arq::ArqProtocol::GO_BACK_N) {
         auto windowSize = config.common.windowSize;
@@ -420,11 +1240,15 @@ static void startTransmitter(const arq::config_Launcher& config)
                               txToClient,
                               rxFromClient,
                               std::make_unique<arq::rt::GoBackN>(windowSize.value(),
-                                                                 std::chrono::milliseconds(config.server->arqTimeout)));
-
-        auto txerSend = [&txer](arq::DataPacket&& pkt) { txer.sendPacket(std::move(pkt)); };
-
-        transmitPackets(txerSend, config.server->txPkts.num, config.server->txPkts.msInterval);
+                                                                 std::chrono::milliseconds(config.server->arqTimeout),
+                                                                 arq::FIRST_SEQUENCE_NUMBER,
+                                                                 mtu),
+                              latencyStats,
+                              threadingMode,
+                              config.common.txPlacement,
+                              makeInputBufferPolicy(*config.server));
+
+        transmitAndReport(txer, convID, config, mtu);
     }
     else if (config.common.arqProtocol == arq::ArqProtocol::SELECTIVE_REPEAT) {
         auto windowSize = config.common.windowSize;
@@ -437,18 +1261,23 @@ static void startTransmitter(const arq::config_Launcher& config)
                               txToClient,
                               rxFromClient,
                               std::make_unique<arq::rt::SelectiveRepeat>(
-                                  windowSize.value(), std::chrono::milliseconds(config.server->arqTimeout)));
-
-        auto txerSend = [&txer](arq::DataPacket&& pkt) { txer.sendPacket(std::move(pkt)); };
-
-        transmitPackets(txerSend, config.server->txPkts.num, config.server->txPkts.msInterval);
+                                  windowSize.value(),
+                                  std::chrono::milliseconds(config.server->arqTimeout),
+                                  arq::FIRST_SEQUENCE_NUMBER,
+                                  mtu),
+                              latencyStats,
+                              threadingMode,
+                              config.common.txPlacement,
+                              makeInputBufferPolicy(*config.server));
+
+        transmitAndReport(txer, convID, config, mtu);
     }
     else {
         util::logError("Unsupported ARQ protocol: {}", arqProtocolToString(config.common.arqProtocol));
     }
 }
 
-static void startReceiver(const arq::config_Launcher& config)
+static void startReceiver(const arq::config_Launcher& config, std::shared_ptr<arq::LatencyStats> latencyStats)
 {
     // Obtain conversation ID from tranmitter
     auto convID = receiveConversationID(config.common.clientNames, config.common.serverNames);
@@ -462,8 +1291,8 @@ static void startReceiver(const arq::config_Launcher& config)
         rxerAddress.serviceName,
         config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP ? util::SocketType::SCTP : util::SocketType::UDP);
 
-    // Add Rx timeout in case last packets are lost
-    if (config.common.arqProtocol != arq::ArqProtocol::DUMMY_SCTP &&
+    // Add Rx timeout in case last packets are lost. A run-to-completion thread polls instead, so never blocks.
+    if (config.common.arqProtocol != arq::ArqProtocol::DUMMY_SCTP && !config.common.runToCompletion &&
         !dataChannel.setRecvTimeout(socket_rx_timeout_seconds, 0)) {
         throw std::runtime_error("failed to set data channel Rx timeout");
     }
@@ -473,6 +1302,16 @@ static void startReceiver(const arq::config_Launcher& config)
             txerAddress.hostName, txerAddress.serviceName, util::SocketType::SCTP, 20, std::chrono::milliseconds(500));
     }
 
+    // In run-to-completion mode, a single thread polls the data channel
+    if (config.common.runToCompletion && !dataChannel.setNonBlocking(true)) {
+        throw std::runtime_error("failed to make data channel non-blocking");
+    }
+    if (config.common.lowLatency && !dataChannel.setBusyPoll(low_latency_busy_poll_time)) {
+        util::logWarning("Failed to enable busy polling on data channel");
+    }
+    const auto threadingMode =
+        config.common.runToCompletion ? arq::ThreadingMode::RUN_TO_COMPLETION : arq::ThreadingMode::SPLIT;
+
     // WJG: same considerations apply here as in Transmitter
     arq::TransmitFn txToServer;
     if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
@@ -486,31 +1325,195 @@ static void startReceiver(const arq::config_Launcher& config)
 
     arq::ReceiveFn rxFromServer;
     if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
-        rxFromServer = [&dataChannel](std::span<std::byte> buffer) { return dataChannel.recv(buffer); };
+        rxFromServer = [&dataChannel](std::span<std::byte> buffer, arq::RxTimestamp&) {
+            return dataChannel.recv(buffer);
+        };
     }
     else {
-        rxFromServer = [&dataChannel](std::span<std::byte> buffer) { return dataChannel.recvFrom(buffer); };
+        rxFromServer = makeTimestampedRecvFrom(dataChannel);
     }
 
-    // Use rxer.getPacket to get all sent packets...
+    // Use rxer.getPacket to get all sent packets, or unpack them into messages if aggregated
     if (config.common.arqProtocol == arq::ArqProtocol::DUMMY_SCTP) {
-        arq::Receiver rxer(convID, txToServer, rxFromServer, std::make_unique<arq::rs::DummySCTP>());
+        arq::Receiver rxer(convID,
+                           txToServer,
+                           rxFromServer,
+                           std::make_unique<arq::rs::DummySCTP>(),
+                           latencyStats,
+                           threadingMode,
+                           config.common.rxPlacement,
+                           config.client->outputBufferCapacity);
+        receiveData(rxer, config);
     }
     else if (config.common.arqProtocol == arq::ArqProtocol::STOP_AND_WAIT) {
-        arq::Receiver rxer(convID, txToServer, rxFromServer, std::make_unique<arq::rs::StopAndWait>());
+        arq::Receiver rxer(convID,
+                           txToServer,
+                           rxFromServer,
+                           std::make_unique<arq::rs::StopAndWait>(),
+                           latencyStats,
+                           threadingMode,
+                           config.common.rxPlacement,
+                           config.client->outputBufferCapacity);
+        receiveData(rxer, config);
     }
     else if (config.common.arqProtocol == arq::ArqProtocol::GO_BACK_N) {
-        arq::Receiver rxer(convID, txToServer, rxFromServer, std::make_unique<arq::rs::GoBackN>());
+        arq::Receiver rxer(convID,
+                           txToServer,
+                           rxFromServer,
+                           std::make_unique<arq::rs::GoBackN>(),
+                           latencyStats,
+                           threadingMode,
+                           config.common.rxPlacement,
+                           config.client->outputBufferCapacity);
+        receiveData(rxer, config);
     }
     else if (config.common.arqProtocol == arq::ArqProtocol::SELECTIVE_REPEAT) {
-        // temp add window config
-        arq::Receiver rxer(convID, txToServer, rxFromServer, std::make_unique<arq::rs::SelectiveRepeat>(100));
+        // The RS window must match the transmitter's, which uses the same default if none is given
+        arq::Receiver rxer(convID,
+                           txToServer,
+                           rxFromServer,
+                           std::make_unique<arq::rs::SelectiveRepeat>(config.common.windowSize.value_or(100)),
+                           latencyStats,
+                           threadingMode,
+                           config.common.rxPlacement,
+                           config.client->outputBufferCapacity);
+        receiveData(rxer, config);
     }
     else {
         util::logError("Unsupported ARQ protocol: {}", arqProtocolToString(config.common.arqProtocol));
     };
 }
 
+// The address of a session run on an executor. Each session uses its own port, counting down from the configured one
+// in steps of two so that the server and client port ranges do not overlap.
+static arq::config_AddressInfo getSessionAddress(const arq::config_AddressInfo& address, const uint16_t session)
+{
+    int port;
+    try {
+        port = std::stoi(address.serviceName) - 2 * session;
+    }
+    catch (const std::logic_error&) {
+        throw std::runtime_error(std::format("port {} must be numeric to run multiple sessions", address.serviceName));
+    }
+    if (port <= 0) {
+        throw std::runtime_error(std::format("too many sessions for port {}", address.serviceName));
+    }
+    return {.hostName = address.hostName, .serviceName = std::to_string(port)};
+}
+
+template <arq::RTBuffer RTBufferType, arq::RSBuffer RSBufferType>
+struct ExecutorSession {
+    arq::config_AddressInfo txerAddress;
+    arq::config_AddressInfo rxerAddress;
+    std::unique_ptr<util::Endpoint> txerChannel;
+    std::unique_ptr<util::Endpoint> rxerChannel;
+    std::unique_ptr<arq::AsyncTransmitter<RTBufferType>> txer;
+    std::unique_ptr<arq::AsyncReceiver<RSBufferType>> rxer;
+};
+
+static std::unique_ptr<util::Endpoint> makeNonBlockingDataChannel(const arq::config_AddressInfo& address)
+{
+    auto dataChannel = std::make_unique<util::Endpoint>(address.hostName, address.serviceName, util::SocketType::UDP);
+    if (!dataChannel->setNonBlocking(true)) {
+        throw std::runtime_error("failed to make data channel non-blocking");
+    }
+    return dataChannel;
+}
+
+// Runs every session's transmitter and/or receiver as coroutines, distributed over a pool of executors
+template <arq::RTBuffer RTBufferType, arq::RSBuffer RSBufferType>
+static void runExecutorSessions(const arq::config_Launcher& config,
+                                std::shared_ptr<arq::LatencyStats> latencyStats,
+                                std::function<std::unique_ptr<RTBufferType>()> makeRtBuffer,
+                                std::function<std::unique_ptr<RSBufferType>()> makeRsBuffer)
+{
+    util::ExecutorPool pool(config.common.executorThreads);
+    std::vector<std::unique_ptr<ExecutorSession<RTBufferType, RSBufferType>>> sessions;
+
+    for (uint16_t i = 0; i < config.common.sessions; ++i) {
+        auto& session = *sessions.emplace_back(std::make_unique<ExecutorSession<RTBufferType, RSBufferType>>());
+        auto& executor = pool.next();
+        const arq::ConversationID convID = i + 1;
+        session.txerAddress = getSessionAddress(config.common.serverNames, i);
+        session.rxerAddress = getSessionAddress(config.common.clientNames, i);
+
+        if (config.client.has_value()) {
+            session.rxerChannel = makeNonBlockingDataChannel(session.rxerAddress);
+            auto& dataChannel = *session.rxerChannel;
+            auto& txerAddress = session.txerAddress;
+            session.rxer = std::make_unique<arq::AsyncReceiver<RSBufferType>>(
+                convID,
+                executor,
+                [&dataChannel, &txerAddress](std::span<const std::byte> buffer) {
+                    return dataChannel.sendTo(buffer, txerAddress.hostName, txerAddress.serviceName);
+                },
+                makeTimestampedRecvFrom(dataChannel),
+                dataChannel.fileDescriptor(),
+                makeRsBuffer(),
+                latencyStats,
+                config.client->outputBufferCapacity);
+            executor.spawn(receivePacketsAsync(executor, *session.rxer));
+        }
+
+        if (config.server.has_value()) {
+            session.txerChannel = makeNonBlockingDataChannel(session.txerAddress);
+            auto& dataChannel = *session.txerChannel;
+            auto& rxerAddress = session.rxerAddress;
+            session.txer = std::make_unique<arq::AsyncTransmitter<RTBufferType>>(
+                convID,
+                executor,
+                [&dataChannel, &rxerAddress](std::span<const std::byte> buffer) {
+                    return dataChannel.sendTo(buffer, rxerAddress.hostName, rxerAddress.serviceName);
+                },
+                makeTimestampedRecvFrom(dataChannel),
+                dataChannel.fileDescriptor(),
+                makeRtBuffer(),
+                latencyStats,
+                makeInputBufferPolicy(*config.server));
+            executor.spawn(transmitPacketsAsync(executor, *session.txer, convID, *config.server, config.common.mtu));
+        }
+    }
+
+    pool.run();
+}
+
+static void startExecutorSessions(const arq::config_Launcher& config, std::shared_ptr<arq::LatencyStats> latencyStats)
+{
+    const auto windowSize = config.common.windowSize.value_or(100);
+    const auto arqTimeout = std::chrono::milliseconds(config.server.has_value() ? config.server->arqTimeout : 0);
+    const auto mtu = config.common.mtu;
+
+    if (config.common.arqProtocol == arq::ArqProtocol::STOP_AND_WAIT) {
+        runExecutorSessions<arq::rt::StopAndWait, arq::rs::StopAndWait>(
+            config,
+            latencyStats,
+            [=]() { return std::make_unique<arq::rt::StopAndWait>(arqTimeout); },
+            []() { return std::make_unique<arq::rs::StopAndWait>(); });
+    }
+    else if (config.common.arqProtocol == arq::ArqProtocol::GO_BACK_N) {
+        runExecutorSessions<arq::rt::GoBackN, arq::rs::GoBackN>(
+            config,
+            latencyStats,
+            [=]() {
+                return std::make_unique<arq::rt::GoBackN>(windowSize, arqTimeout, arq::FIRST_SEQUENCE_NUMBER, mtu);
+            },
+            []() { return std::make_unique<arq::rs::GoBackN>(); });
+    }
+    else if (config.common.arqProtocol == arq::ArqProtocol::SELECTIVE_REPEAT) {
+        runExecutorSessions<arq::rt::SelectiveRepeat, arq::rs::SelectiveRepeat>(
+            config,
+            latencyStats,
+            [=]() {
+                return std::make_unique<arq::rt::SelectiveRepeat>(
+                    windowSize, arqTimeout, arq::FIRST_SEQUENCE_NUMBER, mtu);
+            },
+            [=]() { return std::make_unique<arq::rs::SelectiveRepeat>(windowSize); });
+    }
+    else {
+        util::logError("Unsupported ARQ protocol on executor: {}", arqProtocolToString(config.common.arqProtocol));
+    }
+}
+
 int main(int argc, char** argv)
 {
     /* Handle SIGPIPE for SCTP connection termination. This is something of a hack, but is fine for the purposes of this
@@ -528,18 +1531,81 @@ int main(int argc, char** argv)
 
     util::Logger::enableTimestamps();
 
+    // Lock current and future memory, which also faults it in, so that the data path does not page fault
+    if (cfg.common.lowLatency && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        util::logWarning("Failed to lock memory ({})", std::strerror(errno));
+    }
+
+    if (cfg.common.asyncLogging) {
+        util::Logger::enableAsync();
+    }
+
+    if (cfg.common.traceFile.has_value()) {
+        try {
+            util::Tracer::start(cfg.common.traceFile.value());
+        }
+        catch (const util::TraceException& e) {
+            util::logError("Failed to start tracing ({})", e.what());
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<std::unique_ptr<util::MetricsExporter>> metricsExporters;
+    try {
+        if (cfg.common.metricsFile.has_value()) {
+            metricsExporters.push_back(std::make_unique<util::MetricsExporter>(util::MetricsRegistry::global(),
+                                                                               util::MetricsExporter::Destination::FILE,
+                                                                               cfg.common.metricsFile.value(),
+                                                                               cfg.common.metricsFormat));
+        }
+        if (cfg.common.metricsSocket.has_value()) {
+            metricsExporters.push_back(
+                std::make_unique<util::MetricsExporter>(util::MetricsRegistry::global(),
+                                                        util::MetricsExporter::Destination::UNIX_SOCKET,
+                                                        cfg.common.metricsSocket.value(),
+                                                        cfg.common.metricsFormat));
+        }
+    }
+    catch (const util::MetricsException& e) {
+        util::logError("Failed to start metrics export ({})", e.what());
+        return EXIT_FAILURE;
+    }
+
+    // End-to-end delay can only be measured when the transmitter and receiver share a process
+    std::shared_ptr<arq::LatencyStats> latencyStats;
+    if (cfg.common.sessions > 1) {
+        if (cfg.common.latencyHistogramFile.has_value()) {
+            util::logWarning("Latency histogram is only recorded for a single session");
+        }
+    }
+    else if (cfg.server.has_value() && cfg.client.has_value()) {
+        latencyStats = std::make_shared<arq::LatencyStats>();
+    }
+    else if (cfg.common.latencyHistogramFile.has_value()) {
+        util::logWarning("Latency histogram requires both server and client to be launched");
+    }
+
     std::thread txThread, rxThread;
 
-    if (cfg.server.has_value()) {
-        txThread = std::thread(startTransmitter, std::ref(cfg));
+    if (cfg.common.executorThreads > 0) {
+        try {
+            startExecutorSessions(cfg, latencyStats);
+        }
+        catch (const std::exception& e) {
+            util::logError("Failed to run sessions on executor ({})", e.what());
+            return EXIT_FAILURE;
+        }
+    }
+    else if (cfg.server.has_value()) {
+        txThread = std::thread(startTransmitter, std::ref(cfg), latencyStats);
     }
 
-    if (cfg.client.has_value()) {
-        rxThread = std::thread(startReceiver, std::ref(cfg));
+    if (cfg.common.executorThreads == 0 && cfg.client.has_value()) {
+        rxThread = std::thread(startReceiver, std::ref(cfg), latencyStats);
     }
 
-    bool txJoined = !cfg.server.has_value();
-    bool rxJoined = !cfg.client.has_value();
+    bool txJoined = !txThread.joinable();
+    bool rxJoined = !rxThread.joinable();
     while (!(txJoined && rxJoined)) {
         if (txThread.joinable()) {
             txThread.join();
@@ -551,5 +1617,28 @@ int main(int argc, char** argv)
         }
     }
 
+    if (cfg.common.traceFile.has_value()) {
+        util::Tracer::stop();
+    }
+
+    if (latencyStats != nullptr) {
+        latencyStats->printSummary(std::cout);
+
+        if (cfg.common.latencyHistogramFile.has_value()) {
+            std::ofstream histogramFile(cfg.common.latencyHistogramFile.value());
+            if (histogramFile.is_open()) {
+                latencyStats->histogram().writeCsv(histogramFile);
+            }
+            else {
+                util::logError("Failed to open latency histogram file '{}'", cfg.common.latencyHistogramFile.value());
+            }
+        }
+    }
+
+    // Write the final metric values
+    metricsExporters.clear();
+
+    util::Logger::disableAsync();
+
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "util/crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace {
+
+// CRC32C polynomial, bit-reversed
+constexpr uint32_t polynomial = 0x82F63B78;
+
+// Slicing-by-8 tables: tables[k][b] is the CRC of byte b followed by k zero bytes
+constexpr auto tables = []() {
+    std::array<std::array<uint32_t, 256>, 8> t{};
+    for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t crc = b;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+        }
+        t[0][b] = crc;
+    }
+    for (size_t k = 1; k < t.size(); ++k) {
+        for (uint32_t b = 0; b < 256; ++b) {
+            t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+        }
+    }
+    return t;
+}();
+
+uint64_t load64(const std::byte* p) noexcept
+{
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Updates a CRC which has already been inverted, eight bytes at a time
+uint32_t updatePortable(uint32_t crc, const std::byte* p, size_t len) noexcept
+{
+    for (; len >= 8; p += 8, len -= 8) {
+        const uint64_t word = load64(p) ^ crc;
+        crc = tables[7][word & 0xFF] ^ tables[6][(word >> 8) & 0xFF] ^ tables[5][(word >> 16) & 0xFF] ^
+              tables[4][(word >> 24) & 0xFF] ^ tables[3][(word >> 32) & 0xFF] ^ tables[2][(word >> 40) & 0xFF] ^
+              tables[1][(word >> 48) & 0xFF] ^ tables[0][word >> 56];
+    }
+    for (; len > 0; ++p, --len) {
+        crc = (crc >> 8) ^ tables[0][(crc ^ std::to_integer<uint32_t>(*p)) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+// The CRC32 instruction computes CRC32C directly. Its latency is three cycles, so for packet-sized buffers a single
+// dependency chain over 8-byte words runs at a fraction of a nanosecond per byte.
+[[gnu::target("sse4.2")]] uint32_t updateHardware(uint32_t crc, const std::byte* p, size_t len) noexcept
+{
+    uint64_t crc64 = crc;
+    for (; len >= 8; p += 8, len -= 8) {
+        crc64 = _mm_crc32_u64(crc64, load64(p));
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; len > 0; ++p, --len) {
+        crc = _mm_crc32_u8(crc, std::to_integer<uint8_t>(*p));
+    }
+    return crc;
+}
+
+uint32_t update(const uint32_t crc, const std::byte* p, const size_t len) noexcept
+{
+    static const bool hasCrc32Instruction = __builtin_cpu_supports("sse4.2");
+    return hasCrc32Instruction ? updateHardware(crc, p, len) : updatePortable(crc, p, len);
+}
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+uint32_t update(uint32_t crc, const std::byte* p, size_t len) noexcept
+{
+    for (; len >= 8; p += 8, len -= 8) {
+        crc = __crc32cd(crc, load64(p));
+    }
+    for (; len > 0; ++p, --len) {
+        crc = __crc32cb(crc, std::to_integer<uint8_t>(*p));
+    }
+    return crc;
+}
+#else
+uint32_t update(const uint32_t crc, const std::byte* p, const size_t len) noexcept
+{
+    return updatePortable(crc, p, len);
+}
+#endif
+
+} // namespace
+
+uint32_t util::crc32c(std::span<const std::byte> data, const uint32_t crc) noexcept
+{
+    return ~update(~crc, data.data(), data.size());
+}
+
+uint32_t util::crc32cPortable(std::span<const std::byte> data, const uint32_t crc) noexcept
+{
+    return ~updatePortable(~crc, data.data(), data.size());
+}
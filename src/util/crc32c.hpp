@@ -0,0 +1,19 @@
+#ifndef _UTIL_CRC32C_HPP_
+#define _UTIL_CRC32C_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace util {
+
+// Computes the CRC32C (Castagnoli) checksum of the data, using the CPU's CRC32 instructions where available. A
+// checksum over several spans can be built up by passing the result for the previous span as crc.
+uint32_t crc32c(std::span<const std::byte> data, uint32_t crc = 0) noexcept;
+
+// As crc32c, but computed with lookup tables even if the CPU supports CRC32 instructions
+uint32_t crc32cPortable(std::span<const std::byte> data, uint32_t crc = 0) noexcept;
+
+} // namespace util
+
+#endif
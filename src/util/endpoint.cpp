@@ -95,6 +95,21 @@ bool util::Endpoint::setRecvTimeout(const uint64_t timeoutSeconds, const uint64_
     return socket_.setRecvTimeout(timeoutSeconds, timeoutMicroseconds);
 }
 
+bool util::Endpoint::setNonBlocking(const bool nonBlocking) const noexcept
+{
+    return socket_.setNonBlocking(nonBlocking);
+}
+
+bool util::Endpoint::setBusyPoll(const std::chrono::microseconds busyPollTime) const noexcept
+{
+    return socket_.setBusyPoll(busyPollTime);
+}
+
+bool util::Endpoint::enableTimestamping() const noexcept
+{
+    return socket_.enableTimestamping();
+}
+
 std::optional<size_t> util::Endpoint::send(std::span<const std::byte> buffer) const noexcept
 {
     return socket_.send(buffer);
@@ -127,4 +142,9 @@ std::optional<size_t> util::Endpoint::sendTo(std::span<const std::byte> buffer,
 std::optional<size_t> util::Endpoint::recvFrom(std::span<std::byte> buffer) const noexcept
 {
     return socket_.recvFrom(buffer);
-}
\ No newline at end of file
+}
+std::optional<size_t> util::Endpoint::recvFrom(std::span<std::byte> buffer,
+                                               std::optional<Socket::Timestamp>& rxTime) const noexcept
+{
+    return socket_.recvFrom(buffer, rxTime);
+}
@@ -34,6 +34,11 @@ public:
     // the provided argument(s).
     bool accept(std::optional<std::string_view> expectedHost = std::nullopt);
     bool setRecvTimeout(const uint64_t timeoutSeconds, const uint64_t timeoutMicroseconds) const;
+    bool setNonBlocking(const bool nonBlocking) const noexcept;
+    bool setBusyPoll(const std::chrono::microseconds busyPollTime) const noexcept;
+    bool enableTimestamping() const noexcept;
+    // The file descriptor of the endpoint's socket, for use with an event loop
+    Socket::SocketID fileDescriptor() const noexcept { return socket_.id(); }
 
     std::optional<size_t> send(std::span<const std::byte> buffer) const noexcept;
     std::optional<size_t> recv(std::span<std::byte> buffer) const noexcept;
@@ -42,6 +47,8 @@ public:
                                  std::string_view destinationService) const noexcept;
     std::optional<size_t> sendTo(std::span<const std::byte> buffer, const addrinfo& ai) const noexcept;
     std::optional<size_t> recvFrom(std::span<std::byte> buffer) const noexcept;
+    std::optional<size_t> recvFrom(std::span<std::byte> buffer,
+                                   std::optional<Socket::Timestamp>& rxTime) const noexcept;
 
 private:
     // The socket used for communication at this endpoint
@@ -0,0 +1,207 @@
+#include "util/executor.hpp"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <thread>
+
+void util::Task::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+{
+    handle.promise().executor_->taskFinished(handle);
+}
+
+util::Executor::Executor() : epollFd_{::epoll_create1(EPOLL_CLOEXEC)}
+{
+    if (epollFd_ == -1) {
+        throw ExecutorException(std::format("failed to create epoll instance ({})", std::strerror(errno)));
+    }
+}
+
+util::Executor::~Executor()
+{
+    // Destroy any tasks that never completed, such as those still waiting on a timer or file descriptor if run() exited
+    // early. The waiters they hold are released first, since nothing may resume them now.
+    ready_.clear();
+    timers_.clear();
+    for (auto handle : std::exchange(liveTasks_, {})) {
+        handle.destroy();
+    }
+    ::close(epollFd_);
+}
+
+void util::Executor::spawn(Task&& task)
+{
+    auto handle = std::exchange(task.handle_, nullptr);
+    handle.promise().executor_ = this;
+    liveTasks_.insert(handle);
+    ready_.push_back(handle);
+}
+
+void util::Executor::suspend(
+    Waiter& waiter, std::coroutine_handle<> handle, std::optional<TimePoint> deadline, int fd, Event* event)
+{
+    waiter.handle_ = handle;
+
+    if (deadline.has_value()) {
+        waiter.timer_ = timers_.emplace(deadline.value(), &waiter);
+    }
+
+    if (fd != -1) {
+        // Register for a single notification, re-arming the file descriptor if it has been registered before
+        epoll_event ev{.events = EPOLLIN | EPOLLONESHOT, .data = {.ptr = &waiter}};
+        if (::epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev) == -1 &&
+            (errno != ENOENT || ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) == -1)) {
+            throw ExecutorException(std::format("failed to wait on file descriptor {} ({})", fd, std::strerror(errno)));
+        }
+        waiter.fd_ = fd;
+    }
+
+    if (event != nullptr) {
+        event->waiters_.push_back(&waiter);
+        waiter.event_ = event;
+    }
+}
+
+void util::Executor::wake(Waiter& waiter, const bool timedOut)
+{
+    if (waiter.timer_.has_value()) {
+        timers_.erase(waiter.timer_.value());
+        waiter.timer_.reset();
+    }
+
+    if (waiter.fd_ != -1 && timedOut) {
+        // Disarm the file descriptor, leaving it registered so it can be re-armed cheaply
+        epoll_event ev{.events = 0, .data = {.ptr = nullptr}};
+        ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, waiter.fd_, &ev);
+    }
+
+    if (waiter.event_ != nullptr && timedOut) {
+        std::erase(waiter.event_->waiters_, &waiter);
+    }
+
+    waiter.timedOut_ = timedOut;
+    ready_.push_back(waiter.handle_);
+}
+
+void util::Executor::taskFinished(std::coroutine_handle<Task::promise_type> handle) noexcept
+{
+    if (handle.promise().exception_ && !exception_) {
+        exception_ = handle.promise().exception_;
+    }
+    liveTasks_.erase(handle);
+    handle.destroy();
+}
+
+void util::Executor::run()
+{
+    constexpr size_t maxEvents = 64;
+    std::array<epoll_event, maxEvents> events;
+
+    while (!liveTasks_.empty()) {
+        // Resume the coroutines that are ready. Any that become ready in the meantime, such as those that yield, wait
+        // until the file descriptors have been polled, so a busy coroutine cannot starve the others.
+        for (auto numReady = ready_.size(); numReady > 0; --numReady) {
+            auto handle = ready_.front();
+            ready_.pop_front();
+            handle.resume();
+        }
+
+        if (liveTasks_.empty()) {
+            break;
+        }
+
+        // Poll if coroutines are still ready, otherwise block until a file descriptor is ready or the earliest
+        // deadline passes
+        timespec timeout{};
+        const timespec* timeoutPtr = nullptr;
+        if (!ready_.empty()) {
+            timeoutPtr = &timeout;
+        }
+        else if (!timers_.empty()) {
+            const auto remaining = std::max(timers_.begin()->first - ClockType::now(), ClockType::duration::zero());
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+            timeout = {.tv_sec = ns / 1'000'000'000, .tv_nsec = ns % 1'000'000'000};
+            timeoutPtr = &timeout;
+        }
+
+        const auto numEvents = ::epoll_pwait2(epollFd_, events.data(), events.size(), timeoutPtr, nullptr);
+        if (numEvents == -1 && errno != EINTR) {
+            throw ExecutorException(std::format("failed to wait for events ({})", std::strerror(errno)));
+        }
+
+        for (int i = 0; i < numEvents; ++i) {
+            if (auto* waiter = static_cast<Waiter*>(events[i].data.ptr); waiter != nullptr) {
+                wake(*waiter, false);
+            }
+        }
+
+        const auto now = ClockType::now();
+        while (!timers_.empty() && timers_.begin()->first <= now) {
+            wake(*timers_.begin()->second, true);
+        }
+    }
+
+    if (exception_) {
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+}
+
+void util::Event::set()
+{
+    if (waiters_.empty()) {
+        isSet_ = true;
+        return;
+    }
+
+    for (auto* waiter : std::exchange(waiters_, {})) {
+        waiter->event_ = nullptr;
+        executor_.wake(*waiter, false);
+    }
+}
+
+util::ExecutorPool::ExecutorPool(const size_t numExecutors)
+{
+    if (numExecutors == 0) {
+        throw ExecutorException("an executor pool requires at least one executor");
+    }
+    for (size_t i = 0; i < numExecutors; ++i) {
+        executors_.push_back(std::make_unique<Executor>());
+    }
+}
+
+util::Executor& util::ExecutorPool::next() noexcept
+{
+    auto& executor = *executors_[nextExecutor_];
+    nextExecutor_ = (nextExecutor_ + 1) % executors_.size();
+    return executor;
+}
+
+void util::ExecutorPool::run()
+{
+    std::vector<std::exception_ptr> exceptions(executors_.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < executors_.size(); ++i) {
+        threads.emplace_back([this, i, &exceptions]() {
+            try {
+                executors_[i]->run();
+            }
+            catch (...) {
+                exceptions[i] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
@@ -0,0 +1,217 @@
+#ifndef _UTIL_EXECUTOR_HPP_
+#define _UTIL_EXECUTOR_HPP_
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+struct ExecutorException : public std::runtime_error {
+    explicit ExecutorException(const std::string& what) : std::runtime_error(what){};
+};
+
+class Event;
+class Executor;
+
+/*
+ * A coroutine run by an Executor. A Task does not start until it is passed to Executor::spawn, after which the executor
+ * owns it and destroys its frame when it completes, or when the executor is destroyed if it never does.
+ */
+class Task {
+public:
+    struct promise_type {
+        // Hands the completed coroutine back to its executor, which destroys it
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+            void await_resume() noexcept {}
+        };
+
+        Task get_return_object() noexcept { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+        Executor* executor_ = nullptr;
+        std::exception_ptr exception_;
+    };
+
+    Task(Task&& other) noexcept : handle_{std::exchange(other.handle_, nullptr)} {}
+    Task& operator=(Task&&) = delete;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task()
+    {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+private:
+    friend class Executor;
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_{handle} {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/*
+ * Runs many coroutines on a single thread. Coroutines suspend until a file descriptor becomes readable, a deadline
+ * passes or an Event is set, and are resumed by an epoll loop in run(). Since no coroutine runs concurrently with
+ * another on the same executor, state shared between them needs no locking.
+ *
+ * Other than spawn() before run() is called, an executor and the coroutines and Events belonging to it may only be used
+ * from the thread calling run().
+ */
+class Executor {
+public:
+    using ClockType = std::chrono::steady_clock;
+    using TimePoint = ClockType::time_point;
+
+    // The state of a suspended coroutine, which may be waiting on a deadline together with a file descriptor or Event.
+    struct Waiter {
+        std::coroutine_handle<> handle_;
+        std::optional<std::multimap<TimePoint, Waiter*>::iterator> timer_;
+        int fd_ = -1;
+        Event* event_ = nullptr;
+        bool timedOut_ = false;
+    };
+
+    Executor();
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    ~Executor();
+
+    // Takes ownership of a task and schedules it to start when the executor runs
+    void spawn(Task&& task);
+
+    // Runs coroutines until every spawned task has completed. Rethrows the first exception to escape a task.
+    void run();
+
+    // Suspends the calling coroutine until the deadline has passed
+    auto sleepUntil(const TimePoint deadline) noexcept { return WaitAwaiter{*this, deadline, -1, nullptr}; }
+    auto sleepFor(const std::chrono::nanoseconds duration) noexcept { return sleepUntil(ClockType::now() + duration); }
+
+    // Suspends the calling coroutine until the file descriptor is readable. Returns false if the deadline passes first.
+    auto readable(const int fd, const std::optional<TimePoint> deadline = std::nullopt) noexcept
+    {
+        return WaitAwaiter{*this, deadline, fd, nullptr};
+    }
+
+    // Reschedules the calling coroutine behind any others that are ready to run
+    auto yield() noexcept
+    {
+        struct YieldAwaiter {
+            Executor& executor_;
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { executor_.ready_.push_back(handle); }
+            void await_resume() noexcept {}
+        };
+        return YieldAwaiter{*this};
+    }
+
+private:
+    friend class Event;
+    friend class Task;
+
+    struct WaitAwaiter {
+        Executor& executor_;
+        std::optional<TimePoint> deadline_;
+        int fd_;
+        Event* event_;
+        Waiter waiter_{};
+
+        bool await_ready() noexcept
+        {
+            waiter_.timedOut_ = deadline_.has_value() && deadline_ <= ClockType::now();
+            return waiter_.timedOut_;
+        }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            executor_.suspend(waiter_, handle, deadline_, fd_, event_);
+        }
+        // True if woken by the file descriptor or Event rather than the deadline
+        bool await_resume() const noexcept { return !waiter_.timedOut_ && (fd_ != -1 || event_ != nullptr); }
+    };
+
+    void suspend(Waiter& waiter,
+                 std::coroutine_handle<> handle,
+                 std::optional<TimePoint> deadline,
+                 int fd,
+                 Event* event);
+    // Cancels whichever of the waiter's conditions did not fire and schedules it to resume
+    void wake(Waiter& waiter, bool timedOut);
+    void taskFinished(std::coroutine_handle<Task::promise_type> handle) noexcept;
+
+    int epollFd_;
+    // Frames of the spawned tasks that have not yet completed
+    std::unordered_set<std::coroutine_handle<Task::promise_type>> liveTasks_;
+    std::deque<std::coroutine_handle<>> ready_;
+    std::multimap<TimePoint, Waiter*> timers_;
+    std::exception_ptr exception_;
+};
+
+/*
+ * An auto-reset event on which coroutines belonging to a single executor can wait. Setting the event wakes every
+ * waiting coroutine, or if none are waiting, lets the next call to wait() complete immediately.
+ */
+class Event {
+public:
+    explicit Event(Executor& executor) noexcept : executor_{executor} {}
+
+    void set();
+
+    // Suspends the calling coroutine until the event is set. Returns false if the deadline passes first.
+    auto wait(const std::optional<Executor::TimePoint> deadline = std::nullopt) noexcept
+    {
+        struct EventAwaiter : Executor::WaitAwaiter {
+            bool await_ready() noexcept
+            {
+                return std::exchange(event_->isSet_, false) || Executor::WaitAwaiter::await_ready();
+            }
+        };
+        return EventAwaiter{{executor_, deadline, -1, this}};
+    }
+
+private:
+    friend class Executor;
+
+    Executor& executor_;
+    bool isSet_ = false;
+    std::vector<Executor::Waiter*> waiters_;
+};
+
+/*
+ * A set of executors, each run on its own thread, over which tasks are distributed round-robin. Typically there is one
+ * executor per core.
+ */
+class ExecutorPool {
+public:
+    explicit ExecutorPool(const size_t numExecutors);
+
+    // The executor to which the next task should be spawned
+    Executor& next() noexcept;
+
+    // Runs every executor on its own thread until all their tasks have completed. Rethrows the first exception to
+    // escape a task.
+    void run();
+
+private:
+    std::vector<std::unique_ptr<Executor>> executors_;
+    size_t nextExecutor_ = 0;
+};
+
+} // namespace util
+
+#endif
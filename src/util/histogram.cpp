@@ -0,0 +1,82 @@
+#include "util/histogram.hpp"
+
+#include <cmath>
+#include <format>
+
+util::LatencyHistogram::LatencyHistogram(const LatencyHistogram& other) :
+    counts_{std::make_unique<std::array<uint64_t, bucketCount>>(*other.counts_)},
+    count_{other.count_},
+    sum_{other.sum_},
+    min_{other.min_},
+    max_{other.max_}
+{
+}
+
+util::LatencyHistogram& util::LatencyHistogram::operator=(const LatencyHistogram& other)
+{
+    if (this != &other) {
+        *counts_ = *other.counts_;
+        count_ = other.count_;
+        sum_ = other.sum_;
+        min_ = other.min_;
+        max_ = other.max_;
+    }
+    return *this;
+}
+
+void util::LatencyHistogram::merge(const LatencyHistogram& other) noexcept
+{
+    for (size_t i = 0; i < bucketCount; ++i) {
+        (*counts_)[i] += (*other.counts_)[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void util::LatencyHistogram::reset() noexcept
+{
+    counts_->fill(0);
+    count_ = 0;
+    sum_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+}
+
+uint64_t util::LatencyHistogram::valueAtPercentile(const double percentile) const noexcept
+{
+    if (count_ == 0) {
+        return 0;
+    }
+
+    // Number of values at or below the requested percentile, which is at least one
+    const auto clamped = std::clamp(percentile, 0.0, 100.0);
+    const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count_)));
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        cumulative += (*counts_)[i];
+        if (cumulative >= target) {
+            return std::min(bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+void util::LatencyHistogram::writeCsv(std::ostream& out) const
+{
+    out << "lower,upper,count,percentile\n";
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        if (const auto bucketValues = (*counts_)[i]; bucketValues != 0) {
+            cumulative += bucketValues;
+            out << std::format("{},{},{},{:.6f}\n",
+                               bucketLowerBound(i),
+                               bucketUpperBound(i),
+                               bucketValues,
+                               100.0 * cumulative / count_);
+        }
+    }
+}
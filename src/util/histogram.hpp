@@ -0,0 +1,106 @@
+#ifndef _UTIL_HISTOGRAM_HPP_
+#define _UTIL_HISTOGRAM_HPP_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <ostream>
+
+namespace util {
+
+/*
+ * An HDR-style histogram of non-negative integer values (e.g. latencies in ns). Values are bucketed by their power of
+ * two, with each power of two split into a fixed number of linear sub-buckets, so the relative error of any reported
+ * value is bounded (below 1%) across the full uint64_t range. Recording is O(1) and allocation free, so it is suitable
+ * for use on the packet path. Recording is not thread-safe; use one histogram per thread and merge them.
+ */
+class LatencyHistogram {
+public:
+    // Each power of two is split into 2^subBucketBits / 2 sub-buckets
+    static constexpr size_t subBucketBits = 8;
+    static constexpr size_t subBucketCount = size_t{1} << subBucketBits;
+    static constexpr size_t subBucketHalfCount = subBucketCount / 2;
+    static constexpr size_t bucketCount =
+        subBucketCount + (std::numeric_limits<uint64_t>::digits - subBucketBits) * subBucketHalfCount;
+
+    LatencyHistogram() : counts_{std::make_unique<std::array<uint64_t, bucketCount>>()} {}
+
+    LatencyHistogram(const LatencyHistogram& other);
+    LatencyHistogram& operator=(const LatencyHistogram& other);
+    LatencyHistogram(LatencyHistogram&&) = default;
+    LatencyHistogram& operator=(LatencyHistogram&&) = default;
+
+    void record(const uint64_t value) noexcept
+    {
+        ++(*counts_)[bucketIndex(value)];
+        ++count_;
+        sum_ += value;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+
+    // Adds every value recorded in other to this histogram
+    void merge(const LatencyHistogram& other) noexcept;
+
+    void reset() noexcept;
+
+    uint64_t count() const noexcept { return count_; }
+
+    // Smallest and largest values recorded, exactly. Both are zero if no values have been recorded.
+    uint64_t min() const noexcept { return count_ == 0 ? 0 : min_; }
+    uint64_t max() const noexcept { return max_; }
+
+    double mean() const noexcept { return count_ == 0 ? 0.0 : static_cast<double>(sum_) / count_; }
+
+    // Returns the value at the given percentile (0 to 100) - i.e. the largest value that could have been recorded in
+    // the bucket containing that percentile, clamped to the recorded maximum. Returns zero if no values are recorded.
+    uint64_t valueAtPercentile(const double percentile) const noexcept;
+
+    // Writes a CSV of every non-empty bucket, in the form lower,upper,count,cumulative percentile
+    void writeCsv(std::ostream& out) const;
+
+    static constexpr size_t bucketIndex(const uint64_t value) noexcept
+    {
+        if (value < subBucketCount) {
+            return value;
+        }
+        const size_t shift = std::bit_width(value) - subBucketBits;
+        return subBucketCount + (shift - 1) * subBucketHalfCount + ((value >> shift) - subBucketHalfCount);
+    }
+
+    // Smallest value mapping to the given bucket
+    static constexpr uint64_t bucketLowerBound(const size_t index) noexcept
+    {
+        if (index < subBucketCount) {
+            return index;
+        }
+        const size_t offset = index - subBucketCount;
+        const size_t shift = offset / subBucketHalfCount + 1;
+        return static_cast<uint64_t>(offset % subBucketHalfCount + subBucketHalfCount) << shift;
+    }
+
+    // Largest value mapping to the given bucket
+    static constexpr uint64_t bucketUpperBound(const size_t index) noexcept
+    {
+        if (index < subBucketCount) {
+            return index;
+        }
+        const size_t shift = (index - subBucketCount) / subBucketHalfCount + 1;
+        return bucketLowerBound(index) + ((uint64_t{1} << shift) - 1);
+    }
+
+private:
+    // Counts are heap allocated, as the array is too large to place on the stack
+    std::unique_ptr<std::array<uint64_t, bucketCount>> counts_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = std::numeric_limits<uint64_t>::max();
+    uint64_t max_ = 0;
+};
+
+} // namespace util
+
+#endif
@@ -0,0 +1,130 @@
+#include "util/logging.hpp"
+
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <thread>
+
+util::AsyncLogQueue::AsyncLogQueue(const size_t capacity) :
+    capacity_{std::bit_ceil(capacity)}, entries_{std::make_unique<Entry[]>(capacity_)}
+{
+    for (size_t i = 0; i < capacity_; ++i) {
+        entries_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+}
+
+// Each entry's sequence number indicates its state: equal to the enqueue position when free, one greater when it
+// holds a message for the consumer, and advanced by the capacity once consumed.
+auto util::AsyncLogQueue::claimEntry() noexcept -> Entry*
+{
+    auto pos = enqueuePos_.load(std::memory_order_relaxed);
+    while (true) {
+        auto& entry = entries_[pos & (capacity_ - 1)];
+        const auto seq = entry.sequence_.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            // Claims are sequentially consistent, so that producers are ordered against a marker by
+            // tryPushIfOpen()
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return &entry;
+            }
+        }
+        else if (diff < 0) {
+            return nullptr; // Queue is full
+        }
+        else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool util::AsyncLogQueue::tryPushMarker() noexcept
+{
+    auto* entry = claimEntry();
+    if (entry == nullptr) {
+        return false;
+    }
+    entry->type_ = EntryType::MARKER;
+    publishEntry(entry);
+    return true;
+}
+
+void util::AsyncLogQueue::publishEntry(Entry* entry) noexcept
+{
+    entry->sequence_.store(entry->sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+auto util::AsyncLogQueue::frontEntry() noexcept -> Entry*
+{
+    auto& entry = entries_[dequeuePos_ & (capacity_ - 1)];
+    return entry.sequence_.load(std::memory_order_acquire) == dequeuePos_ + 1 ? &entry : nullptr;
+}
+
+void util::AsyncLogQueue::popEntry(Entry* entry) noexcept
+{
+    entry->sequence_.store(dequeuePos_ + capacity_, std::memory_order_release);
+    ++dequeuePos_;
+}
+
+// Interval at which the logging thread polls the async queue when it is empty
+static constexpr auto asyncPollInterval = std::chrono::milliseconds(1);
+
+static std::mutex asyncMutex;
+static std::thread asyncLoggingThread;
+
+void util::Logger::enableAsync(const size_t queueCapacity)
+{
+    std::scoped_lock lock(asyncMutex);
+    if (asyncEnabled_) {
+        return;
+    }
+    // The queue is never destroyed, since logging threads may still hold a reference to it
+    if (asyncQueue_ == nullptr) {
+        asyncQueue_ = std::make_unique<AsyncLogQueue>(queueCapacity);
+    }
+    asyncEnabled_.store(true, std::memory_order_release);
+    asyncLoggingThread = std::thread(asyncThread);
+}
+
+void util::Logger::disableAsync()
+{
+    std::scoped_lock lock(asyncMutex);
+    if (!asyncEnabled_) {
+        return;
+    }
+    asyncEnabled_.store(false, std::memory_order_seq_cst);
+
+    // The logging thread exits at the marker, having flushed every message claimed before it. Any producer claiming
+    // an entry after the marker sees async logging disabled and prints its message itself.
+    while (!asyncQueue_->tryPushMarker()) {
+        std::this_thread::yield();
+    }
+    asyncLoggingThread.join();
+}
+
+void util::Logger::asyncThread()
+{
+    auto print = [](const LoggingLevel level,
+                    const std::optional<std::chrono::time_point<LogClock>> time,
+                    std::string_view message) { printMessage(level, time, message); };
+
+    // Report drops as they happen, so that gaps in the log are visible
+    uint64_t reportedDrops = asyncQueue_->dropped();
+    auto reportDrops = [&reportedDrops]() {
+        if (const auto dropped = asyncQueue_->dropped(); dropped != reportedDrops) {
+            printMessage(LOGGING_LEVEL_WARNING,
+                         std::nullopt,
+                         std::format("{} log messages dropped (async log queue full)", dropped - reportedDrops));
+            reportedDrops = dropped;
+        }
+    };
+
+    // Run until the marker queued by disableAsync(), behind which no more messages can be queued
+    bool markerReached = false;
+    while (!markerReached) {
+        if (asyncQueue_->drain(print, &markerReached) == 0 && !markerReached) {
+            std::this_thread::sleep_for(asyncPollInterval);
+        }
+        reportDrops();
+    }
+}
@@ -3,13 +3,21 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <exception>
+#include <memory>
+#include <new>
+#include <optional>
 #include <print>
 #include <ranges>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
 
 namespace util {
 
@@ -21,6 +29,172 @@ enum LoggingLevel : uint16_t {
     LOGGING_LEVEL_DEBUG
 };
 
+// Most verbose logging level compiled into the binary, set by the COMPILED_LOGGING_LEVEL CMake option. Calls to log
+// functions above this level compile to nothing, so they have no runtime cost regardless of the runtime logging level.
+#ifndef UTIL_COMPILED_LOGGING_LEVEL
+#define UTIL_COMPILED_LOGGING_LEVEL LOGGING_LEVEL_DEBUG
+#endif
+constexpr LoggingLevel compiledLoggingLevel = UTIL_COMPILED_LOGGING_LEVEL;
+
+using LogClock = std::chrono::high_resolution_clock;
+
+/*
+ * A bounded multi-producer single-consumer queue of log messages awaiting formatting. Producers copy the format string
+ * and arguments into a fixed-size slot; the consumer formats them later. If the queue is full, the message is dropped
+ * and counted rather than blocking the producer.
+ */
+class AsyncLogQueue {
+public:
+    enum class PushResult { QUEUED, FULL, CLOSED };
+
+    explicit AsyncLogQueue(const size_t capacity);
+
+    template <class... Args>
+    bool tryPush(const LoggingLevel level,
+                 const std::optional<std::chrono::time_point<LogClock>> time,
+                 std::format_string<Args...> message,
+                 Args&&... args) noexcept
+    {
+        auto* entry = claimEntry();
+        if (entry == nullptr) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        storeMessage(entry, level, time, message, std::forward<Args>(args)...);
+        return true;
+    }
+
+    /* Queues a message only if open is still set once an entry has been claimed. Otherwise the entry is skipped by
+     * the consumer and CLOSED is returned, leaving the caller to output the message. Since entries are claimed in
+     * order, a producer either claims its entry ahead of a marker pushed after clearing open, or sees open cleared. */
+    template <class... Args>
+    PushResult tryPushIfOpen(const std::atomic<bool>& open,
+                             const LoggingLevel level,
+                             const std::optional<std::chrono::time_point<LogClock>> time,
+                             std::format_string<Args...> message,
+                             Args&&... args) noexcept
+    {
+        auto* entry = claimEntry();
+        if (entry == nullptr) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return PushResult::FULL;
+        }
+        if (!open.load(std::memory_order_seq_cst)) {
+            entry->type_ = EntryType::SKIPPED;
+            publishEntry(entry);
+            return PushResult::CLOSED;
+        }
+        storeMessage(entry, level, time, message, std::forward<Args>(args)...);
+        return PushResult::QUEUED;
+    }
+
+    // Queues a marker, at which the consumer's drain stops. Returns false if the queue is full.
+    bool tryPushMarker() noexcept;
+
+    // Formats and passes every queued message to consume, returning the number of messages processed. Stops after
+    // the first marker, if any, in which case markerReached is set.
+    template <typename F>
+    size_t drain(F&& consume, bool* const markerReached = nullptr)
+    {
+        size_t count = 0;
+        for (auto* entry = frontEntry(); entry != nullptr; entry = frontEntry()) {
+            const auto type = entry->type_;
+            if (type == EntryType::MESSAGE) {
+                std::string message;
+                entry->formatAndDestroy_(*entry, message);
+                consume(entry->level_, entry->time_, message);
+                ++count;
+            }
+            popEntry(entry);
+            if (type == EntryType::MARKER) {
+                if (markerReached != nullptr) {
+                    *markerReached = true;
+                }
+                break;
+            }
+        }
+        return count;
+    }
+
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t argStorageSize = 192;
+
+    enum class EntryType : uint8_t { MESSAGE, SKIPPED, MARKER };
+
+    struct Entry {
+        std::atomic<size_t> sequence_;
+        EntryType type_;
+        LoggingLevel level_;
+        std::optional<std::chrono::time_point<LogClock>> time_;
+        std::string_view format_;
+        // Formats the stored arguments into the output string, then destroys them
+        void (*formatAndDestroy_)(Entry&, std::string&);
+        alignas(std::max_align_t) std::array<std::byte, argStorageSize> args_;
+    };
+
+    template <class... Args>
+    void storeMessage(Entry* entry,
+                      const LoggingLevel level,
+                      const std::optional<std::chrono::time_point<LogClock>> time,
+                      std::format_string<Args...> message,
+                      Args&&... args) noexcept
+    {
+        entry->type_ = EntryType::MESSAGE;
+        entry->level_ = level;
+        entry->time_ = time;
+        entry->format_ = message.get();
+
+        // Copy the arguments into the entry, converting strings so that they outlive the caller's buffers
+        using Stored = std::tuple<StoredArg<Args>...>;
+        if constexpr (sizeof(Stored) <= argStorageSize && alignof(Stored) <= alignof(std::max_align_t)) {
+            std::construct_at(reinterpret_cast<Stored*>(entry->args_.data()), std::forward<Args>(args)...);
+            entry->formatAndDestroy_ = &formatStored<Stored>;
+        }
+        else {
+            // Arguments are too large to defer, so format them now
+            std::construct_at(reinterpret_cast<std::string*>(entry->args_.data()),
+                              std::format(message, std::forward<Args>(args)...));
+            entry->format_ = "{}";
+            entry->formatAndDestroy_ = &formatStored<std::tuple<std::string>>;
+        }
+
+        publishEntry(entry);
+    }
+
+    // Strings are copied, since the caller's buffer may not outlive the queued message
+    template <class T>
+    using StoredArg = std::conditional_t<std::is_convertible_v<T, std::string_view> && !std::is_arithmetic_v<std::decay_t<T>>,
+                                         std::string,
+                                         std::decay_t<T>>;
+
+    template <class Stored>
+    static void formatStored(Entry& entry, std::string& out)
+    {
+        auto* stored = std::launder(reinterpret_cast<Stored*>(entry.args_.data()));
+        try {
+            out = std::apply([&entry](auto&... args) { return std::vformat(entry.format_, std::make_format_args(args...)); },
+                             *stored);
+        }
+        catch (const std::exception& e) {
+            out = std::string("failed to format log message: ") + e.what();
+        }
+        std::destroy_at(stored);
+    }
+
+    Entry* claimEntry() noexcept;
+    void publishEntry(Entry* entry) noexcept;
+    Entry* frontEntry() noexcept;
+    void popEntry(Entry* entry) noexcept;
+
+    const size_t capacity_;
+    std::unique_ptr<Entry[]> entries_;
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) size_t dequeuePos_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
 struct Logger {
     static auto getLoggingLevel() noexcept { return loggingLevel; }
 
@@ -38,15 +212,43 @@ struct Logger {
     static void logMessage(const LoggingLevel level, std::format_string<Args...> message, Args&&... args) noexcept
     {
         if (loggingLevel >= level) {
-            // Print label at fixed width, followed by formatted message
-            std::println("{}[{:^{}}]: {}",
-                         includeTimestamp ? std::format("{} ", std::chrono::high_resolution_clock::now()) : "",
-                         labels[level],
-                         len_longestLabel,
-                         std::format(message, std::forward<Args>(args)...));
+            const auto time = includeTimestamp ? std::make_optional(LogClock::now()) : std::nullopt;
+            if (asyncEnabled_.load(std::memory_order_acquire)) {
+                // Defer formatting and output to the logging thread, unless async logging was disabled before the
+                // message could be queued ahead of disableAsync()'s marker
+                if (asyncQueue_->tryPushIfOpen(asyncEnabled_, level, time, message, std::forward<Args>(args)...) !=
+                    AsyncLogQueue::PushResult::CLOSED) {
+                    return;
+                }
+            }
+            printMessage(level, time, std::format(message, std::forward<Args>(args)...));
         }
     }
 
+    // Print label at fixed width, followed by the formatted message
+    static void printMessage(const LoggingLevel level,
+                             const std::optional<std::chrono::time_point<LogClock>> time,
+                             std::string_view message) noexcept
+    {
+        std::println(output_,
+                     "{}[{:^{}}]: {}",
+                     time.has_value() ? std::format("{} ", time.value()) : "",
+                     labels[level],
+                     len_longestLabel,
+                     message);
+    }
+
+    // Formatting and output of log messages is moved to a background thread, so that logging threads only copy
+    // their arguments into a queue of the given capacity. Messages are dropped if the queue is full.
+    static void enableAsync(const size_t queueCapacity = 4096);
+
+    // Flushes any queued messages and returns to formatting and printing messages on the logging thread. Messages
+    // logged concurrently are either queued before the flush or printed directly, so none are lost.
+    static void disableAsync();
+
+    // Number of messages dropped because the async queue was full
+    static uint64_t droppedMessages() noexcept { return asyncQueue_ ? asyncQueue_->dropped() : 0; }
+
     // Get a help string listing the different logging levels
     static constexpr std::string helpText()
     {
@@ -65,6 +267,9 @@ struct Logger {
         return helpStr;
     }
 
+    // Redirect log output, which is printed to stdout by default. Must not be called while async logging is enabled.
+    static void setOutput(std::FILE* stream) noexcept { output_ = stream; }
+
     static void enableTimestamps() { includeTimestamp = true; }
 
     static void disableTimestamps() { includeTimestamp = false; }
@@ -78,32 +283,49 @@ private:
         std::ranges::max(labels | std::views::transform([](auto&& str) { return str.size(); }));
 
     static inline bool includeTimestamp = false;
+
+    static inline std::FILE* output_ = stdout;
+
+    // Background logging thread, which drains the async queue until async logging is disabled
+    static void asyncThread();
+
+    static inline std::atomic<bool> asyncEnabled_{false};
+    static inline std::unique_ptr<AsyncLogQueue> asyncQueue_;
 };
 
-// Log functions for specific logging levels:
+// Log functions for specific logging levels. Calls above compiledLoggingLevel are discarded at compile time; since
+// the arguments passed in the packet path are plain values without side effects, the optimiser removes them too.
 
 template <class... Args>
 void logError(std::format_string<Args...> message, Args&&... args) noexcept
 {
-    Logger::logMessage(LOGGING_LEVEL_ERROR, message, std::forward<Args>(args)...);
+    if constexpr (compiledLoggingLevel >= LOGGING_LEVEL_ERROR) {
+        Logger::logMessage(LOGGING_LEVEL_ERROR, message, std::forward<Args>(args)...);
+    }
 }
 
 template <class... Args>
 void logWarning(std::format_string<Args...> message, Args&&... args) noexcept
 {
-    Logger::logMessage(LOGGING_LEVEL_WARNING, message, std::forward<Args>(args)...);
+    if constexpr (compiledLoggingLevel >= LOGGING_LEVEL_WARNING) {
+        Logger::logMessage(LOGGING_LEVEL_WARNING, message, std::forward<Args>(args)...);
+    }
 }
 
 template <class... Args>
 void logInfo(std::format_string<Args...> message, Args&&... args) noexcept
 {
-    Logger::logMessage(LOGGING_LEVEL_INFO, message, std::forward<Args>(args)...);
+    if constexpr (compiledLoggingLevel >= LOGGING_LEVEL_INFO) {
+        Logger::logMessage(LOGGING_LEVEL_INFO, message, std::forward<Args>(args)...);
+    }
 }
 
 template <class... Args>
 void logDebug(std::format_string<Args...> message, Args&&... args) noexcept
 {
-    Logger::logMessage(LOGGING_LEVEL_DEBUG, message, std::forward<Args>(args)...);
+    if constexpr (compiledLoggingLevel >= LOGGING_LEVEL_DEBUG) {
+        Logger::logMessage(LOGGING_LEVEL_DEBUG, message, std::forward<Args>(args)...);
+    }
 }
 
 } // namespace util
@@ -0,0 +1,277 @@
+#include "util/metrics.hpp"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "util/logging.hpp"
+
+template <class T>
+T& util::MetricsRegistry::getOrCreate(std::string_view name, std::string_view help, const MetricLabels& labels)
+{
+    std::scoped_lock lock(mutex_);
+    for (auto& metric : metrics_) {
+        if (metric->name_ == name && metric->labels_ == labels) {
+            if (!std::holds_alternative<T>(metric->value_)) {
+                throw MetricsException(std::format("metric {} already registered with a different type", name));
+            }
+            return std::get<T>(metric->value_);
+        }
+    }
+
+    auto& metric = metrics_.emplace_back(std::make_unique<Metric>());
+    metric->name_ = name;
+    metric->help_ = help;
+    metric->labels_ = labels;
+    return metric->value_.template emplace<T>();
+}
+
+util::Counter& util::MetricsRegistry::counter(std::string_view name,
+                                              std::string_view help,
+                                              const MetricLabels& labels)
+{
+    return getOrCreate<Counter>(name, help, labels);
+}
+
+util::Gauge& util::MetricsRegistry::gauge(std::string_view name, std::string_view help, const MetricLabels& labels)
+{
+    return getOrCreate<Gauge>(name, help, labels);
+}
+
+std::vector<util::MetricSample> util::MetricsRegistry::snapshot() const
+{
+    std::vector<MetricSample> samples;
+    {
+        std::scoped_lock lock(mutex_);
+        samples.reserve(metrics_.size());
+        for (const auto& metric : metrics_) {
+            const bool isCounter = std::holds_alternative<Counter>(metric->value_);
+            samples.push_back({.name = metric->name_,
+                               .help = metric->help_,
+                               .type = isCounter ? MetricType::COUNTER : MetricType::GAUGE,
+                               .labels = metric->labels_,
+                               .value = isCounter ? static_cast<int64_t>(std::get<Counter>(metric->value_).value())
+                                                  : std::get<Gauge>(metric->value_).value()});
+        }
+    }
+
+    // Metrics with the same name must be adjacent in the Prometheus format
+    std::ranges::stable_sort(samples, {}, &MetricSample::name);
+    return samples;
+}
+
+util::MetricsRegistry& util::MetricsRegistry::global()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+// Escapes backslashes, quotes and newlines, as required by both Prometheus label values and JSON strings
+static std::string escape(std::string_view str)
+{
+    std::string out;
+    out.reserve(str.size());
+    for (const auto c : str) {
+        switch (c) {
+            case '\\':
+                out += "\\\\";
+                break;
+            case '"':
+                out += "\\\"";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            default:
+                out += c;
+        }
+    }
+    return out;
+}
+
+std::string util::toPrometheus(const std::vector<MetricSample>& samples)
+{
+    std::string out;
+    std::string_view lastName;
+    for (const auto& sample : samples) {
+        if (sample.name != lastName) {
+            out += std::format("# HELP {} {}\n", sample.name, sample.help);
+            out += std::format("# TYPE {} {}\n", sample.name, sample.type == MetricType::COUNTER ? "counter" : "gauge");
+            lastName = sample.name;
+        }
+
+        out += sample.name;
+        if (!sample.labels.empty()) {
+            out += '{';
+            for (size_t i = 0; i < sample.labels.size(); ++i) {
+                const auto& [key, value] = sample.labels[i];
+                out += std::format("{}{}=\"{}\"", i == 0 ? "" : ",", key, escape(value));
+            }
+            out += '}';
+        }
+        out += std::format(" {}\n", sample.value);
+    }
+    return out;
+}
+
+std::string util::toJson(const std::vector<MetricSample>& samples)
+{
+    std::string out = "{\"metrics\": [";
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const auto& sample = samples[i];
+        out += std::format("{}{{\"name\": \"{}\", \"type\": \"{}\", \"help\": \"{}\", \"labels\": {{",
+                           i == 0 ? "" : ", ",
+                           sample.name,
+                           sample.type == MetricType::COUNTER ? "counter" : "gauge",
+                           escape(sample.help));
+        for (size_t j = 0; j < sample.labels.size(); ++j) {
+            const auto& [key, value] = sample.labels[j];
+            out += std::format("{}\"{}\": \"{}\"", j == 0 ? "" : ", ", escape(key), escape(value));
+        }
+        out += std::format("}}, \"value\": {}}}", sample.value);
+    }
+    out += "]}\n";
+    return out;
+}
+
+util::MetricsExporter::MetricsExporter(MetricsRegistry& registry,
+                                       Destination destination,
+                                       std::string path,
+                                       MetricsFormat format,
+                                       std::chrono::milliseconds interval) :
+    registry_{registry}, destination_{destination}, path_{std::move(path)}, format_{format}, interval_{interval}
+{
+    if (destination_ == Destination::UNIX_SOCKET) {
+        sockaddr_un addr{.sun_family = AF_UNIX};
+        if (path_.size() >= sizeof(addr.sun_path)) {
+            throw MetricsException(std::format("metrics socket path '{}' is too long", path_));
+        }
+        std::ranges::copy(path_, addr.sun_path);
+
+        listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd_ == -1) {
+            throw MetricsException(std::format("failed to create metrics socket ({})", std::strerror(errno)));
+        }
+
+        // Remove a socket left behind by a previous run
+        ::unlink(path_.c_str());
+        if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 || ::listen(listenFd_, 4) == -1) {
+            const auto error = errno;
+            ::close(listenFd_);
+            throw MetricsException(
+                std::format("failed to listen on metrics socket '{}' ({})", path_, std::strerror(error)));
+        }
+    }
+
+    stopFd_ = ::eventfd(0, EFD_CLOEXEC);
+    if (stopFd_ == -1) {
+        const auto error = errno;
+        if (listenFd_ != -1) {
+            ::close(listenFd_);
+        }
+        throw MetricsException(std::format("failed to create metrics exporter event ({})", std::strerror(error)));
+    }
+
+    thread_ = std::thread([this]() { exportThread(); });
+    logDebug("Exporting metrics to '{}'", path_);
+}
+
+util::MetricsExporter::~MetricsExporter()
+{
+    const uint64_t stop = 1;
+    if (::write(stopFd_, &stop, sizeof(stop)) != sizeof(stop)) {
+        logError("Failed to stop metrics exporter ({})", std::strerror(errno));
+    }
+    thread_.join();
+    ::close(stopFd_);
+
+    if (destination_ == Destination::UNIX_SOCKET) {
+        ::close(listenFd_);
+        ::unlink(path_.c_str());
+    }
+    else {
+        // Write the final values
+        writeFile();
+    }
+}
+
+std::string util::MetricsExporter::format() const
+{
+    const auto samples = registry_.snapshot();
+    return format_ == MetricsFormat::JSON ? toJson(samples) : toPrometheus(samples);
+}
+
+void util::MetricsExporter::writeFile() const
+{
+    // Write to a temporary file and rename, so the file is replaced atomically
+    const auto tempPath = path_ + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!(file << format())) {
+            logWarning("Failed to write metrics to '{}'", tempPath);
+            return;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path_, ec);
+    if (ec) {
+        logWarning("Failed to replace metrics file '{}' ({})", path_, ec.message());
+    }
+}
+
+// Accepts a connection on the metrics socket and sends it a snapshot
+void util::MetricsExporter::sendSnapshot() const
+{
+    const auto clientFd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (clientFd == -1) {
+        logWarning("Failed to accept metrics socket connection ({})", std::strerror(errno));
+        return;
+    }
+
+    const auto snapshot = format();
+    for (size_t sent = 0; sent < snapshot.size();) {
+        const auto ret = ::send(clientFd, snapshot.data() + sent, snapshot.size() - sent, MSG_NOSIGNAL);
+        if (ret == -1) {
+            logWarning("Failed to send metrics snapshot ({})", std::strerror(errno));
+            break;
+        }
+        sent += ret;
+    }
+    ::close(clientFd);
+}
+
+void util::MetricsExporter::exportThread()
+{
+    std::array<pollfd, 2> pfds{{{.fd = stopFd_, .events = POLLIN}, {.fd = listenFd_, .events = POLLIN}}};
+    const nfds_t nfds = destination_ == Destination::UNIX_SOCKET ? 2 : 1;
+
+    while (true) {
+        // Clients of the socket are served on demand, whereas the file is rewritten once per interval
+        const int timeout = destination_ == Destination::UNIX_SOCKET ? -1 : static_cast<int>(interval_.count());
+        const auto ret = ::poll(pfds.data(), nfds, timeout);
+        if (ret == -1 && errno != EINTR) {
+            logError("Metrics exporter stopped ({})", std::strerror(errno));
+            return;
+        }
+
+        if (pfds[0].revents & POLLIN) {
+            return;
+        }
+
+        if (destination_ == Destination::FILE) {
+            writeFile();
+        }
+        else if (pfds[1].revents & POLLIN) {
+            sendSnapshot();
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#ifndef _UTIL_METRICS_HPP_
+#define _UTIL_METRICS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace util {
+
+struct MetricsException : public std::runtime_error {
+    explicit MetricsException(const std::string& what) : std::runtime_error(what){};
+};
+
+// A monotonically increasing count. Updates are relaxed, so are cheap enough for the packet path.
+class Counter {
+public:
+    void increment(const uint64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// A value that may go up and down, such as a queue depth.
+class Gauge {
+public:
+    void set(const int64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+    void add(const int64_t n) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+enum class MetricType { COUNTER, GAUGE };
+
+// The value of a single metric at the time a snapshot was taken
+struct MetricSample {
+    std::string name;
+    std::string help;
+    MetricType type;
+    MetricLabels labels;
+    int64_t value;
+};
+
+/*
+ * Owns every counter and gauge exported by the process. Metrics are identified by name and labels, so requesting the
+ * same metric twice returns the same object. Metrics are never removed, so references to them remain valid for the
+ * lifetime of the registry and their final values are available once the objects updating them have been destroyed.
+ */
+class MetricsRegistry {
+public:
+    Counter& counter(std::string_view name, std::string_view help, const MetricLabels& labels = {});
+    Gauge& gauge(std::string_view name, std::string_view help, const MetricLabels& labels = {});
+
+    // Returns the current value of every metric, ordered by name
+    std::vector<MetricSample> snapshot() const;
+
+    // The registry used by the ARQ protocol implementation
+    static MetricsRegistry& global();
+
+private:
+    struct Metric {
+        std::string name_;
+        std::string help_;
+        MetricLabels labels_;
+        std::variant<Counter, Gauge> value_;
+    };
+
+    template <class T>
+    T& getOrCreate(std::string_view name, std::string_view help, const MetricLabels& labels);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Metric>> metrics_;
+};
+
+// Formats a snapshot using the Prometheus text exposition format
+std::string toPrometheus(const std::vector<MetricSample>& samples);
+
+// Formats a snapshot as a JSON object of the form {"metrics": [{"name": ..., "labels": {...}, "value": ...}, ...]}
+std::string toJson(const std::vector<MetricSample>& samples);
+
+enum class MetricsFormat { PROMETHEUS, JSON };
+
+/*
+ * Periodically exports snapshots of a registry on a background thread. Snapshots are written either to a file, which
+ * is replaced atomically so readers never see a partial snapshot, or to each client connecting to a local UNIX socket.
+ * When exporting to a file, a final snapshot is written when the exporter is destroyed.
+ */
+class MetricsExporter {
+public:
+    enum class Destination { FILE, UNIX_SOCKET };
+
+    MetricsExporter(MetricsRegistry& registry,
+                    Destination destination,
+                    std::string path,
+                    MetricsFormat format,
+                    std::chrono::milliseconds interval = std::chrono::seconds(1));
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    ~MetricsExporter();
+
+private:
+    std::string format() const;
+    void writeFile() const;
+    void sendSnapshot() const;
+    void exportThread();
+
+    MetricsRegistry& registry_;
+    const Destination destination_;
+    const std::string path_;
+    const MetricsFormat format_;
+    const std::chrono::milliseconds interval_;
+    // Listening socket, if exporting to a UNIX socket
+    int listenFd_ = -1;
+    // Event used to wake the export thread when the exporter is destroyed
+    int stopFd_ = -1;
+    std::thread thread_;
+};
+
+} // namespace util
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef _UTIL_OCCUPANCY_BITMAP_HPP_
+#define _UTIL_OCCUPANCY_BITMAP_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace util {
+
+/*
+ * A packed bitmap recording which slots of a circular window are occupied. Searches for the next occupied or free slot
+ * proceed a 64-bit word at a time using count-trailing-zeros, so locating a gap in a window of N slots takes O(N/64)
+ * rather than O(N) steps. Searches wrap around the end of the bitmap, matching the circular buffers they index.
+ */
+class OccupancyBitmap {
+public:
+    using Word = uint64_t;
+    static constexpr size_t bitsPerWord = std::numeric_limits<Word>::digits;
+
+    explicit OccupancyBitmap(const size_t size) : size_{size}, words_((size + bitsPerWord - 1) / bitsPerWord, 0) {}
+
+    size_t size() const noexcept { return size_; }
+
+    // Number of occupied slots
+    size_t count() const noexcept { return count_; }
+
+    bool test(const size_t idx) const noexcept
+    {
+        assert(idx < size_);
+        return (words_[idx / bitsPerWord] >> (idx % bitsPerWord)) & 1;
+    }
+
+    void set(const size_t idx) noexcept
+    {
+        assert(idx < size_);
+        auto& word = words_[idx / bitsPerWord];
+        const Word mask = Word{1} << (idx % bitsPerWord);
+        count_ += (word & mask) == 0;
+        word |= mask;
+    }
+
+    void reset(const size_t idx) noexcept
+    {
+        assert(idx < size_);
+        auto& word = words_[idx / bitsPerWord];
+        const Word mask = Word{1} << (idx % bitsPerWord);
+        count_ -= (word & mask) != 0;
+        word &= ~mask;
+    }
+
+    // Reallocates the bitmap from the calling thread, so that its pages are first touched there
+    void localise() { words_ = std::vector<Word>(words_); }
+
+    void clear() noexcept
+    {
+        std::ranges::fill(words_, 0);
+        count_ = 0;
+    }
+
+    // Are all the slots sharing a word with idx free?
+    bool wordEmpty(const size_t idx) const noexcept { return words_[idx / bitsPerWord] == 0; }
+
+    // Index of the first occupied slot at or after idx, wrapping around the end of the bitmap
+    std::optional<size_t> findNextSet(const size_t idx) const noexcept
+    {
+        return count_ == 0 ? std::nullopt : findNext<false>(idx);
+    }
+
+    // Index of the first free slot at or after idx, wrapping around the end of the bitmap
+    std::optional<size_t> findNextClear(const size_t idx) const noexcept
+    {
+        return count_ == size_ ? std::nullopt : findNext<true>(idx);
+    }
+
+    // The underlying words, with slot i held in bit (i % 64) of word (i / 64). Used to build selective ACKs.
+    std::span<const Word> words() const noexcept { return words_; }
+
+private:
+    // Returns the word at wordIdx, inverted if searching for free slots. Bits beyond the end of the bitmap are never
+    // reported as free.
+    template <bool Invert>
+    Word searchWord(const size_t wordIdx) const noexcept
+    {
+        Word word = Invert ? ~words_[wordIdx] : words_[wordIdx];
+        if (Invert && wordIdx == words_.size() - 1 && size_ % bitsPerWord != 0) {
+            word &= (Word{1} << (size_ % bitsPerWord)) - 1;
+        }
+        return word;
+    }
+
+    template <bool Invert>
+    std::optional<size_t> findNext(const size_t idx) const noexcept
+    {
+        assert(idx < size_);
+        const size_t firstWord = idx / bitsPerWord;
+
+        // Search the remainder of the first word, ignoring bits before idx
+        if (const auto word = searchWord<Invert>(firstWord) & (~Word{0} << (idx % bitsPerWord)); word != 0) {
+            return firstWord * bitsPerWord + std::countr_zero(word);
+        }
+
+        // Search the following words, wrapping around to include the start of the first word
+        for (size_t i = 1; i <= words_.size(); ++i) {
+            const size_t wordIdx = (firstWord + i) % words_.size();
+            if (const auto word = searchWord<Invert>(wordIdx); word != 0) {
+                return wordIdx * bitsPerWord + std::countr_zero(word);
+            }
+        }
+        return std::nullopt;
+    }
+
+    size_t size_;
+    size_t count_ = 0;
+    std::vector<Word> words_;
+};
+
+} // namespace util
+
+#endif
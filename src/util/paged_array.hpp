@@ -0,0 +1,137 @@
+#ifndef _UTIL_PAGED_ARRAY_HPP_
+#define _UTIL_PAGED_ARRAY_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+
+/*
+ * A fixed-size array whose storage is allocated in pages on demand, so that memory is only held for the parts of the
+ * array in use. Elements are default-initialised when their page is allocated. Released pages are kept for reuse up to
+ * a limit, which avoids repeatedly freeing and allocating a page as usage moves back and forth across a boundary.
+ */
+template <typename T>
+class PagedArray {
+public:
+    // The size must be a multiple of the page size. Elements are found most quickly if the page size is a power of two.
+    PagedArray(const size_t size, const size_t pageSize, const size_t maxSparePages = 1) :
+        pageSize_{pageSize},
+        pageShift_{std::has_single_bit(pageSize) ? std::optional{std::countr_zero(pageSize)} : std::nullopt},
+        pages_(size / pageSize),
+        maxSparePages_{maxSparePages}
+    {
+        assert(pageSize > 0 && pageSize <= size && size % pageSize == 0);
+    }
+
+    size_t size() const noexcept { return pages_.size() * pageSize_; }
+
+    size_t pageSize() const noexcept { return pageSize_; }
+
+    // Access an element whose page is allocated
+    T& operator[](const size_t idx) noexcept
+    {
+        assert(isAllocated(idx));
+        return pages_[pageIndex(idx)][pageOffset(idx)];
+    }
+
+    const T& operator[](const size_t idx) const noexcept
+    {
+        assert(isAllocated(idx));
+        return pages_[pageIndex(idx)][pageOffset(idx)];
+    }
+
+    bool isAllocated(const size_t idx) const noexcept { return pages_[pageIndex(idx)] != nullptr; }
+
+    // Access an element, first allocating its page if necessary
+    T& allocate(const size_t idx)
+    {
+        auto& page = pages_[pageIndex(idx)];
+        if (page == nullptr) {
+            if (!sparePages_.empty()) {
+                page = std::move(sparePages_.back());
+                sparePages_.pop_back();
+            }
+            else {
+                page = newPage();
+            }
+            ++allocatedPages_;
+        }
+        return page[pageOffset(idx)];
+    }
+
+    // Releases the page containing the element. The caller must have returned the page's elements to their
+    // default-initialised state, since the page may be reused.
+    void releasePage(const size_t idx)
+    {
+        auto& page = pages_[pageIndex(idx)];
+        if (page == nullptr) {
+            return;
+        }
+        if (sparePages_.size() < maxSparePages_) {
+            sparePages_.push_back(std::move(page));
+        }
+        else {
+            page.reset();
+        }
+        --allocatedPages_;
+    }
+
+    // Allocates and touches every page up front, keeping them all as spares so that no page is freed or faulted in
+    // afterwards. Used when page faults on the data path cannot be tolerated.
+    void prefault()
+    {
+        maxSparePages_ = pages_.size();
+        while (allocatedPages_ + sparePages_.size() < pages_.size()) {
+            auto page = newPage();
+            if constexpr (std::is_trivially_default_constructible_v<T>) {
+                // Default-initialisation leaves trivial elements untouched, so write the page to fault it in now
+                std::memset(static_cast<void*>(page.get()), 0, pageSize_ * sizeof(T));
+            }
+            sparePages_.push_back(std::move(page));
+        }
+    }
+
+    // Reallocates the page table from the calling thread, so that its pages are first touched there. Pages of
+    // elements are allocated by whichever thread first uses them.
+    void localise()
+    {
+        std::vector<std::unique_ptr<T[]>> pages(pages_.size());
+        std::ranges::move(pages_, pages.begin());
+        pages_ = std::move(pages);
+    }
+
+    // The number of pages currently holding elements
+    size_t allocatedPages() const noexcept { return allocatedPages_; }
+
+    // Bytes allocated for pages, including spare pages, and the page table
+    size_t memoryUsage() const noexcept
+    {
+        return (allocatedPages_ + sparePages_.size()) * pageSize_ * sizeof(T) +
+               pages_.capacity() * sizeof(std::unique_ptr<T[]>);
+    }
+
+private:
+    size_t pageIndex(const size_t idx) const noexcept { return pageShift_ ? idx >> *pageShift_ : idx / pageSize_; }
+    size_t pageOffset(const size_t idx) const noexcept { return pageShift_ ? idx & (pageSize_ - 1) : idx % pageSize_; }
+
+    std::unique_ptr<T[]> newPage() const { return std::make_unique_for_overwrite<T[]>(pageSize_); }
+
+    const size_t pageSize_;
+    // If the page size is a power of two, its log2, so that indices can be split without dividing
+    const std::optional<int> pageShift_;
+    std::vector<std::unique_ptr<T[]>> pages_;
+    std::vector<std::unique_ptr<T[]>> sparePages_;
+    size_t maxSparePages_;
+    size_t allocatedPages_ = 0;
+};
+
+} // namespace util
+
+#endif
@@ -0,0 +1,85 @@
+#include "util/path_mtu.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "util/address_info.hpp"
+#include "util/logging.hpp"
+#include "util/socket.hpp"
+
+// Bytes of IP and UDP headers which precede the payload of a datagram
+static constexpr size_t udpHeaderSize(const int family) noexcept
+{
+    return (family == AF_INET6 ? 40 : 20) + 8;
+}
+
+// Each probe either succeeds or lowers the kernel's estimate of the path MTU, so only a few are ever needed
+constexpr int maxProbes = 10;
+
+static std::optional<size_t> probeWithSocket(const util::Socket& socket,
+                                             const size_t headerSize,
+                                             const size_t maxSize,
+                                             const util::MakeProbeFn& makeProbe,
+                                             const std::chrono::milliseconds timeout)
+{
+    if (!socket.enablePathMtuDiscovery()) {
+        util::logWarning("failed to enable path MTU discovery on probe socket");
+        return std::nullopt;
+    }
+
+    std::optional<size_t> lastSize;
+    for (int i = 0; i < maxProbes; ++i) {
+        const auto pathMtu = socket.pathMtu();
+        if (!pathMtu.has_value() || pathMtu.value() <= headerSize) {
+            util::logWarning("failed to read path MTU from probe socket");
+            return std::nullopt;
+        }
+        const auto size = std::min(maxSize, pathMtu.value() - headerSize);
+        if (lastSize.has_value() && size >= lastSize.value()) {
+            util::logWarning("path MTU estimate did not fall below {} bytes after probe was rejected", size);
+            return std::nullopt;
+        }
+        lastSize = size;
+
+        util::logDebug("probing path MTU with datagram of {} bytes", size);
+        if (!socket.send(makeProbe(size)).has_value()) {
+            if (errno == EMSGSIZE) {
+                continue;
+            }
+            util::logWarning("failed to send path MTU probe ({})", std::strerror(errno));
+            return std::nullopt;
+        }
+
+        // A port unreachable error comes from the host itself, so the probe reached it
+        const auto error = socket.recvError(timeout);
+        if (!error.has_value() || error.value() == ECONNREFUSED) {
+            return size;
+        }
+        if (error.value() != EMSGSIZE) {
+            util::logWarning("path MTU probe failed ({})", std::strerror(error.value()));
+            return std::nullopt;
+        }
+        util::logDebug("path MTU probe of {} bytes needs fragmentation", size);
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> util::probePathMtu(std::string_view host,
+                                         std::string_view service,
+                                         const size_t maxSize,
+                                         const MakeProbeFn& makeProbe,
+                                         const std::chrono::milliseconds timeout)
+{
+    AddressInfo peerInfo{host, service, SocketType::UDP};
+    for (const auto& ai : peerInfo) {
+        Socket socket{ai};
+        if (socket.connect(ai)) {
+            return probeWithSocket(socket, udpHeaderSize(ai.ai_family), maxSize, makeProbe, timeout);
+        }
+    }
+    util::logWarning("failed to connect probe socket to host {} with service {}", host, service);
+    return std::nullopt;
+}
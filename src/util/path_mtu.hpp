@@ -0,0 +1,35 @@
+#ifndef _UTIL_PATH_MTU_HPP_
+#define _UTIL_PATH_MTU_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace util {
+
+// Returns a datagram of the given size to be sent as a probe
+using MakeProbeFn = std::function<std::vector<std::byte>(size_t size)>;
+
+/*
+ * Discovers the largest UDP payload, up to maxSize, which can be sent to the host without being fragmented, in the
+ * manner of RFC 1191. Probes are sent with the Don't Fragment bit set from a temporary socket connected to the host,
+ * starting from the smaller of maxSize and the kernel's estimate of the path MTU. A probe which is too large for the
+ * local interface fails to send, while one which is too large for a router on the path is answered with an ICMP
+ * Fragmentation Needed error, from which the kernel lowers its estimate. Either way, a smaller probe is sent, until
+ * one draws no error within the timeout.
+ *
+ * Probes reach the host, so must be recognisable as such and discarded by whatever is listening there. Paths which
+ * silently drop large datagrams, rather than reporting them, are not detected. Returns std::nullopt if probing fails.
+ */
+std::optional<size_t> probePathMtu(std::string_view host,
+                                   std::string_view service,
+                                   const size_t maxSize,
+                                   const MakeProbeFn& makeProbe,
+                                   const std::chrono::milliseconds timeout = std::chrono::milliseconds(100));
+
+} // namespace util
+
+#endif
@@ -1,10 +1,17 @@
 #include "util/socket.hpp"
 
 #include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <array>
+#include <cerrno>
+#include <cstring>
 #include <stdexcept>
 #include <utility>
 
@@ -130,6 +137,95 @@ bool util::Socket::setRecvTimeout(const uint64_t timeoutSeconds, const uint64_t
     return ret != SOCKET_ERROR;
 }
 
+bool util::Socket::setNonBlocking(const bool nonBlocking) const noexcept
+{
+    const auto flags = ::fcntl(socketID_, F_GETFL);
+    if (flags == SOCKET_ERROR) {
+        return false;
+    }
+    return ::fcntl(socketID_, F_SETFL, nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) != SOCKET_ERROR;
+}
+
+bool util::Socket::setBusyPoll(const std::chrono::microseconds busyPollTime) const noexcept
+{
+    const int busyPollMicroseconds = busyPollTime.count();
+    if (::setsockopt(socketID_, SOL_SOCKET, SO_BUSY_POLL, &busyPollMicroseconds, sizeof(busyPollMicroseconds)) ==
+        SOCKET_ERROR) {
+        return false;
+    }
+#ifdef SO_PREFER_BUSY_POLL
+    const int yes{1};
+    if (::setsockopt(socketID_, SOL_SOCKET, SO_PREFER_BUSY_POLL, &yes, sizeof(yes)) == SOCKET_ERROR) {
+        util::logWarning("failed to prefer busy polling on socket");
+    }
+#endif
+    return true;
+}
+
+bool util::Socket::enableTimestamping() const noexcept
+{
+    const unsigned int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    return ::setsockopt(socketID_, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) != SOCKET_ERROR;
+}
+
+// Returns the address family of the socket
+static int getSocketFamily(const int socketID) noexcept
+{
+    int family = AF_UNSPEC;
+    socklen_t len = sizeof(family);
+    ::getsockopt(socketID, SOL_SOCKET, SO_DOMAIN, &family, &len);
+    return family;
+}
+
+bool util::Socket::enablePathMtuDiscovery() const noexcept
+{
+    const int yes{1};
+    if (getSocketFamily(socketID_) == AF_INET6) {
+        const int discover{IPV6_PMTUDISC_DO};
+        return ::setsockopt(socketID_, IPPROTO_IPV6, IPV6_MTU_DISCOVER, &discover, sizeof(discover)) != SOCKET_ERROR &&
+               ::setsockopt(socketID_, IPPROTO_IPV6, IPV6_RECVERR, &yes, sizeof(yes)) != SOCKET_ERROR;
+    }
+    const int discover{IP_PMTUDISC_DO};
+    return ::setsockopt(socketID_, IPPROTO_IP, IP_MTU_DISCOVER, &discover, sizeof(discover)) != SOCKET_ERROR &&
+           ::setsockopt(socketID_, IPPROTO_IP, IP_RECVERR, &yes, sizeof(yes)) != SOCKET_ERROR;
+}
+
+std::optional<size_t> util::Socket::pathMtu() const noexcept
+{
+    int mtu;
+    socklen_t len = sizeof(mtu);
+    const auto ret = getSocketFamily(socketID_) == AF_INET6
+                         ? ::getsockopt(socketID_, IPPROTO_IPV6, IPV6_MTU, &mtu, &len)
+                         : ::getsockopt(socketID_, IPPROTO_IP, IP_MTU, &mtu, &len);
+    return ret == SOCKET_ERROR ? std::nullopt : std::make_optional<size_t>(mtu);
+}
+
+// Space for the control messages accompanying a timestamped datagram or error queue entry
+constexpr size_t controlBufferSize =
+    CMSG_SPACE(sizeof(scm_timestamping)) + CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6));
+using ControlBuffer = std::array<std::byte, controlBufferSize>;
+
+// Extracts the software timestamp from a message's control data, if present
+static std::optional<util::Socket::Timestamp> getSoftwareTimestamp(msghdr& msg) noexcept
+{
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_TIMESTAMPING) {
+            continue;
+        }
+        scm_timestamping timestamps;
+        std::memcpy(&timestamps, CMSG_DATA(cmsg), sizeof(timestamps));
+
+        // Software timestamps are reported in the first element, hardware timestamps in the last
+        const auto& ts = timestamps.ts[0];
+        if (ts.tv_sec == 0 && ts.tv_nsec == 0) {
+            return std::nullopt;
+        }
+        return util::Socket::Timestamp{std::chrono::duration_cast<util::Socket::Timestamp::duration>(
+            std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec})};
+    }
+    return std::nullopt;
+}
+
 static inline std::optional<size_t> returnIfNotError(const ssize_t ret)
 {
     return ret == SOCKET_ERROR ? std::nullopt : std::make_optional<size_t>(ret);
@@ -158,3 +254,40 @@ std::optional<size_t> util::Socket::recvFrom(std::span<std::byte> buffer) const
     auto ret = ::recvfrom(socketID_, buffer.data(), buffer.size(), 0, nullptr, nullptr);
     return returnIfNotError(ret);
 }
+
+std::optional<size_t> util::Socket::recvFrom(std::span<std::byte> buffer,
+                                             std::optional<Timestamp>& rxTime) const noexcept
+{
+    iovec iov{.iov_base = buffer.data(), .iov_len = buffer.size()};
+    alignas(cmsghdr) ControlBuffer control;
+    msghdr msg{.msg_iov = &iov, .msg_iovlen = 1, .msg_control = control.data(), .msg_controllen = control.size()};
+
+    auto ret = ::recvmsg(socketID_, &msg, 0);
+    rxTime = ret == SOCKET_ERROR ? std::nullopt : getSoftwareTimestamp(msg);
+    return returnIfNotError(ret);
+}
+
+std::optional<int> util::Socket::recvError(const std::chrono::milliseconds timeout) const noexcept
+{
+    // Errors are always reported by poll, so no events need be requested
+    pollfd pfd{.fd = socketID_, .events = 0, .revents = 0};
+    if (::poll(&pfd, 1, timeout.count()) <= 0 || !(pfd.revents & POLLERR)) {
+        return std::nullopt;
+    }
+
+    alignas(cmsghdr) ControlBuffer control;
+    msghdr msg{.msg_control = control.data(), .msg_controllen = control.size()};
+    if (::recvmsg(socketID_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == SOCKET_ERROR) {
+        return std::nullopt;
+    }
+
+    for (auto* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+            (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+            sock_extended_err err;
+            std::memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+            return err.ee_errno;
+        }
+    }
+    return std::nullopt;
+}
@@ -1,6 +1,8 @@
 #ifndef _UTIL_SOCKET_HPP_
 #define _UTIL_SOCKET_HPP_
 
+#include <chrono>
+#include <cstdint>
 #include <optional>
 #include <span>
 #include <string_view>
@@ -17,6 +19,9 @@ struct SocketException : public std::runtime_error {
 class Socket {
 public:
     using SocketID = int;
+    // Kernel timestamps are taken from CLOCK_REALTIME
+    using Timestamp = std::chrono::system_clock::time_point;
+
     explicit Socket() noexcept;
     explicit Socket(SocketType type);
     explicit Socket(SocketID id) noexcept;
@@ -37,11 +42,33 @@ public:
     // expectedHost is provided, only accept a connection from that host. Returns nullopt on failure.
     [[nodiscard]] std::optional<Socket> accept(std::optional<std::string_view> expectedHost = std::nullopt) const;
     bool setRecvTimeout(const uint64_t timeoutSeconds, const uint64_t timeoutMicroseconds) const;
+    // When non-blocking, recv/send fail rather than wait if no data/buffer space is available
+    bool setNonBlocking(const bool nonBlocking) const noexcept;
+    // Busy-poll the device receive queue for up to the given time on each receive, rather than waiting for an
+    // interrupt, and prefer busy polling to interrupt-driven processing where the kernel supports it. Exceeding the
+    // system default (net.core.busy_read) requires CAP_NET_ADMIN.
+    bool setBusyPoll(const std::chrono::microseconds busyPollTime) const noexcept;
+    // Asks the kernel to timestamp each datagram in software as it is received, which is earlier and less noisy than a
+    // clock read after recv returns.
+    bool enableTimestamping() const noexcept;
+
+    // Sets the Don't Fragment bit on every datagram sent, so that one larger than the kernel's estimate of the path MTU
+    // fails with EMSGSIZE, and queues ICMP errors, including Fragmentation Needed, on the error queue. The kernel only
+    // tracks the path MTU of a connected socket.
+    bool enablePathMtuDiscovery() const noexcept;
+    // The kernel's estimate of the MTU of the path to the connected peer, including IP headers
+    std::optional<size_t> pathMtu() const noexcept;
+    // Waits up to the timeout for an ICMP error to be queued on the error queue, returning its errno
+    std::optional<int> recvError(const std::chrono::milliseconds timeout) const noexcept;
+
+    SocketID id() const noexcept { return socketID_; }
 
     std::optional<size_t> send(std::span<const std::byte> buffer) const noexcept;
     std::optional<size_t> recv(std::span<std::byte> buffer) const noexcept;
     std::optional<size_t> sendTo(std::span<const std::byte> buffer, const addrinfo& ai) const noexcept;
     std::optional<size_t> recvFrom(std::span<std::byte> buffer) const noexcept;
+    // As recvFrom, additionally setting rxTime to the kernel's receive timestamp if timestamping is enabled
+    std::optional<size_t> recvFrom(std::span<std::byte> buffer, std::optional<Timestamp>& rxTime) const noexcept;
 
 private:
     SocketID socketID_;
@@ -0,0 +1,45 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "util/crc32c.hpp"
+
+static auto asBytes(std::string_view str)
+{
+    return std::as_bytes(std::span(str.data(), str.size()));
+}
+
+TEST_CASE("CRC32C matches known values", "[util]")
+{
+    REQUIRE(util::crc32c({}) == 0);
+    REQUIRE(util::crc32c(asBytes("123456789")) == 0xE3069283);
+    REQUIRE(util::crc32cPortable(asBytes("123456789")) == 0xE3069283);
+
+    // A checksum can be built up over several spans
+    REQUIRE(util::crc32c(asBytes("56789"), util::crc32c(asBytes("1234"))) == 0xE3069283);
+}
+
+TEST_CASE("CRC32C hardware and portable implementations agree", "[util]")
+{
+    std::vector<std::byte> data(1500);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::byte(i * i - 123 * i); // pseudo-random data
+    }
+
+    // Cover every combination of alignment and tail length
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t length = 0; length < 64; ++length) {
+            const auto span = std::span(data).subspan(offset, length);
+            REQUIRE(util::crc32c(span) == util::crc32cPortable(span));
+        }
+    }
+    REQUIRE(util::crc32c(data) == util::crc32cPortable(data));
+
+    // Any single bit flip changes the checksum
+    const auto crc = util::crc32c(data);
+    data[700] ^= std::byte{0x10};
+    REQUIRE(util::crc32c(data) != crc);
+}
@@ -4,7 +4,9 @@
 #include <cstddef>
 #include <future>
 #include <mutex>
+#include <optional>
 #include <random>
+#include <thread>
 
 #include "util/endpoint.hpp"
 #include "util/logging.hpp"
@@ -310,3 +312,24 @@ TEST_CASE("Endpoint UDP send-receive", "[util]")
     endpoint_udp_connection_test();
     // To do: add test for overload of UDP sendTo
 }
+
+TEST_CASE("Endpoint UDP kernel timestamps", "[util]")
+{
+    util::Endpoint server{serverHost, serverService, util::SocketType::UDP};
+    util::Endpoint client{clientHost, clientService, util::SocketType::UDP};
+    REQUIRE(client.enableTimestamping());
+    REQUIRE(client.setRecvTimeout(1, 0));
+
+    const auto before = util::Socket::Timestamp::clock::now();
+    REQUIRE(server.sendTo(sendBuffer, clientHost, clientService) == sizeof_sendBuffer);
+
+    // The datagram is timestamped when the kernel receives it, between the send and the receive
+    std::array<std::byte, sizeof_sendBuffer> recvBuffer{};
+    std::optional<util::Socket::Timestamp> rxTime;
+    REQUIRE(client.recvFrom(recvBuffer, rxTime) == sizeof_sendBuffer);
+    const auto after = util::Socket::Timestamp::clock::now();
+    REQUIRE(recvBuffer == sendBuffer);
+    REQUIRE(rxTime.has_value());
+    REQUIRE(rxTime >= before);
+    REQUIRE(rxTime <= after);
+}
@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "util/executor.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+util::Task sleeper(util::Executor& executor, std::chrono::milliseconds duration, int id, std::vector<int>& order)
+{
+    co_await executor.sleepFor(duration);
+    order.push_back(id);
+}
+
+util::Task eventWaiter(util::Event& event, std::optional<util::Executor::TimePoint> deadline, bool& result)
+{
+    result = co_await event.wait(deadline);
+}
+
+util::Task eventSetter(util::Executor& executor, util::Event& event)
+{
+    co_await executor.sleepFor(5ms);
+    event.set();
+}
+
+util::Task fdWaiter(util::Executor& executor, int fd, std::optional<util::Executor::TimePoint> deadline, bool& result)
+{
+    result = co_await executor.readable(fd, deadline);
+}
+
+util::Task fdWriter(util::Executor& executor, int fd)
+{
+    co_await executor.sleepFor(5ms);
+    const uint64_t value = 1;
+    REQUIRE(::write(fd, &value, sizeof(value)) == sizeof(value));
+}
+
+util::Task thrower(util::Executor& executor)
+{
+    co_await executor.yield();
+    throw std::runtime_error("task failed");
+}
+
+} // namespace
+
+TEST_CASE("Executor resumes sleeping tasks in deadline order", "[util]")
+{
+    util::Executor executor;
+    std::vector<int> order;
+    executor.spawn(sleeper(executor, 30ms, 3, order));
+    executor.spawn(sleeper(executor, 10ms, 1, order));
+    executor.spawn(sleeper(executor, 20ms, 2, order));
+
+    const auto start = util::Executor::ClockType::now();
+    executor.run();
+    REQUIRE(util::Executor::ClockType::now() - start >= 30ms);
+    REQUIRE(order == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("Executor wakes tasks waiting on an event", "[util]")
+{
+    util::Executor executor;
+    util::Event event(executor);
+
+    SECTION("Event set by another task")
+    {
+        bool woken = false;
+        executor.spawn(eventWaiter(event, std::nullopt, woken));
+        executor.spawn(eventSetter(executor, event));
+        executor.run();
+        REQUIRE(woken);
+    }
+
+    SECTION("Event set before waiting")
+    {
+        bool woken = false;
+        event.set();
+        executor.spawn(eventWaiter(event, std::nullopt, woken));
+        executor.run();
+        REQUIRE(woken);
+    }
+
+    SECTION("Deadline passes first")
+    {
+        bool woken = true;
+        executor.spawn(eventWaiter(event, util::Executor::ClockType::now() + 5ms, woken));
+        executor.run();
+        REQUIRE_FALSE(woken);
+    }
+}
+
+TEST_CASE("Executor wakes tasks waiting on a file descriptor", "[util]")
+{
+    util::Executor executor;
+    const int fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    REQUIRE(fd != -1);
+
+    SECTION("File descriptor becomes readable")
+    {
+        bool readable = false;
+        executor.spawn(fdWaiter(executor, fd, util::Executor::ClockType::now() + 1s, readable));
+        executor.spawn(fdWriter(executor, fd));
+        executor.run();
+        REQUIRE(readable);
+    }
+
+    SECTION("Deadline passes first, then the file descriptor can be waited on again")
+    {
+        bool readable = true;
+        executor.spawn(fdWaiter(executor, fd, util::Executor::ClockType::now() + 5ms, readable));
+        executor.run();
+        REQUIRE_FALSE(readable);
+
+        executor.spawn(fdWaiter(executor, fd, std::nullopt, readable));
+        executor.spawn(fdWriter(executor, fd));
+        executor.run();
+        REQUIRE(readable);
+    }
+
+    ::close(fd);
+}
+
+TEST_CASE("Executor rethrows exceptions escaping a task", "[util]")
+{
+    util::Executor executor;
+    std::vector<int> order;
+    executor.spawn(thrower(executor));
+    executor.spawn(sleeper(executor, 5ms, 1, order));
+    REQUIRE_THROWS_AS(executor.run(), std::runtime_error);
+    REQUIRE(order == std::vector<int>{1});
+}
+
+TEST_CASE("ExecutorPool runs tasks across several threads", "[util]")
+{
+    util::ExecutorPool pool(3);
+    std::vector<std::vector<int>> orders(6);
+    for (int i = 0; i < 6; ++i) {
+        auto& executor = pool.next();
+        executor.spawn(sleeper(executor, 5ms, i, orders[i]));
+    }
+    pool.run();
+    for (int i = 0; i < 6; ++i) {
+        REQUIRE(orders[i] == std::vector<int>{i});
+    }
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "util/histogram.hpp"
+
+TEST_CASE("LatencyHistogram bucket bounds", "[util]")
+{
+    // Small values are recorded exactly
+    for (uint64_t value = 0; value < util::LatencyHistogram::subBucketCount; ++value) {
+        const auto index = util::LatencyHistogram::bucketIndex(value);
+        REQUIRE(util::LatencyHistogram::bucketLowerBound(index) == value);
+        REQUIRE(util::LatencyHistogram::bucketUpperBound(index) == value);
+    }
+
+    // Larger values fall within their bucket, and buckets are contiguous
+    for (size_t index = util::LatencyHistogram::subBucketCount; index < util::LatencyHistogram::bucketCount; ++index) {
+        const auto lower = util::LatencyHistogram::bucketLowerBound(index);
+        const auto upper = util::LatencyHistogram::bucketUpperBound(index);
+        REQUIRE(util::LatencyHistogram::bucketIndex(lower) == index);
+        REQUIRE(util::LatencyHistogram::bucketIndex(upper) == index);
+        REQUIRE(util::LatencyHistogram::bucketUpperBound(index - 1) + 1 == lower);
+
+        // Relative error is bounded by the sub-bucket resolution
+        REQUIRE((upper - lower) / static_cast<double>(lower) <= 1.0 / util::LatencyHistogram::subBucketHalfCount);
+    }
+
+    REQUIRE(util::LatencyHistogram::bucketIndex(std::numeric_limits<uint64_t>::max()) ==
+            util::LatencyHistogram::bucketCount - 1);
+}
+
+TEST_CASE("LatencyHistogram percentiles", "[util]")
+{
+    util::LatencyHistogram histogram;
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.valueAtPercentile(50.0) == 0);
+
+    // Record 1 to 10000 us in ns
+    constexpr uint64_t num_values = 10000;
+    for (uint64_t i = 1; i <= num_values; ++i) {
+        histogram.record(i * 1000);
+    }
+
+    REQUIRE(histogram.count() == num_values);
+    REQUIRE(histogram.min() == 1000);
+    REQUIRE(histogram.max() == num_values * 1000);
+    REQUIRE(histogram.mean() == (num_values + 1) * 1000 / 2.0);
+
+    // Percentiles are accurate to within the histogram's resolution
+    auto check_percentile = [&histogram](const double percentile, const uint64_t expected) {
+        const auto value = histogram.valueAtPercentile(percentile);
+        REQUIRE(value >= expected);
+        REQUIRE(value - expected <= expected / util::LatencyHistogram::subBucketHalfCount);
+    };
+    check_percentile(50.0, 5000 * 1000);
+    check_percentile(99.0, 9900 * 1000);
+    check_percentile(99.99, 9999 * 1000);
+    REQUIRE(histogram.valueAtPercentile(100.0) == histogram.max());
+    check_percentile(0.0, histogram.min());
+
+    histogram.reset();
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.max() == 0);
+}
+
+TEST_CASE("LatencyHistogram merge and CSV output", "[util]")
+{
+    util::LatencyHistogram first, second;
+    std::mt19937 mt(0);
+    std::uniform_int_distribution<uint64_t> dist(0, 1'000'000'000);
+
+    std::vector<uint64_t> values(1000);
+    for (auto& value : values) {
+        value = dist(mt);
+        first.record(value);
+    }
+    second.record(5);
+    second.record(2'000'000'000);
+
+    auto merged = first;
+    merged.merge(second);
+    REQUIRE(merged.count() == first.count() + second.count());
+    REQUIRE(merged.min() == std::min(first.min(), uint64_t{5}));
+    REQUIRE(merged.max() == 2'000'000'000);
+    REQUIRE(first.count() == values.size()); // Copy should not alias the original
+
+    std::stringstream csv;
+    merged.writeCsv(csv);
+
+    std::string line;
+    std::getline(csv, line);
+    REQUIRE(line == "lower,upper,count,percentile");
+
+    uint64_t total = 0;
+    std::string last_line;
+    while (std::getline(csv, line)) {
+        last_line = line;
+        uint64_t lower, upper, count;
+        char comma;
+        std::stringstream row(line);
+        row >> lower >> comma >> upper >> comma >> count;
+        REQUIRE(lower <= upper);
+        total += count;
+    }
+    REQUIRE(total == merged.count());
+    REQUIRE(last_line.ends_with(",100.000000"));
+}
@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/logging.hpp"
+
+constexpr size_t queue_capacity = 64;
+
+TEST_CASE("AsyncLogQueue formats deferred messages", "[util]")
+{
+    util::AsyncLogQueue queue{queue_capacity};
+
+    // String arguments must be copied, as the caller's buffer may change before the message is formatted
+    std::string temp = "first";
+    REQUIRE(queue.tryPush(util::LOGGING_LEVEL_INFO, std::nullopt, "{} {} {}", 1, temp, "literal"));
+    temp = "second";
+    REQUIRE(queue.tryPush(util::LOGGING_LEVEL_DEBUG, std::nullopt, "{:>4}|{}", 42, std::string_view{temp}));
+
+    std::vector<std::pair<util::LoggingLevel, std::string>> messages;
+    auto count = queue.drain([&messages](auto level, auto, std::string_view message) {
+        messages.emplace_back(level, std::string{message});
+    });
+
+    REQUIRE(count == 2);
+    REQUIRE(messages[0] == std::make_pair(util::LOGGING_LEVEL_INFO, std::string{"1 first literal"}));
+    REQUIRE(messages[1] == std::make_pair(util::LOGGING_LEVEL_DEBUG, std::string{"  42|second"}));
+
+    // Queue should now be empty
+    REQUIRE(queue.drain([](auto, auto, auto) {}) == 0);
+    REQUIRE(queue.dropped() == 0);
+}
+
+TEST_CASE("AsyncLogQueue drops messages when full", "[util]")
+{
+    util::AsyncLogQueue queue{queue_capacity};
+
+    for (size_t i = 0; i < queue_capacity; ++i) {
+        REQUIRE(queue.tryPush(util::LOGGING_LEVEL_INFO, std::nullopt, "message {}", i));
+    }
+    REQUIRE_FALSE(queue.tryPush(util::LOGGING_LEVEL_INFO, std::nullopt, "message {}", queue_capacity));
+    REQUIRE(queue.dropped() == 1);
+
+    // Messages are delivered in order, and space is freed once drained
+    size_t expected = 0;
+    REQUIRE(queue.drain([&expected](auto, auto, std::string_view message) {
+        REQUIRE(message == std::format("message {}", expected++));
+    }) == queue_capacity);
+    REQUIRE(queue.tryPush(util::LOGGING_LEVEL_INFO, std::nullopt, "message {}", 0));
+}
+
+TEST_CASE("AsyncLogQueue with multiple producers", "[util]")
+{
+    constexpr size_t num_threads = 4;
+    constexpr size_t messages_per_thread = 10000;
+    util::AsyncLogQueue queue{queue_capacity};
+
+    std::atomic<bool> producers_done = false;
+    size_t received = 0;
+    auto consumer = std::thread([&]() {
+        while (!producers_done) {
+            received += queue.drain([](auto, auto, auto) {});
+        }
+        received += queue.drain([](auto, auto, auto) {});
+    });
+
+    std::array<std::thread, num_threads> producers;
+    for (size_t thread_idx = 0; thread_idx < producers.size(); ++thread_idx) {
+        producers[thread_idx] = std::thread([&queue, thread_idx]() {
+            for (size_t i = 0; i < messages_per_thread; ++i) {
+                queue.tryPush(util::LOGGING_LEVEL_INFO, std::nullopt, "thread {} message {}", thread_idx, i);
+            }
+        });
+    }
+
+    for (auto& th : producers) {
+        th.join();
+    }
+    producers_done = true;
+    consumer.join();
+
+    // Every message is either delivered or counted as dropped
+    REQUIRE(received + queue.dropped() == num_threads * messages_per_thread);
+}
+
+TEST_CASE("AsyncLogQueue stops draining at a marker", "[util]")
+{
+    util::AsyncLogQueue queue{queue_capacity};
+    std::atomic<bool> open = true;
+
+    REQUIRE(queue.tryPushIfOpen(open, util::LOGGING_LEVEL_INFO, std::nullopt, "before marker") ==
+            util::AsyncLogQueue::PushResult::QUEUED);
+    open = false;
+    REQUIRE(queue.tryPushMarker());
+
+    // Once closed, the message is left with the caller and its entry is skipped
+    REQUIRE(queue.tryPushIfOpen(open, util::LOGGING_LEVEL_INFO, std::nullopt, "after marker") ==
+            util::AsyncLogQueue::PushResult::CLOSED);
+    REQUIRE(queue.tryPush(util::LOGGING_LEVEL_INFO, std::nullopt, "queued after marker"));
+
+    std::vector<std::string> messages;
+    auto consume = [&messages](auto, auto, std::string_view message) { messages.emplace_back(message); };
+    bool markerReached = false;
+    REQUIRE(queue.drain(consume, &markerReached) == 1);
+    REQUIRE(markerReached);
+    REQUIRE(messages == std::vector<std::string>{"before marker"});
+
+    markerReached = false;
+    REQUIRE(queue.drain(consume, &markerReached) == 1);
+    REQUIRE_FALSE(markerReached);
+    REQUIRE(messages.back() == "queued after marker");
+}
+
+TEST_CASE("Logger async mode", "[util]")
+{
+    // Capture the output, so that it can be checked once async logging is disabled
+    auto* output = std::tmpfile();
+    REQUIRE(output != nullptr);
+    util::Logger::setOutput(output);
+    util::Logger::setLoggingLevel(util::LOGGING_LEVEL_DEBUG);
+    const auto droppedBefore = util::Logger::droppedMessages();
+    util::Logger::enableAsync();
+
+    constexpr size_t num_messages = 100;
+    for (size_t i = 0; i < num_messages; ++i) {
+        util::Logger::logMessage(util::LOGGING_LEVEL_DEBUG, "async log message {}", i);
+    }
+
+    util::Logger::disableAsync();
+    util::Logger::logMessage(util::LOGGING_LEVEL_DEBUG, "sync log message");
+    util::Logger::setOutput(stdout);
+
+    std::vector<std::string> lines;
+    std::rewind(output);
+    std::array<char, 256> line;
+    while (std::fgets(line.data(), line.size(), output) != nullptr) {
+        lines.emplace_back(line.data());
+    }
+    std::fclose(output);
+
+    // Every queued message is printed in order, before any message logged after async mode is disabled
+    REQUIRE(util::Logger::droppedMessages() == droppedBefore);
+    REQUIRE(lines.size() == num_messages + 1);
+    for (size_t i = 0; i < num_messages; ++i) {
+        REQUIRE(lines[i].ends_with(std::format("async log message {}\n", i)));
+    }
+    REQUIRE(lines.back().ends_with("sync log message\n"));
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "util/metrics.hpp"
+
+TEST_CASE("MetricsRegistry returns the same metric for the same name and labels", "[util]")
+{
+    util::MetricsRegistry registry;
+
+    auto& first = registry.counter("test_total", "a test counter", {{"conversation", "1"}});
+    auto& second = registry.counter("test_total", "a test counter", {{"conversation", "2"}});
+    REQUIRE(&first != &second);
+    REQUIRE(&registry.counter("test_total", "a test counter", {{"conversation", "1"}}) == &first);
+
+    // Names cannot be reused with a different type
+    REQUIRE_THROWS_AS(registry.gauge("test_total", "a test gauge", {{"conversation", "1"}}), util::MetricsException);
+
+    first.increment();
+    first.increment(2);
+    auto& gauge = registry.gauge("test_depth", "a test gauge");
+    gauge.set(5);
+    gauge.add(-7);
+
+    auto samples = registry.snapshot();
+    REQUIRE(samples.size() == 3);
+    REQUIRE(samples[0].name == "test_depth");
+    REQUIRE(samples[0].type == util::MetricType::GAUGE);
+    REQUIRE(samples[0].value == -2);
+    REQUIRE(samples[1].name == "test_total");
+    REQUIRE(samples[1].type == util::MetricType::COUNTER);
+    REQUIRE(samples[1].value == 3);
+    REQUIRE(samples[2].value == 0);
+}
+
+TEST_CASE("Metrics snapshot formats", "[util]")
+{
+    util::MetricsRegistry registry;
+    registry.counter("arq_packets_sent_total", "Packets sent", {{"conversation", "1"}}).increment(10);
+    registry.counter("arq_packets_sent_total", "Packets sent", {{"conversation", "2"}}).increment(20);
+    registry.gauge("arq_depth", "Queue \"depth\"").set(3);
+
+    const auto samples = registry.snapshot();
+
+    REQUIRE(util::toPrometheus(samples) == "# HELP arq_depth Queue \"depth\"\n"
+                                           "# TYPE arq_depth gauge\n"
+                                           "arq_depth 3\n"
+                                           "# HELP arq_packets_sent_total Packets sent\n"
+                                           "# TYPE arq_packets_sent_total counter\n"
+                                           "arq_packets_sent_total{conversation=\"1\"} 10\n"
+                                           "arq_packets_sent_total{conversation=\"2\"} 20\n");
+
+    REQUIRE(util::toJson(samples) ==
+            "{\"metrics\": ["
+            "{\"name\": \"arq_depth\", \"type\": \"gauge\", \"help\": \"Queue \\\"depth\\\"\", "
+            "\"labels\": {}, \"value\": 3}, "
+            "{\"name\": \"arq_packets_sent_total\", \"type\": \"counter\", \"help\": \"Packets sent\", "
+            "\"labels\": {\"conversation\": \"1\"}, \"value\": 10}, "
+            "{\"name\": \"arq_packets_sent_total\", \"type\": \"counter\", \"help\": \"Packets sent\", "
+            "\"labels\": {\"conversation\": \"2\"}, \"value\": 20}]}\n");
+}
+
+TEST_CASE("MetricsExporter writes to a file", "[util]")
+{
+    util::MetricsRegistry registry;
+    auto& counter = registry.counter("exported_total", "an exported counter");
+    const auto path = (std::filesystem::temp_directory_path() / "arq_metrics_test.prom").string();
+
+    {
+        util::MetricsExporter exporter(
+            registry, util::MetricsExporter::Destination::FILE, path, util::MetricsFormat::PROMETHEUS);
+        counter.increment(42);
+    }
+
+    // The final values are written when the exporter is destroyed
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    REQUIRE(contents.str().ends_with("exported_total 42\n"));
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("MetricsExporter serves a UNIX socket", "[util]")
+{
+    util::MetricsRegistry registry;
+    registry.gauge("served", "a served gauge").set(7);
+    const auto path = (std::filesystem::temp_directory_path() / "arq_metrics_test.sock").string();
+
+    util::MetricsExporter exporter(
+        registry, util::MetricsExporter::Destination::UNIX_SOCKET, path, util::MetricsFormat::JSON);
+
+    const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(fd != -1);
+    sockaddr_un addr{.sun_family = AF_UNIX};
+    std::ranges::copy(path, addr.sun_path);
+    REQUIRE(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+
+    std::string received;
+    std::array<char, 256> buffer;
+    for (ssize_t ret; (ret = ::read(fd, buffer.data(), buffer.size())) > 0;) {
+        received.append(buffer.data(), ret);
+    }
+    ::close(fd);
+
+    REQUIRE(received == util::toJson(registry.snapshot()));
+}
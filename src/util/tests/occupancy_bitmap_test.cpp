@@ -0,0 +1,65 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "util/occupancy_bitmap.hpp"
+
+TEST_CASE("OccupancyBitmap tracks set and reset slots", "[util]")
+{
+    util::OccupancyBitmap bitmap(100);
+    REQUIRE(bitmap.size() == 100);
+    REQUIRE(bitmap.count() == 0);
+
+    bitmap.set(3);
+    bitmap.set(64);
+    bitmap.set(64);
+    REQUIRE(bitmap.count() == 2);
+    REQUIRE(bitmap.test(3));
+    REQUIRE(bitmap.test(64));
+    REQUIRE_FALSE(bitmap.test(4));
+
+    bitmap.reset(3);
+    bitmap.reset(3);
+    REQUIRE(bitmap.count() == 1);
+    REQUIRE_FALSE(bitmap.test(3));
+
+    bitmap.clear();
+    REQUIRE(bitmap.count() == 0);
+    REQUIRE_FALSE(bitmap.findNextSet(0).has_value());
+}
+
+TEST_CASE("OccupancyBitmap searches wrap around the end of the window", "[util]")
+{
+    util::OccupancyBitmap bitmap(130);
+
+    bitmap.set(5);
+    bitmap.set(129);
+    REQUIRE(bitmap.findNextSet(0) == 5);
+    REQUIRE(bitmap.findNextSet(5) == 5);
+    REQUIRE(bitmap.findNextSet(6) == 129);
+    REQUIRE(bitmap.findNextSet(129) == 129);
+    bitmap.reset(129);
+    REQUIRE(bitmap.findNextSet(6) == 5);
+
+    // Fill every slot except one in the first word
+    for (size_t i = 0; i < bitmap.size(); ++i) {
+        bitmap.set(i);
+    }
+    REQUIRE_FALSE(bitmap.findNextClear(0).has_value());
+    bitmap.reset(10);
+    REQUIRE(bitmap.findNextClear(0) == 10);
+    REQUIRE(bitmap.findNextClear(11) == 10);
+    REQUIRE(bitmap.findNextClear(128) == 10);
+}
+
+TEST_CASE("OccupancyBitmap never reports slots beyond its size as free", "[util]")
+{
+    util::OccupancyBitmap bitmap(70);
+    for (size_t i = 0; i < bitmap.size(); ++i) {
+        bitmap.set(i);
+    }
+    bitmap.reset(0);
+    REQUIRE(bitmap.findNextClear(65) == 0);
+
+    bitmap.set(0);
+    REQUIRE(bitmap.count() == bitmap.size());
+    REQUIRE_FALSE(bitmap.findNextClear(65).has_value());
+}
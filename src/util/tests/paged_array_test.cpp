@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <optional>
+
+#include "util/paged_array.hpp"
+
+TEST_CASE("PagedArray allocates pages on demand", "[util]")
+{
+    util::PagedArray<std::optional<int>> array(256, 64);
+    REQUIRE(array.size() == 256);
+    REQUIRE(array.allocatedPages() == 0);
+    const auto emptyUsage = array.memoryUsage();
+
+    // Newly allocated pages hold default-initialised elements
+    array.allocate(70) = 70;
+    REQUIRE(array.allocatedPages() == 1);
+    REQUIRE(array.isAllocated(64));
+    REQUIRE_FALSE(array.isAllocated(0));
+    REQUIRE_FALSE(array[64].has_value());
+    REQUIRE(array[70] == 70);
+
+    // Allocating within an existing page does not allocate another
+    array.allocate(127) = 127;
+    REQUIRE(array.allocatedPages() == 1);
+    REQUIRE(array.memoryUsage() == emptyUsage + 64 * sizeof(std::optional<int>));
+
+    array.allocate(200) = 200;
+    REQUIRE(array.allocatedPages() == 2);
+}
+
+TEST_CASE("PagedArray releases pages", "[util]")
+{
+    util::PagedArray<std::optional<int>> array(256, 64, 1);
+    const auto emptyUsage = array.memoryUsage();
+
+    for (size_t i = 0; i < array.size(); i += 64) {
+        array.allocate(i);
+    }
+    REQUIRE(array.allocatedPages() == 4);
+
+    // One released page is kept for reuse, the rest are freed
+    for (size_t i = 0; i < array.size(); i += 64) {
+        array.releasePage(i);
+    }
+    REQUIRE(array.allocatedPages() == 0);
+    REQUIRE(array.memoryUsage() == emptyUsage + 64 * sizeof(std::optional<int>));
+
+    // Releasing an unallocated page has no effect
+    array.releasePage(0);
+    REQUIRE(array.allocatedPages() == 0);
+
+    // The spare page is reused
+    array.allocate(128);
+    REQUIRE(array.allocatedPages() == 1);
+    REQUIRE(array.memoryUsage() == emptyUsage + 64 * sizeof(std::optional<int>));
+}
+
+TEST_CASE("PagedArray keeps prefaulted pages", "[util]")
+{
+    util::PagedArray<int> array(256, 64, 1);
+    const auto emptyUsage = array.memoryUsage();
+    const auto fullUsage = emptyUsage + 256 * sizeof(int);
+
+    array.allocate(0) = 1;
+    array.prefault();
+    REQUIRE(array.allocatedPages() == 1);
+    REQUIRE(array.memoryUsage() == fullUsage);
+
+    // Pages are taken from the prefaulted spares and never freed
+    for (size_t i = 0; i < array.size(); i += 64) {
+        array.allocate(i);
+    }
+    REQUIRE(array.allocatedPages() == 4);
+    for (size_t i = 0; i < array.size(); i += 64) {
+        array.releasePage(i);
+    }
+    REQUIRE(array.allocatedPages() == 0);
+    REQUIRE(array.memoryUsage() == fullUsage);
+}
+
+TEST_CASE("PagedArray supports page sizes which are not powers of two", "[util]")
+{
+    util::PagedArray<int> array(300, 100);
+    REQUIRE(array.pageSize() == 100);
+
+    array.allocate(99) = 99;
+    array.allocate(100) = 100;
+    REQUIRE(array.allocatedPages() == 2);
+    REQUIRE(array.isAllocated(0));
+    REQUIRE(array.isAllocated(199));
+    REQUIRE_FALSE(array.isAllocated(200));
+    REQUIRE(array[99] == 99);
+    REQUIRE(array[100] == 100);
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <pthread.h>
+#include <sched.h>
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/thread_placement.hpp"
+
+TEST_CASE("CPU lists are parsed", "[util]")
+{
+    REQUIRE(util::parseCpuList("3") == std::vector<int>{3});
+    REQUIRE(util::parseCpuList("0,2,4-6") == std::vector<int>{0, 2, 4, 5, 6});
+    REQUIRE(util::parseCpuList("7-7,1") == std::vector<int>{7, 1});
+
+    REQUIRE_THROWS_AS(util::parseCpuList(""), util::ThreadPlacementException);
+    REQUIRE_THROWS_AS(util::parseCpuList("1,,2"), util::ThreadPlacementException);
+    REQUIRE_THROWS_AS(util::parseCpuList("a"), util::ThreadPlacementException);
+    REQUIRE_THROWS_AS(util::parseCpuList("-1"), util::ThreadPlacementException);
+    REQUIRE_THROWS_AS(util::parseCpuList("5-2"), util::ThreadPlacementException);
+    REQUIRE_THROWS_AS(util::parseCpuList("1-"), util::ThreadPlacementException);
+}
+
+// Returns the first CPU the test may run on, since CPU 0 may be excluded by a cpuset or taskset
+static int first_allowed_cpu()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    REQUIRE(::sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            return cpu;
+        }
+    }
+    FAIL("no CPU in the affinity mask");
+    return -1;
+}
+
+TEST_CASE("Placement pins and names the calling thread", "[util]")
+{
+    const int targetCpu = first_allowed_cpu();
+    const util::PlacementPolicy policy{.cpus_ = {targetCpu}, .fifoPriority_ = std::nullopt};
+
+    int cpu = -1;
+    std::string name;
+    std::thread thread{[&]() {
+        // The second thread of the component wraps around to the first CPU
+        util::applyPlacement(policy, 1, "placement-test-thread");
+        cpu = ::sched_getcpu();
+        std::array<char, 16> nameBuffer{};
+        ::pthread_getname_np(::pthread_self(), nameBuffer.data(), nameBuffer.size());
+        name = nameBuffer.data();
+    }};
+    thread.join();
+
+    REQUIRE(cpu == targetCpu);
+    REQUIRE(name == "placement-test-");
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "util/logging.hpp"
+#include "util/trace.hpp"
+
+constexpr size_t records_per_thread = 1000;
+constexpr size_t num_threads = 4;
+
+static auto get_trace_path()
+{
+    return (std::filesystem::temp_directory_path() / "arq_trace_test.trace").string();
+}
+
+// Reads a trace file, checking the header and returning the records it contains
+static std::vector<util::TraceRecord> read_trace_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    REQUIRE(file.is_open());
+
+    util::TraceFileHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    REQUIRE(file.gcount() == sizeof(header));
+    REQUIRE(header.magic_ == util::TRACE_FILE_MAGIC);
+    REQUIRE(header.version_ == util::TRACE_FILE_VERSION);
+    REQUIRE(header.recordSize_ == sizeof(util::TraceRecord));
+
+    std::vector<util::TraceRecord> records;
+    util::TraceRecord record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        records.push_back(record);
+    }
+    return records;
+}
+
+TEST_CASE("Tracer disabled", "[util]")
+{
+    REQUIRE_FALSE(util::Tracer::isEnabled());
+
+    // Tracing when disabled should have no effect
+    util::trace(util::TraceEvent::PACKET_TX, 1, 1);
+    REQUIRE(util::Tracer::droppedRecords() == 0);
+}
+
+TEST_CASE("Tracer records events from multiple threads", "[util]")
+{
+    util::Logger::setLoggingLevel(util::LOGGING_LEVEL_DEBUG);
+    const auto path = get_trace_path();
+
+    util::Tracer::start(path);
+    REQUIRE(util::Tracer::isEnabled());
+
+    // Tracing cannot be started twice
+    REQUIRE_THROWS_AS(util::Tracer::start(path), util::TraceException);
+
+    std::array<std::thread, num_threads> threads;
+    for (size_t thread_idx = 0; thread_idx < threads.size(); ++thread_idx) {
+        threads[thread_idx] = std::thread([thread_idx]() {
+            for (uint16_t sn = 0; sn < records_per_thread; ++sn) {
+                util::trace(util::TraceEvent::INPUT_BUFFER_ADD, static_cast<uint8_t>(thread_idx), sn);
+                // Give the flush thread an opportunity to keep up
+                if (sn % (util::TraceRing::capacity / 2) == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+        });
+    }
+
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    util::Tracer::stop();
+    REQUIRE_FALSE(util::Tracer::isEnabled());
+
+    auto records = read_trace_file(path);
+    REQUIRE(records.size() + util::Tracer::droppedRecords() == records_per_thread * num_threads);
+
+    // Records from each thread should be in order
+    std::array<std::optional<uint16_t>, num_threads> last_sn{};
+    std::array<uint64_t, num_threads> last_time{};
+    for (const auto& record : records) {
+        REQUIRE(record.event_ == util::TraceEvent::INPUT_BUFFER_ADD);
+        REQUIRE(record.conversationID_ < num_threads);
+
+        auto& last = last_sn[record.conversationID_];
+        if (last.has_value()) {
+            REQUIRE(record.sequenceNumber_ > last.value());
+            REQUIRE(record.timestampNs_ >= last_time[record.conversationID_]);
+        }
+        last = record.sequenceNumber_;
+        last_time[record.conversationID_] = record.timestampNs_;
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Tracer records explicit timestamps", "[util]")
+{
+    const auto path = get_trace_path();
+    const auto time = util::Tracer::TraceClock::now();
+
+    util::Tracer::start(path);
+    util::trace(util::TraceEvent::OUTPUT_BUFFER_PUSH, 7, 42, time);
+    util::Tracer::stop();
+
+    auto records = read_trace_file(path);
+    REQUIRE(records.size() == 1);
+    REQUIRE(records[0].event_ == util::TraceEvent::OUTPUT_BUFFER_PUSH);
+    REQUIRE(records[0].conversationID_ == 7);
+    REQUIRE(records[0].sequenceNumber_ == 42);
+    REQUIRE(records[0].timestampNs_ ==
+            static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count()));
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,157 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "util/workload.hpp"
+
+using namespace std::chrono_literals;
+
+// Returns every event the generator produces
+static std::vector<util::WorkloadEvent> generate_all(util::WorkloadGenerator& generator)
+{
+    std::vector<util::WorkloadEvent> events;
+    while (auto event = generator.next()) {
+        events.push_back(event.value());
+    }
+    return events;
+}
+
+TEST_CASE("WorkloadGenerator spaces constant-rate messages evenly", "[util]")
+{
+    util::WorkloadGenerator generator{
+        {.arrivals_ = util::ArrivalPattern::CONSTANT, .rate_ = 1000.0, .meanSize_ = 100, .count_ = 5}};
+    const auto events = generate_all(generator);
+    REQUIRE(events.size() == 5);
+    REQUIRE(generator.generated() == 5);
+    for (size_t i = 0; i < events.size(); ++i) {
+        REQUIRE(events[i].sendTime_ == i * 1ms);
+        REQUIRE(events[i].size_ == 100);
+    }
+}
+
+TEST_CASE("WorkloadGenerator stops at the end of the duration", "[util]")
+{
+    util::WorkloadGenerator generator{{.arrivals_ = util::ArrivalPattern::CONSTANT,
+                                       .rate_ = 1000.0,
+                                       .meanSize_ = 100,
+                                       .count_ = UINT64_MAX,
+                                       .duration_ = 5ms}};
+    const auto events = generate_all(generator);
+    REQUIRE(events.size() == 5);
+    REQUIRE(events.back().sendTime_ == 4ms);
+    REQUIRE(generator.count() == 5);
+}
+
+TEST_CASE("WorkloadGenerator Poisson arrivals average the rate", "[util]")
+{
+    constexpr uint64_t count = 100000;
+    util::WorkloadGenerator generator{{.arrivals_ = util::ArrivalPattern::POISSON,
+                                       .rate_ = 10000.0,
+                                       .sizes_ = util::SizeDistribution::EXPONENTIAL,
+                                       .meanSize_ = 200,
+                                       .maxSize_ = 1000,
+                                       .count_ = count,
+                                       .seed_ = 1}};
+    const auto events = generate_all(generator);
+    REQUIRE(events.size() == count);
+
+    // 100000 messages at 10000/s take about 10 s
+    REQUIRE(events.back().sendTime_ > 9.8s);
+    REQUIRE(events.back().sendTime_ < 10.2s);
+    REQUIRE(std::ranges::is_sorted(events, {}, &util::WorkloadEvent::sendTime_));
+    REQUIRE(std::ranges::all_of(events, [](const auto& event) { return event.size_ >= 1 && event.size_ <= 1000; }));
+}
+
+TEST_CASE("WorkloadGenerator on/off arrivals only fall in on periods", "[util]")
+{
+    util::WorkloadGenerator generator{{.arrivals_ = util::ArrivalPattern::ON_OFF,
+                                       .rate_ = 1000.0,
+                                       .onTime_ = 3ms,
+                                       .offTime_ = 7ms,
+                                       .meanSize_ = 10,
+                                       .count_ = 9}};
+    const auto events = generate_all(generator);
+    const std::vector<std::chrono::nanoseconds> expected{0ms, 1ms, 2ms, 10ms, 11ms, 12ms, 20ms, 21ms, 22ms};
+    REQUIRE(events.size() == expected.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        REQUIRE(events[i].sendTime_ == expected[i]);
+    }
+}
+
+TEST_CASE("WorkloadGenerator saturating messages are all due at once", "[util]")
+{
+    util::WorkloadGenerator generator{{.arrivals_ = util::ArrivalPattern::SATURATE,
+                                       .sizes_ = util::SizeDistribution::UNIFORM,
+                                       .meanSize_ = 50,
+                                       .count_ = 1000}};
+    const auto events = generate_all(generator);
+    REQUIRE(events.size() == 1000);
+    REQUIRE(std::ranges::all_of(events, [](const auto& event) {
+        return event.sendTime_ == 0ns && event.size_ >= 1 && event.size_ <= 99;
+    }));
+}
+
+TEST_CASE("WorkloadGenerator replays traces", "[util]")
+{
+    const auto path = (std::filesystem::temp_directory_path() / "arq_workload_test.txt").string();
+    {
+        std::ofstream trace{path};
+        trace << "# gap_us size\n0 100\n\n2.5 2000\n10 1\n";
+    }
+
+    // The whole trace is replayed once by default, with sizes clamped to the maximum
+    util::WorkloadGenerator once{
+        {.arrivals_ = util::ArrivalPattern::TRACE, .maxSize_ = 1500, .traceFile_ = path}};
+    const auto events = generate_all(once);
+    REQUIRE(once.count() == 3);
+    REQUIRE(events.size() == 3);
+    REQUIRE(events[1].sendTime_ == 2500ns);
+    REQUIRE(events[1].size_ == 1500);
+    REQUIRE(events[2].sendTime_ == 12500ns);
+
+    // A longer workload loops over the trace
+    util::WorkloadGenerator looped{{.arrivals_ = util::ArrivalPattern::TRACE, .count_ = 5, .traceFile_ = path}};
+    const auto loopedEvents = generate_all(looped);
+    REQUIRE(loopedEvents.size() == 5);
+    REQUIRE(loopedEvents[4].sendTime_ == 15000ns);
+    REQUIRE(loopedEvents[4].size_ == 2000);
+
+    std::ofstream{path} << "1 100\nnot a number\n";
+    REQUIRE_THROWS_AS(util::WorkloadGenerator({.arrivals_ = util::ArrivalPattern::TRACE, .traceFile_ = path}),
+                      util::WorkloadException);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("WorkloadGenerator rejects invalid specs", "[util]")
+{
+    REQUIRE_THROWS_AS(util::WorkloadGenerator({.arrivals_ = util::ArrivalPattern::POISSON, .meanSize_ = 1}),
+                      util::WorkloadException);
+    REQUIRE_THROWS_AS(util::WorkloadGenerator({.arrivals_ = util::ArrivalPattern::ON_OFF, .rate_ = 1, .meanSize_ = 1}),
+                      util::WorkloadException);
+    REQUIRE_THROWS_AS(util::WorkloadGenerator({.arrivals_ = util::ArrivalPattern::SATURATE}), util::WorkloadException);
+}
+
+TEST_CASE("fillRandom fills every byte", "[util]")
+{
+    uint64_t state = 42;
+    std::vector<std::byte> buffer(1003);
+    util::fillRandom(buffer, state);
+
+    // The odd-sized tail is filled too, and successive fills differ
+    REQUIRE(std::ranges::count(std::span(buffer).last(3), std::byte{0}) < 3);
+    const auto first = buffer;
+    util::fillRandom(buffer, state);
+    REQUIRE(buffer != first);
+
+    // Roughly half of the bits are set
+    size_t bitsSet = 0;
+    for (const auto b : buffer) {
+        bitsSet += std::popcount(std::to_integer<uint8_t>(b));
+    }
+    REQUIRE(bitsSet > buffer.size() * 8 * 45 / 100);
+    REQUIRE(bitsSet < buffer.size() * 8 * 55 / 100);
+}
@@ -0,0 +1,97 @@
+#include "util/thread_placement.hpp"
+
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <ranges>
+
+#include "util/logging.hpp"
+
+namespace {
+
+// Linux limits thread names to 15 characters plus the terminator
+constexpr size_t maxThreadNameLength = 15;
+
+int parseCpu(std::string_view str)
+{
+    int cpu;
+    const auto [end, err] = std::from_chars(str.data(), str.data() + str.size(), cpu);
+    if (err != std::errc{} || end != str.data() + str.size() || cpu < 0 || cpu >= CPU_SETSIZE) {
+        throw util::ThreadPlacementException(std::format("invalid CPU \"{}\"", str));
+    }
+    return cpu;
+}
+
+} // namespace
+
+void util::applyPlacement(const PlacementPolicy& policy, const size_t threadIndex, std::string_view threadName) noexcept
+{
+    std::array<char, maxThreadNameLength + 1> name{};
+    std::ranges::copy(threadName.substr(0, maxThreadNameLength), name.begin());
+    if (const auto err = ::pthread_setname_np(::pthread_self(), name.data()); err != 0) {
+        util::logWarning("failed to name thread {} ({})", name.data(), std::strerror(err));
+    }
+
+    if (!policy.cpus_.empty()) {
+        const auto cpu = policy.cpus_[threadIndex % policy.cpus_.size()];
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET(cpu, &cpuSet);
+        if (const auto err = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet); err != 0) {
+            util::logWarning("failed to pin thread {} to CPU {} ({})", name.data(), cpu, std::strerror(err));
+        }
+        // Now that the thread runs on a known CPU, allocate its memory from that CPU's NUMA node, overriding any
+        // process-wide policy such as interleaving
+        else if (::syscall(SYS_set_mempolicy, MPOL_LOCAL, nullptr, 0) != 0) {
+            util::logWarning("failed to set local memory policy for thread {} ({})", name.data(), std::strerror(errno));
+        }
+        else {
+            util::logDebug("pinned thread {} to CPU {}", name.data(), cpu);
+        }
+    }
+
+    if (policy.fifoPriority_.has_value()) {
+        const sched_param param{.sched_priority = policy.fifoPriority_.value()};
+        if (const auto err = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param); err != 0) {
+            util::logWarning("failed to run thread {} under SCHED_FIFO with priority {} ({})",
+                             name.data(),
+                             param.sched_priority,
+                             std::strerror(err));
+        }
+    }
+}
+
+std::vector<int> util::parseCpuList(std::string_view cpuList)
+{
+    if (cpuList.empty()) {
+        throw ThreadPlacementException("empty CPU list");
+    }
+
+    std::vector<int> cpus;
+    for (const auto range : std::views::split(cpuList, ',')) {
+        const std::string_view rangeStr{range.begin(), range.end()};
+        const auto dash = rangeStr.find('-');
+        if (dash == std::string_view::npos) {
+            cpus.push_back(parseCpu(rangeStr));
+            continue;
+        }
+
+        const auto first = parseCpu(rangeStr.substr(0, dash));
+        const auto last = parseCpu(rangeStr.substr(dash + 1));
+        if (last < first) {
+            throw ThreadPlacementException(std::format("invalid CPU range \"{}\"", rangeStr));
+        }
+        for (auto cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
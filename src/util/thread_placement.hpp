@@ -0,0 +1,43 @@
+#ifndef _UTIL_THREAD_PLACEMENT_HPP_
+#define _UTIL_THREAD_PLACEMENT_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace util {
+
+struct ThreadPlacementException : public std::runtime_error {
+    explicit ThreadPlacementException(const std::string& what) : std::runtime_error(what){};
+};
+
+/*
+ * Where and how the threads of a component run. Each thread applies the policy to itself when it starts, before it
+ * allocates or touches any memory of its own, so that memory allocated by the thread is placed on the NUMA node local
+ * to the CPU it is pinned to.
+ */
+struct PlacementPolicy {
+    // CPUs to which a component's threads are pinned, in the order the threads are created. If there are fewer CPUs
+    // than threads, the list wraps around. If empty, threads may run on any CPU.
+    std::vector<int> cpus_;
+    // If set, threads are run under SCHED_FIFO with the given priority
+    std::optional<int> fifoPriority_;
+    // If set, the component's window storage is allocated and faulted in when its thread starts, rather than as the
+    // window fills
+    bool prefault_ = false;
+};
+
+// Applies the policy to the calling thread, which is the threadIndex'th thread of its component, and names the thread
+// (truncated to the 15 characters Linux allows). Failure to apply the policy is logged rather than thrown, since a
+// misplaced thread still functions correctly.
+void applyPlacement(const PlacementPolicy& policy, size_t threadIndex, std::string_view threadName) noexcept;
+
+// Parses a list of CPUs such as "0,2,4-7". Throws ThreadPlacementException if the list is malformed.
+std::vector<int> parseCpuList(std::string_view cpuList);
+
+} // namespace util
+
+#endif
@@ -0,0 +1,236 @@
+#include "util/trace.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <condition_variable>
+#include <cstring>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/logging.hpp"
+
+namespace {
+
+// Append-only trace file, written through a shared memory mapping that is grown as required.
+class TraceFile {
+public:
+    explicit TraceFile(const std::string& path) : fd_{::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)}
+    {
+        if (fd_ == -1) {
+            throw util::TraceException(std::format("failed to open trace file '{}' ({})", path, std::strerror(errno)));
+        }
+        resize(initialCapacity);
+
+        const util::TraceFileHeader header{.magic_ = util::TRACE_FILE_MAGIC,
+                                           .version_ = util::TRACE_FILE_VERSION,
+                                           .recordSize_ = sizeof(util::TraceRecord)};
+        std::memcpy(mapping_, &header, sizeof(header));
+        size_ = sizeof(header);
+    }
+
+    TraceFile(const TraceFile&) = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+
+    ~TraceFile()
+    {
+        if (mapping_ != nullptr) {
+            ::munmap(mapping_, capacity_);
+        }
+        // Trim the unused tail of the final mapping
+        if (::ftruncate(fd_, size_) == -1) {
+            util::logWarning("failed to truncate trace file ({})", std::strerror(errno));
+        }
+        ::close(fd_);
+    }
+
+    void append(const util::TraceRecord& record)
+    {
+        if (size_ + sizeof(record) > capacity_) {
+            resize(capacity_ * 2);
+        }
+        std::memcpy(static_cast<std::byte*>(mapping_) + size_, &record, sizeof(record));
+        size_ += sizeof(record);
+    }
+
+private:
+    static constexpr size_t initialCapacity = 1 << 20;
+
+    void resize(const size_t newCapacity)
+    {
+        if (mapping_ != nullptr) {
+            ::munmap(mapping_, capacity_);
+            mapping_ = nullptr;
+        }
+        if (::ftruncate(fd_, newCapacity) == -1) {
+            throw util::TraceException(std::format("failed to grow trace file ({})", std::strerror(errno)));
+        }
+        auto* mapping = ::mmap(nullptr, newCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            throw util::TraceException(std::format("failed to map trace file ({})", std::strerror(errno)));
+        }
+        mapping_ = mapping;
+        capacity_ = newCapacity;
+    }
+
+    int fd_;
+    void* mapping_ = nullptr;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+};
+
+// Interval at which the flush thread drains the trace rings
+constexpr auto flushInterval = std::chrono::milliseconds(1);
+
+// Every ring ever handed out. Rings are never freed, so thread-local pointers to them remain valid.
+std::mutex ringsMutex;
+std::vector<std::unique_ptr<util::TraceRing>> rings;
+
+// State of the current tracing session
+std::mutex sessionMutex;
+std::condition_variable flushCv;
+bool stopRequested = false;
+std::unique_ptr<TraceFile> traceFile;
+std::thread flushThread;
+uint64_t droppedAtStart = 0;
+
+// Releases the calling thread's ring for reuse when the thread exits
+struct RingReleaser {
+    util::TraceRing* ring_ = nullptr;
+
+    ~RingReleaser()
+    {
+        if (ring_ != nullptr) {
+            ring_->inUse_ = false;
+        }
+    }
+};
+
+thread_local RingReleaser ringReleaser;
+
+uint64_t totalDropped()
+{
+    std::scoped_lock lock(ringsMutex);
+    uint64_t dropped = 0;
+    for (const auto& ring : rings) {
+        dropped += ring->dropped();
+    }
+    return dropped;
+}
+
+// Drains every ring into the trace file, or discards the records if there is no trace file.
+void drainRings(TraceFile* file)
+{
+    std::scoped_lock lock(ringsMutex);
+    for (auto& ring : rings) {
+        ring->drain([file](const util::TraceRecord& record) {
+            if (file != nullptr) {
+                file->append(record);
+            }
+        });
+    }
+}
+
+void flushLoop()
+{
+    try {
+        std::unique_lock lock(sessionMutex);
+        while (!stopRequested) {
+            flushCv.wait_for(lock, flushInterval, [] { return stopRequested; });
+            drainRings(traceFile.get());
+        }
+    }
+    catch (const util::TraceException& e) {
+        util::logError("Tracing stopped: {}", e.what());
+        util::Tracer::stop();
+    }
+}
+
+} // namespace
+
+util::TraceRing* util::Tracer::registerThread() noexcept
+{
+    try {
+        std::scoped_lock lock(ringsMutex);
+
+        // Reuse a ring left behind by an exited thread if possible
+        TraceRing* ring = nullptr;
+        for (auto& candidate : rings) {
+            bool expected = false;
+            if (candidate->inUse_.compare_exchange_strong(expected, true)) {
+                ring = candidate.get();
+                break;
+            }
+        }
+
+        if (ring == nullptr) {
+            ring = rings.emplace_back(std::make_unique<TraceRing>()).get();
+        }
+
+        ringReleaser.ring_ = ring;
+        return ring;
+    }
+    catch (const std::exception& e) {
+        logError("Failed to register thread for tracing ({})", e.what());
+        return nullptr;
+    }
+}
+
+void util::Tracer::start(const std::string& path)
+{
+    if (flushThread.joinable()) {
+        throw TraceException("tracing has already been started");
+    }
+
+    {
+        std::scoped_lock lock(sessionMutex);
+        traceFile = std::make_unique<TraceFile>(path);
+        stopRequested = false;
+        // Discard any records left over from a previous session
+        drainRings(nullptr);
+    }
+
+    droppedAtStart = totalDropped();
+    flushThread = std::thread(flushLoop);
+    enabled_ = true;
+    logDebug("Tracing to file '{}'", path);
+}
+
+void util::Tracer::stop()
+{
+    enabled_ = false;
+
+    {
+        std::scoped_lock lock(sessionMutex);
+        stopRequested = true;
+    }
+    flushCv.notify_one();
+
+    // stop() may be called from the flush thread itself if writing fails
+    if (flushThread.joinable() && flushThread.get_id() != std::this_thread::get_id()) {
+        flushThread.join();
+    }
+
+    std::scoped_lock lock(sessionMutex);
+    if (traceFile != nullptr) {
+        try {
+            drainRings(traceFile.get());
+        }
+        catch (const TraceException& e) {
+            logError("Failed to flush trace records ({})", e.what());
+        }
+        traceFile.reset();
+
+        if (const auto dropped = droppedRecords(); dropped > 0) {
+            logWarning("{} trace records were dropped", dropped);
+        }
+    }
+}
+
+uint64_t util::Tracer::droppedRecords()
+{
+    return totalDropped() - droppedAtStart;
+}
@@ -0,0 +1,164 @@
+#ifndef _UTIL_TRACE_HPP_
+#define _UTIL_TRACE_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace util {
+
+// Events which may be recorded in a trace
+enum class TraceEvent : uint8_t {
+    NONE = 0,
+    INPUT_BUFFER_ADD, // Packet added to the transmitter's input buffer
+    PACKET_TX, // Packet transmitted for the first time
+    PACKET_RETX, // Packet retransmitted from the RT buffer
+    ACK_RX, // ACK received at the transmitter
+    PACKET_RX, // Data packet received at the receiver
+    ACK_TX, // ACK sent by the receiver
+    OUTPUT_BUFFER_PUSH // Packet pushed to the receiver's output buffer
+};
+
+// A fixed-size trace record. Records are written to the trace file as-is, in native byte order.
+struct TraceRecord {
+    // Nanoseconds since the epoch of TraceClock
+    uint64_t timestampNs_;
+    uint16_t sequenceNumber_;
+    uint8_t conversationID_;
+    TraceEvent event_;
+    uint32_t reserved_;
+};
+static_assert(sizeof(TraceRecord) == 16);
+
+// Header at the start of every trace file
+struct TraceFileHeader {
+    std::array<char, 8> magic_;
+    uint32_t version_;
+    uint32_t recordSize_;
+};
+static_assert(sizeof(TraceFileHeader) == 16);
+
+constexpr std::array<char, 8> TRACE_FILE_MAGIC{'A', 'R', 'Q', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t TRACE_FILE_VERSION = 1;
+
+struct TraceException : public std::runtime_error {
+    explicit TraceException(const std::string& what) : std::runtime_error(what){};
+};
+
+/*
+ * A single-producer single-consumer ring of trace records. Each tracing thread owns one ring, which is drained by the
+ * Tracer's flush thread. If the ring is full, the record is dropped rather than blocking the producer.
+ */
+class TraceRing {
+public:
+    static constexpr size_t capacity = 4096;
+
+    bool push(const TraceRecord& record) noexcept
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == capacity) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        records_[head & (capacity - 1)] = record;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Passes every record currently in the ring to consume, returning the number of records drained.
+    template <typename F>
+    size_t drain(F&& consume)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        const auto head = head_.load(std::memory_order_acquire);
+        for (auto i = tail; i != head; ++i) {
+            consume(records_[i & (capacity - 1)]);
+        }
+        tail_.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    // Is the ring currently owned by a live thread?
+    std::atomic<bool> inUse_{true};
+
+private:
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::array<TraceRecord, capacity> records_;
+};
+
+/*
+ * Records binary trace events from any thread into a memory-mapped trace file. Recording a trace event only writes a
+ * fixed-size record into the calling thread's TraceRing; a background thread flushes the rings to the file.
+ */
+struct Tracer {
+    using TraceClock = std::chrono::high_resolution_clock;
+
+    // Start tracing to the file at the given path. Throws a TraceException if the file cannot be created.
+    static void start(const std::string& path);
+
+    // Stop tracing, flushing all outstanding records to the trace file.
+    static void stop();
+
+    static bool isEnabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    // Number of records dropped since tracing started because a ring was full.
+    static uint64_t droppedRecords();
+
+    static void record(const TraceEvent event,
+                       const uint8_t conversationID,
+                       const uint16_t sequenceNumber,
+                       const std::chrono::time_point<TraceClock> time) noexcept
+    {
+        if (!isEnabled()) {
+            return;
+        }
+        if (localRing_ == nullptr && (localRing_ = registerThread()) == nullptr) {
+            return;
+        }
+        localRing_->push(TraceRecord{.timestampNs_ = static_cast<uint64_t>(
+                                         std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch())
+                                             .count()),
+                                     .sequenceNumber_ = sequenceNumber,
+                                     .conversationID_ = conversationID,
+                                     .event_ = event,
+                                     .reserved_ = 0});
+    }
+
+private:
+    // Obtain a ring for the calling thread, reusing one released by an exited thread if possible. Returns nullptr if
+    // no ring could be allocated.
+    static TraceRing* registerThread() noexcept;
+
+    static inline std::atomic<bool> enabled_{false};
+    static inline thread_local TraceRing* localRing_ = nullptr;
+};
+
+// Record a trace event at the given time
+inline void trace(const TraceEvent event,
+                  const uint8_t conversationID,
+                  const uint16_t sequenceNumber,
+                  const std::chrono::time_point<Tracer::TraceClock> time) noexcept
+{
+    Tracer::record(event, conversationID, sequenceNumber, time);
+}
+
+// Record a trace event at the current time
+inline void trace(const TraceEvent event, const uint8_t conversationID, const uint16_t sequenceNumber) noexcept
+{
+    if (Tracer::isEnabled()) {
+        Tracer::record(event, conversationID, sequenceNumber, Tracer::TraceClock::now());
+    }
+}
+
+} // namespace util
+
+#endif
@@ -0,0 +1,146 @@
+#include "util/workload.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <sstream>
+
+util::WorkloadGenerator::WorkloadGenerator(const WorkloadSpec& spec) :
+    spec_{spec}, rng_{spec.seed_}, count_{spec.count_}
+{
+    if (spec_.arrivals_ == ArrivalPattern::TRACE) {
+        loadTrace();
+        if (count_ == 0) {
+            count_ = trace_.size();
+        }
+        return;
+    }
+
+    if (spec_.arrivals_ != ArrivalPattern::SATURATE && !(spec_.rate_ > 0.0)) {
+        throw WorkloadException("workload rate must be positive");
+    }
+    if (spec_.arrivals_ == ArrivalPattern::ON_OFF && spec_.onTime_ <= std::chrono::microseconds::zero()) {
+        throw WorkloadException("workload on period must be positive");
+    }
+    if (spec_.meanSize_ == 0 || spec_.maxSize_ == 0) {
+        throw WorkloadException("workload message sizes must be positive");
+    }
+}
+
+std::optional<util::WorkloadEvent> util::WorkloadGenerator::next()
+{
+    if (generated_ == count_) {
+        return std::nullopt;
+    }
+
+    size_t size;
+    if (spec_.arrivals_ == ArrivalPattern::TRACE) {
+        const auto& entry = trace_[generated_ % trace_.size()];
+        sendTime_ += entry.sendTime_;
+        size = std::clamp<size_t>(entry.size_, 1, spec_.maxSize_);
+    }
+    else {
+        if (generated_ > 0) {
+            sendTime_ += nextGap();
+        }
+        if (spec_.arrivals_ == ArrivalPattern::ON_OFF) {
+            // Move on to the on period in which the message falls, or which follows the off period in which it falls
+            while (sendTime_ >= onStart_ + spec_.onTime_) {
+                onStart_ += spec_.onTime_ + spec_.offTime_;
+            }
+            sendTime_ = std::max(sendTime_, onStart_);
+        }
+        size = nextSize();
+    }
+
+    if (spec_.duration_ > std::chrono::nanoseconds::zero() && sendTime_ >= spec_.duration_) {
+        count_ = generated_;
+        return std::nullopt;
+    }
+
+    ++generated_;
+    return WorkloadEvent{.sendTime_ = sendTime_, .size_ = size};
+}
+
+std::chrono::nanoseconds util::WorkloadGenerator::nextGap()
+{
+    switch (spec_.arrivals_) {
+        case ArrivalPattern::CONSTANT:
+        case ArrivalPattern::ON_OFF:
+            return std::chrono::nanoseconds(std::llround(1e9 / spec_.rate_));
+        case ArrivalPattern::POISSON:
+            return std::chrono::nanoseconds(std::llround(1e9 * std::exponential_distribution<>(spec_.rate_)(rng_)));
+        case ArrivalPattern::SATURATE:
+        case ArrivalPattern::TRACE:
+        default:
+            return std::chrono::nanoseconds::zero();
+    }
+}
+
+size_t util::WorkloadGenerator::nextSize()
+{
+    size_t size;
+    switch (spec_.sizes_) {
+        case SizeDistribution::UNIFORM:
+            size = std::uniform_int_distribution<size_t>(1, 2 * spec_.meanSize_ - 1)(rng_);
+            break;
+        case SizeDistribution::EXPONENTIAL:
+            size = std::ceil(std::exponential_distribution<>(1.0 / spec_.meanSize_)(rng_));
+            break;
+        case SizeDistribution::FIXED:
+        default:
+            size = spec_.meanSize_;
+            break;
+    }
+    return std::clamp<size_t>(size, 1, spec_.maxSize_);
+}
+
+void util::WorkloadGenerator::loadTrace()
+{
+    std::ifstream file{spec_.traceFile_};
+    if (!file) {
+        throw WorkloadException(std::format("failed to open workload trace {}", spec_.traceFile_));
+    }
+
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(file, line); ++lineNumber) {
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        std::istringstream fields{line};
+        double gapMicroseconds;
+        size_t size;
+        if (!(fields >> gapMicroseconds >> size) || gapMicroseconds < 0.0) {
+            throw WorkloadException(std::format("malformed line {} in workload trace {}", lineNumber, spec_.traceFile_));
+        }
+        trace_.push_back(
+            {.sendTime_ = std::chrono::nanoseconds(std::llround(gapMicroseconds * 1000.0)), .size_ = size});
+    }
+
+    if (trace_.empty()) {
+        throw WorkloadException(std::format("workload trace {} holds no messages", spec_.traceFile_));
+    }
+}
+
+void util::fillRandom(std::span<std::byte> buffer, uint64_t& state) noexcept
+{
+    // SplitMix64, which passes BigCrush with a single word of state
+    const auto nextWord = [&state]() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    };
+
+    size_t pos = 0;
+    for (; pos + sizeof(uint64_t) <= buffer.size(); pos += sizeof(uint64_t)) {
+        const auto word = nextWord();
+        std::memcpy(buffer.data() + pos, &word, sizeof(word));
+    }
+    if (pos < buffer.size()) {
+        const auto word = nextWord();
+        std::memcpy(buffer.data() + pos, &word, buffer.size() - pos);
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef _UTIL_WORKLOAD_HPP_
+#define _UTIL_WORKLOAD_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+struct WorkloadException : public std::runtime_error {
+    explicit WorkloadException(const std::string& what) : std::runtime_error(what){};
+};
+
+// How the send times of successive messages are spaced
+enum class ArrivalPattern {
+    // Evenly spaced at the configured rate
+    CONSTANT,
+    // Exponentially distributed gaps, averaging the configured rate
+    POISSON,
+    // Evenly spaced at the configured rate during each on period, with none sent during the off periods between
+    ON_OFF,
+    // All due at once, so that they are sent as fast as the sender accepts them
+    SATURATE,
+    // Gaps and sizes replayed from a trace file
+    TRACE,
+};
+
+// How the sizes of messages are distributed about the mean size
+enum class SizeDistribution {
+    FIXED,
+    // Uniform between 1 and twice the mean
+    UNIFORM,
+    // Exponential, so mostly small messages with occasional large ones
+    EXPONENTIAL,
+};
+
+struct WorkloadSpec {
+    ArrivalPattern arrivals_ = ArrivalPattern::CONSTANT;
+    // Messages per second, during on periods for ON_OFF
+    double rate_ = 0.0;
+    // Durations of the on and off periods for ON_OFF
+    std::chrono::microseconds onTime_{0};
+    std::chrono::microseconds offTime_{0};
+    SizeDistribution sizes_ = SizeDistribution::FIXED;
+    size_t meanSize_ = 0;
+    // Generated sizes are clamped to between 1 and maxSize_
+    size_t maxSize_ = SIZE_MAX;
+    // Number of messages to generate. For TRACE, zero replays the trace once, while any other count loops over it.
+    uint64_t count_ = 0;
+    // If non-zero, no messages are due at or after this offset from the start of the workload. A sender should also
+    // stop once this much time has passed, since it may fall behind the send times.
+    std::chrono::nanoseconds duration_{0};
+    // For TRACE, a text file with one message per line, giving the gap in microseconds since the previous message
+    // followed by the size in bytes. Lines starting with '#' are ignored.
+    std::string traceFile_;
+    uint64_t seed_ = std::random_device{}();
+};
+
+// A message to be sent
+struct WorkloadEvent {
+    // Time at which the message is due, measured from the start of the workload
+    std::chrono::nanoseconds sendTime_;
+    size_t size_;
+};
+
+/*
+ * Generates the send times and sizes of a sequence of messages according to a WorkloadSpec. Send times are absolute
+ * offsets from the start of the workload, so a sender which falls behind catches up rather than drifting, and no
+ * error accumulates from sleeping between sends.
+ */
+class WorkloadGenerator {
+public:
+    // Throws WorkloadException if the spec is invalid or the trace file cannot be read
+    explicit WorkloadGenerator(const WorkloadSpec& spec);
+
+    // Returns the next message, or std::nullopt once the workload is complete
+    std::optional<WorkloadEvent> next();
+
+    // Number of messages generated so far
+    uint64_t generated() const noexcept { return generated_; }
+
+    // Total number of messages the workload generates. With a duration, this is only known once next() has returned
+    // std::nullopt.
+    uint64_t count() const noexcept { return count_; }
+
+private:
+    std::chrono::nanoseconds nextGap();
+    size_t nextSize();
+    void loadTrace();
+
+    WorkloadSpec spec_;
+    std::mt19937_64 rng_;
+    uint64_t count_;
+    uint64_t generated_ = 0;
+    // Send time of the previous message
+    std::chrono::nanoseconds sendTime_{0};
+    // For ON_OFF, the start of the current on period
+    std::chrono::nanoseconds onStart_{0};
+    // For TRACE, the gap and size of each message in the trace
+    std::vector<WorkloadEvent> trace_;
+};
+
+// Waits until the deadline, sleeping for most of the wait and yielding for the final stretch, so that the deadline is
+// met to within a few microseconds rather than the scheduler's wake-up latency
+template <typename Clock, typename Duration>
+void sleepUntil(const std::chrono::time_point<Clock, Duration> deadline)
+{
+    constexpr auto spinTime = std::chrono::microseconds(100);
+    if (deadline - Clock::now() > spinTime) {
+        std::this_thread::sleep_until(deadline - spinTime);
+    }
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+// Fills the buffer with pseudo-random bytes, eight at a time, advancing the generator state. Much faster than drawing
+// each byte from a distribution, and good enough for payloads.
+void fillRandom(std::span<std::byte> buffer, uint64_t& state) noexcept;
+
+} // namespace util
+
+#endif
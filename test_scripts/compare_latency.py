@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+
+import csv
+import os
+import sys
+
+# Percentiles reported by arq::LatencyStats::printSummary
+PERCENTILES = [50.0, 90.0, 99.0, 99.9, 99.99]
+
+def read_histogram(path):
+    """
+    Reads a histogram CSV written by the launcher's --latency-histogram option, returning a list of
+    (upper bound in ns, cumulative percentile) pairs.
+    """
+    with open(path, newline="") as f:
+        return [(int(row["upper"]), float(row["percentile"])) for row in csv.DictReader(f)]
+
+def value_at_percentile(histogram, percentile):
+    for upper, cumulative in histogram:
+        if cumulative >= percentile:
+            return upper
+    return histogram[-1][0] if histogram else 0
+
+def main():
+    paths = sys.argv[1:]
+
+    if len(paths) < 1:
+        print("Usage: compare_latency.py <histogram CSV> [<histogram CSV> ...]")
+        print("e.g. compare the default mode against --low-latency by running the launcher with each and")
+        print("--latency-histogram default.csv and --latency-histogram low_latency.csv respectively")
+        return -1
+
+    # One row per histogram, with delays in ms for consistency with the launcher's summary
+    name_width = max(len(os.path.basename(path)) for path in paths)
+    print("".ljust(name_width) + "".join(f"{'p' + format(p, 'g'):>10}" for p in PERCENTILES))
+    for path in paths:
+        histogram = read_histogram(path)
+        row = "".join(f"{value_at_percentile(histogram, p) / 1e6:>10.3f}" for p in PERCENTILES)
+        print(os.path.basename(path).ljust(name_width) + row)
+
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
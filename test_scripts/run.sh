@@ -114,11 +114,13 @@ while getopts "d:l:n:i:w:f:t:p:s:rh" opt; do
 done
 shift $((OPTIND-1))
 
-# Clean up old logs
+# Clean up old logs and traces
 client_log="${log_dir}/client_${log_file}"
 server_log="${log_dir}/server_${log_file}"
-rm -f ${client_log} || true
-rm -f ${server_log} || true
+client_trace="${log_dir}/client_${log_file%.*}.trace"
+server_trace="${log_dir}/server_${log_file%.*}.trace"
+rm -f ${client_log} ${client_trace} || true
+rm -f ${server_log} ${server_trace} || true
 
 setup_connections
 
@@ -140,15 +142,15 @@ fi
 # Simulate network conditions
 setup_delays
 
-common_opts="--logging ${logging_level} --client-addr ${client_addr} --server-addr ${server_addr} --arq-protocol ${arq_protocol} "
+common_opts="--logging ${logging_level} --async-logging --client-addr ${client_addr} --server-addr ${server_addr} --arq-protocol ${arq_protocol} "
 
 # Start server
 tmux new-session -d -s "arq" -n "server" "stdbuf -o0 ip netns exec ${server_ns} ${wrap_cmd} ${base_dir}/build/src/launcher \
---launch-server ${common_opts} --tx-pkt-num ${pkt_num} --tx-pkt-interval ${pkt_interval} --arq-timeout ${arq_timeout} --window-size ${window_size}| tee ${server_log}"
+--launch-server ${common_opts} --tx-pkt-num ${pkt_num} --tx-pkt-interval ${pkt_interval} --arq-timeout ${arq_timeout} --window-size ${window_size} --trace-file ${server_trace} | tee ${server_log}"
 
 # Start client
 tmux new-window -t "arq" -n "client" "stdbuf -o0 ip netns exec ${client_ns} ${wrap_cmd} ${base_dir}/build/src/launcher \
---launch-client ${common_opts} | tee ${client_log}"
+--launch-client ${common_opts} --trace-file ${client_trace} | tee ${client_log}"
 
 if [[ "${remain_on_exit}" == "true" ]]; then
     tmux set-option -g remain-on-exit on
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+
+import argparse
+import concurrent.futures
+import csv
+import itertools
+import json
+import os
+import re
+import subprocess
+import sys
+
+# Percentiles reported by arq::LatencyStats::printSummary
+PERCENTILES = ["p50", "p90", "p99", "p99.9", "p99.99"]
+
+PARAMETERS = ["protocol", "window_size", "timeout_ms", "delay", "loss", "rate"]
+TRANSFER_FIELDS = ["bytes", "seconds", "goodput_mbit_s", "packets", "retransmissions", "retransmission_overhead", "acks",
+                   "cpu_s_per_gb"]
+DELAY_FIELDS = [f"delay_{stat}_ms" for stat in ["mean", "min", *PERCENTILES, "max"]] + \
+               [f"{part}_{stat}_ms" for part in ["queueing", "network"] for stat in ["p50", "p99", "max"]]
+FIELDS = PARAMETERS + ["status"] + TRANSFER_FIELDS + DELAY_FIELDS
+
+TRANSFER_PATTERN = re.compile(r"^Transferred (\d+) bytes in ([\d.]+) s: goodput ([\d.]+) Mbit/s, (\d+) packets, "
+                              r"(\d+) retransmissions \(overhead ([\d.]+)\), (\d+) ACKs, ([\d.]+) CPU s/GB$", re.M)
+DELAY_PATTERN = re.compile(r"^\s*(End-to-end|Queueing|Network) delay over \d+ packets \(ms\): (.*)$", re.M)
+
+def parse_list(value):
+    return [item for item in value.split(",") if item]
+
+def is_zero(value):
+    """
+    Returns whether a netem delay or loss such as 0ms or 0% is zero.
+    """
+    return float(re.sub(r"[^\d.]", "", value) or 0) == 0
+
+def parse_output(output):
+    """
+    Returns the fields of a row parsed from the launcher's summary of a run, in which the server and client were
+    launched together.
+    """
+    row = {}
+    if match := TRANSFER_PATTERN.search(output):
+        row.update(zip(TRANSFER_FIELDS, match.groups()))
+
+    for name, stats in DELAY_PATTERN.findall(output):
+        values = dict(stat.split(" ") for stat in stats.split(", "))
+        if name == "End-to-end":
+            row.update({f"delay_{stat}_ms": values[stat] for stat in ["mean", "min", *PERCENTILES, "max"]})
+        else:
+            row.update({f"{name.lower()}_{stat}_ms": values[stat] for stat in ["p50", "p99", "max"]})
+    return row
+
+def launcher_command(args, point, index):
+    protocol, window_size, timeout_ms, _, _, rate = point
+    command = [args.launcher, "--launch-server", "--launch-client", "--logging", "0",
+               "--arq-protocol", protocol, "--window-size", window_size, "--arq-timeout", timeout_ms]
+
+    # A rate of "max" saturates the link, transferring a fixed amount of data rather than a number of packets
+    if rate == "max":
+        command += ["--throughput", "--tx-megabytes", str(args.megabytes)]
+    else:
+        command += ["--tx-rate", rate, "--tx-pkt-num", str(args.packets), "--open-loop"]
+
+    # Runs sharing the host's loopback interface need ports of their own
+    if not args.netns:
+        server_port = args.base_port + 2 * index
+        command += ["--server-port", str(server_port), "--client-port", str(server_port + 1)]
+    return command
+
+def run_point(args, point, index):
+    """
+    Runs the launcher for one point of the grid, in a network namespace of its own if netns is set so that netem can
+    delay and drop packets on its loopback interface, and returns the resulting row.
+    """
+    row = dict(zip(PARAMETERS, point))
+    _, _, _, delay, loss, _ = point
+    namespace = f"arqsweep{os.getpid()}_{index}"
+    command = launcher_command(args, point, index)
+
+    try:
+        if args.netns:
+            subprocess.run(["ip", "netns", "add", namespace], check=True)
+            subprocess.run(["ip", "-n", namespace, "link", "set", "lo", "up"], check=True)
+            if not is_zero(delay) or not is_zero(loss):
+                subprocess.run(["ip", "netns", "exec", namespace, "tc", "qdisc", "add", "dev", "lo", "root", "netem",
+                                "delay", delay, "loss", "random", loss], check=True)
+            command = ["ip", "netns", "exec", namespace] + command
+
+        result = subprocess.run(command, capture_output=True, text=True, timeout=args.run_timeout)
+        row.update(parse_output(result.stdout))
+        row["status"] = "ok" if result.returncode == 0 and "bytes" in row else "failed"
+    except subprocess.TimeoutExpired:
+        row["status"] = "timeout"
+    except subprocess.CalledProcessError as e:
+        row["status"] = f"setup failed ({' '.join(e.cmd[:4])})"
+    finally:
+        if args.netns:
+            subprocess.run(["ip", "netns", "delete", namespace], stderr=subprocess.DEVNULL)
+    return row
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Runs the launcher over every point of a parameter grid in parallel, writing one row per run. "
+                    "Unless --no-netns is given, each run has a network namespace of its own (which requires root), "
+                    "with netem applying the delay and loss to each direction.")
+    parser.add_argument("--protocols", type=parse_list, default=["stop-and-wait", "go-back-n", "selective-repeat"])
+    parser.add_argument("--windows", type=parse_list, default=["100"], help="window sizes")
+    parser.add_argument("--timeouts", type=parse_list, default=["50"], help="ARQ timeouts in ms")
+    parser.add_argument("--delays", type=parse_list, default=["0ms"], help="netem delays, e.g. 1ms,10ms")
+    parser.add_argument("--losses", type=parse_list, default=["0%"], help="netem loss rates, e.g. 0%%,1%%")
+    parser.add_argument("--rates", type=parse_list, default=["1000"],
+                        help="packets per second, or max for a throughput run")
+    parser.add_argument("--packets", type=int, default=1000, help="packets sent by each run at a fixed rate")
+    parser.add_argument("--megabytes", type=int, default=10, help="MB transferred by each throughput run")
+    # The transmitter and receiver threads of each run busy-poll, so runs are given two CPUs each by default
+    parser.add_argument("--jobs", type=int, default=max(1, os.cpu_count() // 2), help="runs in parallel")
+    parser.add_argument("--run-timeout", type=int, default=600, help="seconds after which a run is abandoned")
+    parser.add_argument("--launcher", default=os.path.join(os.path.dirname(__file__), "../build/src/launcher"))
+    parser.add_argument("--format", choices=["csv", "json"], default="csv", help="CSV, or one JSON object per line")
+    parser.add_argument("--output", help="file to which rows are written (default stdout)")
+    parser.add_argument("--no-netns", dest="netns", action="store_false",
+                        help="run on the host's loopback interface, without delay or loss")
+    parser.add_argument("--base-port", type=int, default=40000, help="first port used with --no-netns")
+    args = parser.parse_args()
+
+    if args.netns and os.geteuid() != 0:
+        print("Network namespaces require root - run as root or pass --no-netns")
+        return -1
+    if not args.netns and not all(is_zero(value) for value in args.delays + args.losses):
+        print("Delay and loss require network namespaces")
+        return -1
+
+    grid = list(itertools.product(args.protocols, args.windows, args.timeouts, args.delays, args.losses, args.rates))
+    print(f"Running {len(grid)} points on {args.jobs} jobs", file=sys.stderr)
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.DictWriter(out, fieldnames=FIELDS) if args.format == "csv" else None
+    if writer:
+        writer.writeheader()
+
+    # Rows are written as runs complete, so a long sweep can be watched and survives being interrupted
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        futures = [executor.submit(run_point, args, point, index) for index, point in enumerate(grid)]
+        for done, future in enumerate(concurrent.futures.as_completed(futures), start=1):
+            row = future.result()
+            if writer:
+                writer.writerow(row)
+            else:
+                out.write(json.dumps(row) + "\n")
+            out.flush()
+            print(f"[{done}/{len(grid)}] {', '.join(row[p] for p in PARAMETERS)}: {row['status']}", file=sys.stderr)
+
+    if out is not sys.stdout:
+        out.close()
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+
+import struct
+import sys
+
+# Layout of util::TraceFileHeader and util::TraceRecord (see src/util/trace.hpp)
+TRACE_FILE_MAGIC = b"ARQTRACE"
+TRACE_FILE_VERSION = 1
+HEADER_FORMAT = "=8sII"
+RECORD_FORMAT = "=QHBBI"
+
+# Values of util::TraceEvent
+EVENT_NAMES = {
+    1: "INPUT_BUFFER_ADD",
+    2: "PACKET_TX",
+    3: "PACKET_RETX",
+    4: "ACK_RX",
+    5: "PACKET_RX",
+    6: "ACK_TX",
+    7: "OUTPUT_BUFFER_PUSH",
+}
+INPUT_BUFFER_ADD = 1
+OUTPUT_BUFFER_PUSH = 7
+
+def read_trace(path):
+    """
+    Reads a binary trace file written by util::Tracer.
+
+    :param path: a path to the trace file
+    :return: a list of records (timestamp_ns, sequence_number, conversation_id, event), sorted by timestamp
+    """
+    with open(path, "rb") as trace_file:
+        data = trace_file.read()
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    magic, version, record_size = struct.unpack_from(HEADER_FORMAT, data)
+    if magic != TRACE_FILE_MAGIC or version != TRACE_FILE_VERSION:
+        raise ValueError(f"{path} is not a version {TRACE_FILE_VERSION} trace file")
+    if record_size != struct.calcsize(RECORD_FORMAT):
+        raise ValueError(f"{path} has unexpected record size {record_size}")
+
+    records = [(ts, sn, conv_id, event)
+               for ts, sn, conv_id, event, _ in struct.iter_unpack(RECORD_FORMAT, data[header_size:])]
+    return sorted(records)
+
+def event_time_series(records, event):
+    """
+    Extracts the time series for a single event type. Sequence numbers wrap at 2^16, so they are unwrapped here
+    assuming the events for a given conversation occur in sequence number order.
+
+    :param records: records returned by read_trace
+    :param event: the event to extract
+    :return: a list of pairs [sequence_number, timestamp_ns]
+    """
+    time_series = []
+    last_sn = {}
+    offset = {}
+    for ts, sn, conv_id, ev in records:
+        if ev != event:
+            continue
+        if conv_id in last_sn and sn < last_sn[conv_id] and last_sn[conv_id] - sn > 0x8000:
+            offset[conv_id] = offset.get(conv_id, 0) + 0x10000
+        last_sn[conv_id] = sn
+        time_series.append((sn + offset.get(conv_id, 0), ts))
+    return time_series
+
+def delay_series(server_trace, client_trace):
+    """
+    Computes the per-SN delay between a packet being added to the IB and being pushed to the OB.
+
+    :param server_trace: a path to the transmitter's trace file
+    :param client_trace: a path to the receiver's trace file (may be the same file for in-process runs)
+    :return: a list of pairs [sequence_number, delay_ms]
+    """
+    server_records = read_trace(server_trace)
+    client_records = server_records if client_trace == server_trace else read_trace(client_trace)
+
+    ib_times = dict(event_time_series(server_records, INPUT_BUFFER_ADD))
+    ob_times = event_time_series(client_records, OUTPUT_BUFFER_PUSH)
+
+    series = []
+    for sn, ob_time in ob_times:
+        if sn not in ib_times:
+            print(f"SN {sn} pushed to OB but never added to IB", file=sys.stderr)
+            continue
+        series.append((sn, (ob_time - ib_times[sn]) / 1e6))
+    return series
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print(f"Usage: {sys.argv[0]} <server trace> [<client trace>]")
+        return 1
+
+    server_trace = sys.argv[1]
+    client_trace = sys.argv[2] if len(sys.argv) == 3 else server_trace
+
+    print("sequence_number,delay_ms")
+    for sn, delay in delay_series(server_trace, client_trace):
+        print(f"{sn},{delay:.6f}")
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())